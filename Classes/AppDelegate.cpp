@@ -43,9 +43,8 @@ static cocos2d::Size mediumResolutionSize = cocos2d::Size(1024, 768);
 static cocos2d::Size largeResolutionSize = cocos2d::Size(2048, 1536);
 
 
-void AppDelegate::eventCustomCallback(EventCustom* event)
+void AppDelegate::eventCustomCallback(const gi_test::MyEventType* type)
 {
-    gi_test::MyEventType* type = static_cast<gi_test::MyEventType*>(event->getUserData());
     if(type)
     {
         switch (*type)
@@ -130,6 +129,15 @@ bool AppDelegate::applicationDidFinishLaunching() {
     auto glview = director->getOpenGLView();
     if(!glview) {
         //glview = GLViewImpl::createWithFullScreen("gi_test");
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        // CC_RENDER_BACKEND=null runs headless, CC_RENDER_FRAMES limits the number of frames
+        if (backend::DeviceNull::isRequested())
+        {
+            const char* frames = getenv("CC_RENDER_FRAMES");
+            glview = GLViewNull::createWithRect("gi_test", cocos2d::Rect(0, 0, designResolutionSize.width, designResolutionSize.height), frames ? atoi(frames) : 0);
+        }
+        else
+#endif
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
         glview = GLViewImpl::createWithRect("gi_test", cocos2d::Rect(0, 0, designResolutionSize.width, designResolutionSize.height));
 #else
@@ -170,9 +178,9 @@ bool AppDelegate::applicationDidFinishLaunching() {
     this->menu_scene = MainMenuScene::createScene();
     this->game_scene = GameScene::createScene();
 
-    EventListenerCustom* gi_listner = EventListenerCustom::create("gi_event", CC_CALLBACK_1(AppDelegate::eventCustomCallback, this));
-
-    director->getEventDispatcher()->addEventListenerWithFixedPriority(gi_listner, 1);
+    EventChannel::getInstance()->addListener<gi_test::MyEventType>(gi_test::gi_event_type(), [this](const gi_test::MyEventType& type) {
+        eventCustomCallback(&type);
+    });
 
     // run
     director->runWithScene(this->menu_scene);
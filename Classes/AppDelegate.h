@@ -29,6 +29,7 @@
 
 #include "MainMenuScene.h"
 #include "GameScene.h"
+#include "Constants.h"
 
 /**
 @brief    The cocos2d Application.
@@ -42,7 +43,7 @@ private:
     cocos2d::Scene* game_scene = nullptr;
 
 public:
-    void eventCustomCallback(cocos2d::EventCustom* event);
+    void eventCustomCallback(const gi_test::MyEventType* type);
 
     AppDelegate();
     virtual ~AppDelegate();
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "cocos2d.h"
 
 namespace gi_test
@@ -10,5 +12,12 @@ namespace gi_test
         END_GAME
     };
 
+    // Id of the "gi_event" channel, the payload is a MyEventType
+    inline cocos2d::EventChannel::TypeID gi_event_type()
+    {
+        static const cocos2d::EventChannel::TypeID type = cocos2d::EventChannel::registerEventType("gi_event");
+        return type;
+    }
+
     //const Color4B text_block_bg_color(250,240,230,200);
 }
\ No newline at end of file
@@ -561,10 +561,7 @@ void GameScene::nextSequence()
     ++scenario_iter;
     if(!run())
     {
-        EventCustom event("gi_event");
-        gi_test::MyEventType type = gi_test::MyEventType::END_GAME;
-        event.setUserData(&type);
-        _eventDispatcher->dispatchEvent(&event);
+        EventChannel::getInstance()->dispatch(gi_test::gi_event_type(), gi_test::MyEventType::END_GAME);
     }
     else
     {
@@ -643,10 +640,7 @@ bool GameScene::init()
         listener->onKeyReleased = [&](EventKeyboard::KeyCode keyCode, Event* event){
             if(keyCode == EventKeyboard::KeyCode::KEY_ESCAPE)
             {
-                EventCustom event("gi_event");
-                gi_test::MyEventType type = gi_test::MyEventType::NEED_MENU;
-                event.setUserData(&type);
-                _eventDispatcher->dispatchEvent(&event);
+                EventChannel::getInstance()->dispatch(gi_test::gi_event_type(), gi_test::MyEventType::NEED_MENU);
             }
         };
         _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
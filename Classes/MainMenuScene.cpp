@@ -61,10 +61,7 @@ bool MainMenuScene::init_menu()
 
     this->continue_item = get_menu_label_item("CONTINUE", [&](Ref* sender){
         //start game from the last save
-        EventCustom event("gi_event");
-        gi_test::MyEventType type = gi_test::MyEventType::CONTINUE;
-        event.setUserData(&type);
-        _eventDispatcher->dispatchEvent(&event);
+        EventChannel::getInstance()->dispatch(gi_test::gi_event_type(), gi_test::MyEventType::CONTINUE);
     });
     if(continue_item)
     {
@@ -79,10 +76,7 @@ bool MainMenuScene::init_menu()
 
     auto new_game_item = get_menu_label_item("NEW GAME", [&](Ref* sender) {
         // start a new game
-        EventCustom event("gi_event");
-        gi_test::MyEventType type = gi_test::MyEventType::NEW_GAME;
-        event.setUserData(&type);
-        _eventDispatcher->dispatchEvent(&event);
+        EventChannel::getInstance()->dispatch(gi_test::gi_event_type(), gi_test::MyEventType::NEW_GAME);
     });
     if(new_game_item)
     {
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include "2d/CCAction.h"
 #include "2d/CCActionInterval.h"
+#include "2d/CCActionPool.h"
 #include "2d/CCNode.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
@@ -54,6 +55,26 @@ Action::~Action()
     CCLOGINFO("deallocing Action: %p - tag: %i", this, _tag);
 }
 
+#if CC_ENABLE_ACTION_POOL
+void* Action::operator new(std::size_t size)
+{
+    void* ptr = ActionPool::allocate(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* Action::operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ActionPool::allocate(size);
+}
+
+void Action::operator delete(void* ptr, std::size_t size) noexcept
+{
+    ActionPool::deallocate(ptr, size);
+}
+#endif // CC_ENABLE_ACTION_POOL
+
 std::string Action::description() const
 {
     return StringUtils::format("<Action | Tag = %d", _tag);
@@ -29,6 +29,8 @@ THE SOFTWARE.
 #ifndef __ACTIONS_CCACTION_H__
 #define __ACTIONS_CCACTION_H__
 
+#include <new>
+
 #include "base/CCRef.h"
 #include "math/CCGeometry.h"
 #include "base/CCScriptSupport.h"
@@ -161,6 +163,17 @@ public:
      */
     void setFlags(unsigned int flags) { _flags = flags; }
 
+#if CC_ENABLE_ACTION_POOL
+    /** Actions and their subclasses are allocated from ActionPool.
+     * The sized delete receives the dynamic size of the action, so subclasses share the pool.
+     * @js NA
+     * @lua NA
+     */
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, const std::nothrow_t&) noexcept;
+    static void operator delete(void* ptr, std::size_t size) noexcept;
+#endif // CC_ENABLE_ACTION_POOL
+
 CC_CONSTRUCTOR_ACCESS:
     Action();
     virtual ~Action();
@@ -472,6 +472,8 @@ protected:
     Vec3 _startAngle;
     Vec3 _diffAngle;
 
+    friend class TweenSystem;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
 };
@@ -538,6 +540,8 @@ protected:
     Vec3 _deltaAngle;
     Vec3 _startAngle;
 
+    friend class TweenSystem;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
 };
@@ -594,6 +598,8 @@ protected:
     Vec3 _startPosition;
     Vec3 _previousPosition;
 
+    friend class TweenSystem;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
 };
@@ -1089,6 +1095,8 @@ protected:
     float _deltaY;
     float _deltaZ;
 
+    friend class TweenSystem;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
 };
@@ -1228,6 +1236,7 @@ protected:
     uint8_t _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class TweenSystem;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCTweenSystem.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -55,6 +56,7 @@ ActionManager::ActionManager()
   _currentTarget(nullptr),
   _currentTargetSalvaged(false)
 {
+    _tweenSystem = new (std::nothrow) TweenSystem();
 
 }
 
@@ -63,6 +65,7 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_tweenSystem);
 }
 
 // private
@@ -130,6 +133,7 @@ void ActionManager::pauseTarget(Node *target)
     {
         element->paused = true;
     }
+    _tweenSystem->pauseTarget(target);
 }
 
 void ActionManager::resumeTarget(Node *target)
@@ -140,6 +144,7 @@ void ActionManager::resumeTarget(Node *target)
     {
         element->paused = false;
     }
+    _tweenSystem->resumeTarget(target);
 }
 
 Vector<Node*> ActionManager::pauseAllRunningActions()
@@ -154,6 +159,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
             idsWithActions.pushBack(element->target);
         }
     }    
+    _tweenSystem->pauseAllTargets(idsWithActions);
     
     return idsWithActions;
 }
@@ -196,6 +202,19 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      action->startWithTarget(target);
 }
 
+void ActionManager::addTween(Action *action, Node *target, bool paused)
+{
+    CCASSERT(action != nullptr, "action can't be nullptr!");
+    CCASSERT(target != nullptr, "target can't be nullptr!");
+    if(action == nullptr || target == nullptr)
+        return;
+
+    if (! _tweenSystem->addTween(action, target, paused))
+    {
+        addAction(action, target, paused);
+    }
+}
+
 // remove
 
 void ActionManager::removeAllActions()
@@ -206,6 +225,7 @@ void ActionManager::removeAllActions()
         element = (tHashElement*)element->hh.next;
         removeAllActionsFromTarget(target);
     }
+    _tweenSystem->removeAllTweens();
 }
 
 void ActionManager::removeAllActionsFromTarget(Node *target)
@@ -236,6 +256,7 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             deleteHashElement(element);
         }
     }
+    _tweenSystem->removeAllTweensFromTarget(target);
 }
 
 void ActionManager::removeAction(Action *action)
@@ -281,10 +302,11 @@ void ActionManager::removeActionByTag(int tag, Node *target)
             if (action->getTag() == (int)tag && action->getOriginalTarget() == target)
             {
                 removeActionAtIndex(i, element);
-                break;
+                return;
             }
         }
     }
+    _tweenSystem->removeTweenByTag(tag, target);
 }
 
 void ActionManager::removeAllActionsByTag(int tag, Node *target)
@@ -317,6 +339,7 @@ void ActionManager::removeAllActionsByTag(int tag, Node *target)
             }
         }
     }
+    _tweenSystem->removeAllTweensByTag(tag, target);
 }
 
 void ActionManager::removeActionsByFlags(unsigned int flags, Node *target)
@@ -391,12 +414,13 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
 {
     tHashElement *element = nullptr;
     HASH_FIND_PTR(_targets, &target, element);
+    ssize_t count = _tweenSystem->getNumberOfTweensInTarget(target);
     if (element)
     {
-        return element->actions ? element->actions->num : 0;
+        count += element->actions ? element->actions->num : 0;
     }
 
-    return 0;
+    return count;
 }
 
 // FIXME: Passing "const O *" instead of "const O&" because HASH_FIND_IT requires the address of a pointer
@@ -409,10 +433,10 @@ size_t ActionManager::getNumberOfRunningActionsInTargetByTag(const Node *target,
     tHashElement *element = nullptr;
     HASH_FIND_PTR(_targets, &target, element);
 
+    size_t count = _tweenSystem->getNumberOfTweensInTargetByTag(target, tag);
     if(!element || !element->actions)
-        return 0;
+        return count;
 
-    int count = 0;
     auto limit = element->actions->num;
     for(int i = 0; i < limit; ++i)
     {
@@ -426,7 +450,7 @@ size_t ActionManager::getNumberOfRunningActionsInTargetByTag(const Node *target,
 
 ssize_t ActionManager::getNumberOfRunningActions() const
 {
-    ssize_t count = 0;
+    ssize_t count = _tweenSystem->getNumberOfTweens();
     struct _hashElement* element = nullptr;
     struct _hashElement* tmp = nullptr;
     HASH_ITER(hh, _targets, element, tmp)
@@ -499,6 +523,8 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    _tweenSystem->update(dt);
 }
 
 NS_CC_END
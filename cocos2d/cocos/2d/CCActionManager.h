@@ -37,6 +37,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
+class TweenSystem;
 
 struct _hashElement;
 
@@ -83,6 +84,18 @@ public:
      */
     virtual void addAction(Action *action, Node *target, bool paused);
 
+    /** Adds an action with a target, running it as a packed tween when possible.
+     Supported actions (see TweenSystem) are converted into the tween arrays and the action object isn't kept,
+     so it can't be retrieved with getActionByTag() and removeAction() has no effect on it. Tags, pausing and
+     the other removal methods work as for regular actions. Any other action is added with addAction().
+     *
+     * @param action    A certain action.
+     * @param target    The target which need to be added an action.
+     * @param paused    Is the target paused or not.
+     * @since v4.0
+     */
+    virtual void addTween(Action *action, Node *target, bool paused);
+
     /** Removes all actions from all the targets.
      */
     virtual void removeAllActions();
@@ -204,6 +217,7 @@ protected:
 
 protected:
     struct _hashElement    *_targets;
+    TweenSystem     *_tweenSystem;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
 };
@@ -0,0 +1,383 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCActionPool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "base/ccMacros.h"
+#include "base/CCThreadLocal.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const size_t SIZE_CLASS_BYTES = 16;
+    const size_t SIZE_CLASS_COUNT = 48; // objects up to 768 bytes are pooled
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // Written by the thread owning the free lists only, so a relaxed load and store is enough and no
+    // locked instruction is needed. getStatistics() reads them from any thread.
+    typedef std::atomic<size_t> Counter;
+
+    inline void addTo(Counter& counter, size_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline size_t read(const Counter& counter)
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    struct SizeClass
+    {
+        FreeBlock* head = nullptr;
+        Counter freeBlocks{0};
+        Counter hits{0};
+        Counter misses{0};
+        // A block may be freed by another thread than the one that allocated it, so the count of a
+        // single thread can wrap around. The sum over all threads is right.
+        Counter live{0};
+    };
+
+    /** The free lists of a thread, only that thread pushes and pops blocks. */
+    struct ThreadCache
+    {
+        SizeClass sizeClasses[SIZE_CLASS_COUNT];
+        Counter recycled{0};
+    };
+
+    struct SizeClassTotals
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t live = 0;
+        size_t freeBlocks = 0;
+    };
+
+    void retireThreadCache(ThreadCache* cache);
+
+    struct PoolState
+    {
+        // The cache of each thread. Once the cache of an exiting thread is gone it is set to exited, the
+        // blocks the thread frees from then on go to the system allocator.
+        ThreadLocalPtr<ThreadCache, &retireThreadCache> threadCache;
+
+        // Guards the cache list and the counters of the threads that exited. The allocation paths of a
+        // running thread never take it.
+        std::mutex mutex;
+        std::vector<ThreadCache*> caches;
+        ThreadCache exited;
+        std::atomic<size_t> maxFreeBlocks{1024};
+    };
+
+    // Intentionally leaked: actions may still be released by static destructors at exit.
+    PoolState& getState()
+    {
+        static PoolState* state = new PoolState();
+        return *state;
+    }
+
+    inline size_t getSizeClass(size_t size)
+    {
+        return (size + SIZE_CLASS_BYTES - 1) / SIZE_CLASS_BYTES - 1;
+    }
+
+    void releaseBlocks(SizeClass& sizeClass, size_t keep)
+    {
+        size_t freeBlocks = read(sizeClass.freeBlocks);
+        while (freeBlocks > keep)
+        {
+            FreeBlock* block = sizeClass.head;
+            sizeClass.head = block->next;
+            --freeBlocks;
+            free(block);
+        }
+        sizeClass.freeBlocks.store(freeBlocks, std::memory_order_relaxed);
+    }
+
+    ThreadCache* getThreadCache(PoolState& state)
+    {
+        auto cache = state.threadCache.get();
+        if (cache == nullptr)
+        {
+            cache = new (std::nothrow) ThreadCache();
+            if (cache == nullptr)
+                return nullptr;
+
+            state.threadCache.set(cache);
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.caches.push_back(cache);
+        }
+        return cache != &state.exited ? cache : nullptr;
+    }
+
+    void retireThreadCache(ThreadCache* cache)
+    {
+        // the marker is cleaned up again each round, it stays set until the thread is gone
+        auto& state = getState();
+        state.threadCache.set(&state.exited);
+        if (cache == &state.exited)
+            return;
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+        {
+            auto& sizeClass = cache->sizeClasses[i];
+            auto& exited = state.exited.sizeClasses[i];
+            releaseBlocks(sizeClass, 0);
+            addTo(exited.hits, read(sizeClass.hits));
+            addTo(exited.misses, read(sizeClass.misses));
+            addTo(exited.live, read(sizeClass.live));
+        }
+        addTo(state.exited.recycled, read(cache->recycled));
+
+        auto it = std::find(state.caches.begin(), state.caches.end(), cache);
+        if (it != state.caches.end())
+            state.caches.erase(it);
+        delete cache;
+    }
+
+    /** Sums the counters of every thread, the caller holds the state mutex. */
+    size_t collectTotals(PoolState& state, SizeClassTotals (&totals)[SIZE_CLASS_COUNT])
+    {
+        size_t recycled = read(state.exited.recycled);
+        for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+        {
+            const auto& exited = state.exited.sizeClasses[i];
+            totals[i].hits = read(exited.hits);
+            totals[i].misses = read(exited.misses);
+            totals[i].live = read(exited.live);
+        }
+
+        for (auto cache : state.caches)
+        {
+            recycled += read(cache->recycled);
+            for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+            {
+                const auto& sizeClass = cache->sizeClasses[i];
+                totals[i].hits += read(sizeClass.hits);
+                totals[i].misses += read(sizeClass.misses);
+                totals[i].live += read(sizeClass.live);
+                totals[i].freeBlocks += read(sizeClass.freeBlocks);
+            }
+        }
+        return recycled;
+    }
+}
+
+void* ActionPool::allocate(size_t size)
+{
+    size_t index = getSizeClass(size);
+    if (size == 0 || index >= SIZE_CLASS_COUNT)
+        return malloc(size);
+
+    // Always allocate the full size class so the block can serve any object of that class.
+    size_t blockSize = (index + 1) * SIZE_CLASS_BYTES;
+
+    auto& state = getState();
+    auto cache = getThreadCache(state);
+    if (cache == nullptr)
+    {
+        // the thread is exiting or out of memory
+        void* ptr = malloc(blockSize);
+        if (ptr)
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            addTo(state.exited.sizeClasses[index].misses, 1);
+            addTo(state.exited.sizeClasses[index].live, 1);
+        }
+        return ptr;
+    }
+
+    auto& sizeClass = cache->sizeClasses[index];
+    if (sizeClass.head)
+    {
+        FreeBlock* block = sizeClass.head;
+        sizeClass.head = block->next;
+        addTo(sizeClass.freeBlocks, (size_t)-1);
+        addTo(sizeClass.hits, 1);
+        addTo(sizeClass.live, 1);
+        return block;
+    }
+
+    void* ptr = malloc(blockSize);
+    if (ptr)
+    {
+        addTo(sizeClass.misses, 1);
+        addTo(sizeClass.live, 1);
+    }
+    return ptr;
+}
+
+void ActionPool::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+
+    size_t index = getSizeClass(size);
+    if (size == 0 || index >= SIZE_CLASS_COUNT)
+    {
+        free(ptr);
+        return;
+    }
+
+    auto& state = getState();
+    auto cache = getThreadCache(state);
+    if (cache == nullptr)
+    {
+        free(ptr);
+        std::lock_guard<std::mutex> lock(state.mutex);
+        addTo(state.exited.sizeClasses[index].live, (size_t)-1);
+        return;
+    }
+
+    auto& sizeClass = cache->sizeClasses[index];
+    addTo(sizeClass.live, (size_t)-1);
+    if (read(sizeClass.freeBlocks) >= state.maxFreeBlocks.load(std::memory_order_relaxed))
+    {
+        free(ptr);
+        return;
+    }
+
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = sizeClass.head;
+    sizeClass.head = block;
+    addTo(sizeClass.freeBlocks, 1);
+    addTo(cache->recycled, 1);
+}
+
+void ActionPool::purge()
+{
+    auto& state = getState();
+    auto cache = state.threadCache.get();
+    if (cache == nullptr || cache == &state.exited)
+        return;
+
+    for (auto& sizeClass : cache->sizeClasses)
+    {
+        releaseBlocks(sizeClass, 0);
+    }
+}
+
+void ActionPool::setMaxFreeBlocksPerSize(size_t count)
+{
+    auto& state = getState();
+    state.maxFreeBlocks.store(count, std::memory_order_relaxed);
+
+    auto cache = state.threadCache.get();
+    if (cache == nullptr || cache == &state.exited)
+        return;
+
+    for (auto& sizeClass : cache->sizeClasses)
+    {
+        releaseBlocks(sizeClass, count);
+    }
+}
+
+ActionPool::Statistics ActionPool::getStatistics()
+{
+    auto& state = getState();
+    SizeClassTotals totals[SIZE_CLASS_COUNT];
+    Statistics stats;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        stats.recycled = collectTotals(state, totals);
+    }
+
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+    {
+        stats.hits += totals[i].hits;
+        stats.misses += totals[i].misses;
+        stats.freeBlocks += totals[i].freeBlocks;
+        stats.freeBytes += totals[i].freeBlocks * (i + 1) * SIZE_CLASS_BYTES;
+        stats.liveObjects += totals[i].live;
+    }
+    return stats;
+}
+
+void ActionPool::resetStatistics()
+{
+    auto& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto resetCache = [](ThreadCache& cache) {
+        cache.recycled.store(0, std::memory_order_relaxed);
+        for (auto& sizeClass : cache.sizeClasses)
+        {
+            sizeClass.hits.store(0, std::memory_order_relaxed);
+            sizeClass.misses.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    resetCache(state.exited);
+    for (auto cache : state.caches)
+    {
+        resetCache(*cache);
+    }
+}
+
+std::string ActionPool::getStatisticsInfo()
+{
+    auto stats = getStatistics();
+    size_t requests = stats.hits + stats.misses;
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+             "ActionPool: hits=%zu misses=%zu hit rate=%.1f%% recycled=%zu live=%zu free=%zu blocks (%.2f KB)\n",
+             stats.hits, stats.misses, requests ? 100.0 * stats.hits / requests : 0.0,
+             stats.recycled, stats.liveObjects, stats.freeBlocks, stats.freeBytes / 1024.0);
+    std::string info = buffer;
+
+    auto& state = getState();
+    SizeClassTotals totals[SIZE_CLASS_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        collectTotals(state, totals);
+    }
+
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+    {
+        const auto& sizeClass = totals[i];
+        if (sizeClass.hits == 0 && sizeClass.misses == 0 && sizeClass.live == 0 && sizeClass.freeBlocks == 0)
+            continue;
+
+        snprintf(buffer, sizeof(buffer), "\"%zu bytes\" hits=%zu misses=%zu live=%zu free=%zu\n",
+                 (i + 1) * SIZE_CLASS_BYTES, sizeClass.hits, sizeClass.misses, sizeClass.live, sizeClass.freeBlocks);
+        info += buffer;
+    }
+    return info;
+}
+
+NS_CC_END
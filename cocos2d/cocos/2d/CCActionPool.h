@@ -0,0 +1,102 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __ACTION_CCACTION_POOL_H__
+#define __ACTION_CCACTION_POOL_H__
+
+#include <stddef.h>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @class ActionPool
+ @brief Free lists that recycle the memory of Action objects.
+
+ When CC_ENABLE_ACTION_POOL is set, Action overrides its allocation functions to go through this pool.
+ Memory is kept in one free list per 16 byte size class, so every action class gets its own list in
+ practice. Each thread has its own free lists, allocating and freeing never takes a lock; actions are
+ created and released on the cocos thread, whose lists are the only ones that matter. A recycled block
+ is fully re-constructed by the action's constructor and init method, so no state leaks from the
+ previous action. Objects bigger than the largest size class use the system allocator directly.
+ @since v4.0
+ */
+class CC_DLL ActionPool
+{
+public:
+    struct Statistics
+    {
+        /** Allocations served from a free list. */
+        size_t hits = 0;
+        /** Allocations that had to go to the system allocator. */
+        size_t misses = 0;
+        /** Blocks handed back to the pool. */
+        size_t recycled = 0;
+        /** Blocks currently held in the free lists. */
+        size_t freeBlocks = 0;
+        /** Bytes currently held in the free lists. */
+        size_t freeBytes = 0;
+        /** Pooled objects currently alive. */
+        size_t liveObjects = 0;
+    };
+
+    /** Allocates size bytes for an action, reusing a free block when one is available.
+     * @return nullptr if the system allocator fails.
+     */
+    static void* allocate(size_t size);
+
+    /** Gives back a block returned by allocate(). size must be the size passed to allocate(). */
+    static void deallocate(void* ptr, size_t size);
+
+    /** Releases the free blocks of the calling thread to the system allocator. Live actions aren't affected. */
+    static void purge();
+
+    /** Sets how many free blocks are kept per size class, 1024 by default.
+     * The extra blocks of the calling thread are released, the lists of other threads stop growing past the limit.
+     */
+    static void setMaxFreeBlocksPerSize(size_t count);
+
+    /** Returns the counters of the pool. */
+    static Statistics getStatistics();
+
+    /** Resets the hit, miss and recycle counters. */
+    static void resetStatistics();
+
+    /** Returns the counters of the pool and of each size class in use, for display. */
+    static std::string getStatisticsInfo();
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __ACTION_CCACTION_POOL_H__
@@ -36,6 +36,8 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCScheduler.h"
+#include "base/CCConfiguration.h"
 
 NS_CC_BEGIN
 
@@ -43,9 +45,43 @@ const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
+
+static int s_maxPageSize = 2048;
+static int s_maxPageCount = 0;
+static unsigned int s_nextAtlasID = 0;
+
+// each glyph is allocated with a margin of one empty texel on every side, so filtering never samples its neighbours
+static const int GLYPH_MARGIN = 1;
+
+static int getPageSizeLimit()
+{
+    return std::max(1, std::min(s_maxPageSize, Configuration::getInstance()->getMaxTextureSize()));
+}
+
+void FontAtlas::setMaxPageSize(int size)
+{
+    s_maxPageSize = size;
+}
+
+int FontAtlas::getMaxPageSize()
+{
+    return s_maxPageSize;
+}
+
+void FontAtlas::setMaxPageCount(int count)
+{
+    s_maxPageCount = std::max(0, count);
+}
+
+int FontAtlas::getMaxPageCount()
+{
+    return s_maxPageCount;
+}
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
+, _id(++s_nextAtlasID)
 {
     _font->retain();
 
@@ -79,32 +115,23 @@ FontAtlas::FontAtlas(Font &theFont)
 
 void FontAtlas::reinit()
 {
-    if (_currentPageData)
-    {
-        delete []_currentPageData;
-        _currentPageData = nullptr;
-    }
-    
-    CC_SAFE_DELETE_ARRAY(_currentPageDataRGBA);
-    
+    CC_SAFE_DELETE_ARRAY(_currentPageData);
+
     auto texture = new (std::nothrow) Texture2D;
-    
-    _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
-    
-    auto outlineSize = _fontFreeType->getOutlineSize();
-    if(outlineSize > 0)
-    {
-        _currentPageDataSize *= 2;
-        
-        _currentPageDataSizeRGBA = _currentPageDataSize * 2;
-        _currentPageDataRGBA = new (std::nothrow) unsigned char[_currentPageDataSizeRGBA];
-        memset(_currentPageDataRGBA, 0, _currentPageDataSizeRGBA);
-    }
-    
+
+    auto pageSizeLimit = getPageSizeLimit();
+    _currentPageWidth = std::min(CacheTextureWidth, pageSizeLimit);
+    _currentPageHeight = std::min(CacheTextureHeight, pageSizeLimit);
+    // outlined glyphs are rendered as AI88 and expanded to RGBA8888 when uploaded
+    _bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+    _currentPageDataSize = _currentPageWidth * _currentPageHeight * _bytesPerPixel;
     _currentPageData = new (std::nothrow) unsigned char[_currentPageDataSize];
     memset(_currentPageData, 0, _currentPageDataSize);
-    
-    initTextureWithZeros(texture);
+    _currentPagePacker.reset(_currentPageWidth, _currentPageHeight);
+    _dirtyLeft = _dirtyTop = _dirtyRight = _dirtyBottom = 0;
+    _pageLastUse.assign(1, 0);
+
+    initPageTexture(texture, _currentPageWidth, _currentPageHeight);
 
     addTexture(texture,0);
     texture->release();
@@ -121,6 +148,15 @@ FontAtlas::~FontAtlas()
     }
 #endif
 
+    if (_fontFreeType)
+    {
+        _fontFreeType->cancelAsyncGlyphs();
+    }
+    if (_asyncGlyphsScheduled)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(FontAtlas::updateAsyncGlyphs), this);
+    }
+
     _font->release();
     releaseTextures();
 
@@ -135,37 +171,20 @@ FontAtlas::~FontAtlas()
 #endif
 }
 
-void FontAtlas::initTextureWithZeros(Texture2D *texture)
+void FontAtlas::initPageTexture(Texture2D *texture, int width, int height)
 {
-    char *zeros = nullptr;    
-    backend::PixelFormat pixelFormat;
-    float outlineSize = _fontFreeType->getOutlineSize();
-    size_t zeroBytes = 0;
-    if (outlineSize > 0)
-    {    
-        //metal do no support AI88 format
-        pixelFormat = backend::PixelFormat::RGBA8888;
-        zeroBytes = CacheTextureWidth * CacheTextureWidth * 4;
-    }
-    else
-    {
-        pixelFormat = backend::PixelFormat::A8;
-        zeroBytes = CacheTextureWidth * CacheTextureWidth;
-    }
-    zeros = new char[zeroBytes]();
-    //std::fill(zeros, zeros + cnt, 0);
-    texture->initWithData(zeros, zeroBytes, pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-    delete[] zeros;
+    //metal do no support AI88 format
+    auto pixelFormat = _fontFreeType->getOutlineSize() > 0 ? backend::PixelFormat::RGBA8888 : backend::PixelFormat::A8;
+    texture->initWithStorage(pixelFormat, width, height);
 }
 
 void FontAtlas::reset()
 {
+    // glyphs requested before are dropped with their definitions
+    _fontFreeType->cancelAsyncGlyphs();
     releaseTextures();
     
-    _currLineHeight = 0;
     _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
     
     reinit();
@@ -366,6 +385,11 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
 
     if (!_currentPageData)
         reinit(); 
+
+    if (s_maxPageCount > 0)
+    {
+        touchPages(utf32Text);
+    }
     
     std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
     findNewCharacters(utf32Text, codeMapOfNewChar);
@@ -374,124 +398,397 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
-    int adjustForDistanceMap = _letterPadding / 2;
-    int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
-
-    auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? backend::PixelFormat::AI88 : backend::PixelFormat::A8;
+    std::vector<RasterizedGlyph> glyphs(codeMapOfNewChar.size());
+    size_t index = 0;
+    for (auto&& it : codeMapOfNewChar)
+    {
+        glyphs[index].utf32Char = it.first;
+        glyphs[index].code = it.second;
+        ++index;
+    }
 
-    int startY = (int)_currentPageOrigY;
+    auto mode = FontFreeType::getRasterizationMode();
+    if (glyphs.size() < FontFreeType::ASYNC_GLYPH_MIN_COUNT)
+    {
+        mode = FontFreeType::RasterizationMode::SYNC;
+    }
 
-    for (auto&& it : codeMapOfNewChar)
+    if (mode == FontFreeType::RasterizationMode::ASYNC)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        // until the glyphs arrive, the text is laid out with blank letters of the right advance
+        FontLetterDefinition tempDef;
+        tempDef.validDefinition = true;
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
+        for (const auto& glyph : glyphs)
         {
-            tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+            tempDef.xAdvance = _fontFreeType->getGlyphAdvance(glyph.code);
+            _letterDefinitions[glyph.utf32Char] = tempDef;
+        }
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        if (_fontFreeType->rasterizeGlyphsAsync(glyphs))
+        {
+            if (!_asyncGlyphsScheduled)
             {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    updateTextureContent(pixelFormat, startY);
-
-                    startY = 0;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    
-                    initTextureWithZeros(tex);
-
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    addTexture(tex, _currentPage);
-                    
-                    tex->release();
-                }
+                Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(FontAtlas::updateAsyncGlyphs), this, 0, false);
+                _asyncGlyphsScheduled = true;
             }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+            return true;
+        }
+
+        // no worker threads, the glyphs were left untouched and are rendered here instead
+        for (const auto& glyph : glyphs)
+        {
+            _letterDefinitions.erase(glyph.utf32Char);
+        }
+        mode = FontFreeType::RasterizationMode::SYNC;
+    }
+
+    bool atlasChanged = false;
+    if (mode == FontFreeType::RasterizationMode::BLOCKING)
+    {
+        _fontFreeType->rasterizeGlyphs(glyphs);
+        for (const auto& glyph : glyphs)
+        {
+            addRasterizedGlyph(glyph, atlasChanged);
+        }
+    }
+    else
+    {
+        for (auto& glyph : glyphs)
+        {
+            _fontFreeType->rasterizeGlyph(glyph);
+            addRasterizedGlyph(glyph, atlasChanged);
+            std::vector<unsigned char>().swap(glyph.pixels);
+        }
+    }
+
+    updateTextureContent();
+
+    if (atlasChanged)
+    {
+        // the glyphs placed before were moved to a bigger texture or evicted
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+    return true;
+}
+
+void FontAtlas::updateAsyncGlyphs(float /*dt*/)
+{
+    std::vector<RasterizedGlyph> glyphs;
+    _fontFreeType->takeRasterizedGlyphs(glyphs);
+    if (!glyphs.empty())
+    {
+        bool atlasChanged = false;
+        for (const auto& glyph : glyphs)
+        {
+            addRasterizedGlyph(glyph, atlasChanged);
+        }
+        updateTextureContent();
+
+        // the labels showing blank letters for these glyphs are laid out again
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+
+    if (!_fontFreeType->hasPendingGlyphs())
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(FontAtlas::updateAsyncGlyphs), this);
+        _asyncGlyphsScheduled = false;
+    }
+}
+
+void FontAtlas::addRasterizedGlyph(const RasterizedGlyph& glyph, bool& atlasChanged)
+{
+    int adjustForDistanceMap = _letterPadding / 2;
+    int adjustForExtend = _letterEdgeExtend / 2;
+    int glyphX;
+    int glyphY;
+    FontLetterDefinition tempDef;
+
+    tempDef.xAdvance = glyph.xAdvance;
+    if (!glyph.pixels.empty())
+    {
+        tempDef.validDefinition = true;
+        tempDef.width = glyph.rect.size.width + _letterPadding + _letterEdgeExtend;
+        tempDef.height = glyph.rect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX = glyph.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + glyph.rect.origin.y - adjustForDistanceMap - adjustForExtend;
+
+        // the distance map already includes the padding
+        int glyphWidth = std::max((int)std::ceil(tempDef.width), static_cast<int>(glyph.width) + _letterEdgeExtend);
+        int glyphHeight = std::max((int)std::ceil(tempDef.height), static_cast<int>(glyph.height) + _letterEdgeExtend);
+        if (allocateGlyphRect(glyphWidth + 2 * GLYPH_MARGIN, glyphHeight + 2 * GLYPH_MARGIN, glyphX, glyphY, atlasChanged))
+        {
+            addDirtyRect(glyphX, glyphY, glyphWidth + 2 * GLYPH_MARGIN, glyphHeight + 2 * GLYPH_MARGIN);
+            glyphX += GLYPH_MARGIN;
+            glyphY += GLYPH_MARGIN;
+
+            int rowSize = static_cast<int>(glyph.width) * _bytesPerPixel;
+            for (long row = 0; row < glyph.height; ++row)
             {
-                _currLineHeight = glyphHeight;
+                auto dest = _currentPageData + ((glyphY + adjustForExtend + row) * _currentPageWidth + glyphX + adjustForExtend) * _bytesPerPixel;
+                memcpy(dest, glyph.pixels.data() + row * rowSize, rowSize);
             }
-            _fontFreeType->renderCharAt(_currentPageData, (int)_currentPageOrigX + adjustForExtend, (int)_currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
+            _pageLastUse[_currentPage] = Director::getInstance()->getTotalFrames();
 
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
+            auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
             tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
             // take from pixels to points
             tempDef.width = tempDef.width / scaleFactor;
             tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
+            tempDef.U = glyphX / scaleFactor;
+            tempDef.V = glyphY / scaleFactor;
+            _letterDefinitions[glyph.utf32Char] = tempDef;
+            return;
+        }
+        CCLOG("FontAtlas::addRasterizedGlyph: glyph %u of %dx%d doesn't fit in a page", (unsigned int)glyph.utf32Char, glyphWidth, glyphHeight);
+    }
+
+    tempDef.validDefinition = tempDef.xAdvance != 0;
+    tempDef.width = 0;
+    tempDef.height = 0;
+    tempDef.U = 0;
+    tempDef.V = 0;
+    tempDef.offsetX = 0;
+    tempDef.offsetY = 0;
+    tempDef.textureID = 0;
+    _letterDefinitions[glyph.utf32Char] = tempDef;
+}
+
+void FontAtlas::touchPage(int slot)
+{
+    if (s_maxPageCount > 0 && slot >= 0 && slot < (int)_pageLastUse.size())
+    {
+        _pageLastUse[slot] = Director::getInstance()->getTotalFrames();
+    }
+}
+
+void FontAtlas::touchPages(const std::u32string& u32Text)
+{
+    auto currentFrame = Director::getInstance()->getTotalFrames();
+    for (auto u32Code : u32Text)
+    {
+        auto outIterator = _letterDefinitions.find(u32Code);
+        if (outIterator != _letterDefinitions.end() && outIterator->second.width > 0)
+        {
+            _pageLastUse[outIterator->second.textureID] = currentFrame;
         }
-        else{
-            if(bitmap)
-                delete[] bitmap;
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
+    }
+}
+
+bool FontAtlas::allocateGlyphRect(int width, int height, int& x, int& y, bool& atlasChanged)
+{
+    auto pageSizeLimit = getPageSizeLimit();
+    if (width > pageSizeLimit || height > pageSizeLimit)
+    {
+        return false;
+    }
+
+    while (!_currentPagePacker.insert(width, height, x, y))
+    {
+        if (_currentPageWidth < pageSizeLimit || _currentPageHeight < pageSizeLimit)
+        {
+            growCurrentPage();
+            atlasChanged = true;
+        }
+        else
+        {
+            updateTextureContent();
+            if (s_maxPageCount > 0 && (int)_atlasTextures.size() >= s_maxPageCount && evictPage())
+            {
+                atlasChanged = true;
+            }
             else
-                tempDef.validDefinition = false;
-
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            _currentPageOrigX += 1;
+            {
+                addPage();
+            }
         }
+    }
+    return true;
+}
+
+void FontAtlas::growCurrentPage()
+{
+    // the width and the height are doubled in turn, each step at most doubles the texture memory
+    auto pageSizeLimit = getPageSizeLimit();
+    int width = _currentPageWidth;
+    int height = _currentPageHeight;
+    if (width < pageSizeLimit && (width <= height || height >= pageSizeLimit))
+    {
+        width = std::min(width * 2, pageSizeLimit);
+    }
+    else
+    {
+        height = std::min(height * 2, pageSizeLimit);
+    }
+
+    int dataSize = width * height * _bytesPerPixel;
+    auto data = new (std::nothrow) unsigned char[dataSize];
+    memset(data, 0, dataSize);
+    int rowSize = _currentPageWidth * _bytesPerPixel;
+    for (int row = 0; row < _currentPageHeight; ++row)
+    {
+        memcpy(data + row * width * _bytesPerPixel, _currentPageData + row * rowSize, rowSize);
+    }
+    delete []_currentPageData;
+    _currentPageData = data;
+    _currentPageDataSize = dataSize;
+
+    // the storage is reallocated, so everything placed on the page so far is uploaded again
+    addDirtyRect(0, 0, _currentPageWidth, _currentPagePacker.getUsedHeight());
+    initPageTexture(_atlasTextures[_currentPage], width, height);
+    _currentPagePacker.grow(width, height);
+    _currentPageWidth = width;
+    _currentPageHeight = height;
+}
+
+bool FontAtlas::evictPage()
+{
+    auto currentFrame = Director::getInstance()->getTotalFrames();
+    int page = -1;
+    for (int i = 0; i < (int)_pageLastUse.size(); ++i)
+    {
+        // a page drawn in the previous frame is still on screen, labels drawn later in this frame use it
+        if (currentFrame - _pageLastUse[i] > 1 && (page < 0 || _pageLastUse[i] < _pageLastUse[page]))
+        {
+            page = i;
+        }
+    }
+    if (page < 0)
+    {
+        return false;
+    }
 
-        _letterDefinitions[it.first] = tempDef;
+    for (auto it = _letterDefinitions.begin(); it != _letterDefinitions.end();)
+    {
+        if (it->second.textureID == page && it->second.width > 0)
+        {
+            it = _letterDefinitions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
     }
 
-    updateTextureContent(pixelFormat, startY);
+    auto texture = _atlasTextures[page];
+    _currentPage = page;
+    _pageLastUse[page] = currentFrame;
+    resetCurrentPage(texture->getPixelsWide(), texture->getPixelsHigh());
     return true;
 }
 
-void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
+void FontAtlas::addPage()
+{
+    auto tex = new (std::nothrow) Texture2D;
+
+    initPageTexture(tex, _currentPageWidth, _currentPageHeight);
+
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
+    }
+    else
+    {
+        tex->setAliasTexParameters();
+    }
+
+    _currentPage = (int)_atlasTextures.size();
+    addTexture(tex, _currentPage);
+    tex->release();
+
+    _pageLastUse.push_back(Director::getInstance()->getTotalFrames());
+    resetCurrentPage(_currentPageWidth, _currentPageHeight);
+}
+
+void FontAtlas::resetCurrentPage(int width, int height)
+{
+    int dataSize = width * height * _bytesPerPixel;
+    if (dataSize != _currentPageDataSize)
+    {
+        delete []_currentPageData;
+        _currentPageData = new (std::nothrow) unsigned char[dataSize];
+        _currentPageDataSize = dataSize;
+    }
+    memset(_currentPageData, 0, _currentPageDataSize);
+
+    _currentPageWidth = width;
+    _currentPageHeight = height;
+    _currentPagePacker.reset(width, height);
+    _dirtyLeft = _dirtyTop = _dirtyRight = _dirtyBottom = 0;
+}
+
+void FontAtlas::addDirtyRect(int x, int y, int width, int height)
 {
-    unsigned char *data = nullptr;
-    auto outlineSize = _fontFreeType->getOutlineSize();
-    if (outlineSize > 0 && format == backend::PixelFormat::AI88)
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if (_dirtyRight <= _dirtyLeft || _dirtyBottom <= _dirtyTop)
     {
-        int nLen = CacheTextureWidth * ((int)_currentPageOrigY - startY + _currLineHeight);
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-        memset(_currentPageDataRGBA, 0, 4 * nLen);
-        for (auto i = 0; i < nLen; i++)
+        _dirtyLeft = x;
+        _dirtyTop = y;
+        _dirtyRight = x + width;
+        _dirtyBottom = y + height;
+    }
+    else
+    {
+        _dirtyLeft = std::min(_dirtyLeft, x);
+        _dirtyTop = std::min(_dirtyTop, y);
+        _dirtyRight = std::max(_dirtyRight, x + width);
+        _dirtyBottom = std::max(_dirtyBottom, y + height);
+    }
+}
+
+void FontAtlas::updateTextureContent()
+{
+    int width = _dirtyRight - _dirtyLeft;
+    int height = _dirtyBottom - _dirtyTop;
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    auto texture = _atlasTextures[_currentPage];
+    if (_bytesPerPixel == 2)
+    {
+        // expand AI88 to RGBA8888
+        _updateBuffer.resize(width * height * 4);
+        auto dest = _updateBuffer.data();
+        for (int row = 0; row < height; ++row)
         {
-            _currentPageDataRGBA[i*4] = data[i*2];
-            _currentPageDataRGBA[i*4+3] = data[i*2+1];
+            auto src = _currentPageData + ((_dirtyTop + row) * _currentPageWidth + _dirtyLeft) * 2;
+            for (int i = 0; i < width; ++i, src += 2, dest += 4)
+            {
+                dest[0] = src[0];
+                dest[1] = 0;
+                dest[2] = 0;
+                dest[3] = src[1];
+            }
         }
-        _atlasTextures[_currentPage]->updateWithData(_currentPageDataRGBA, 0, startY, CacheTextureWidth, (int)_currentPageOrigY - startY + _currLineHeight);
+        texture->updateWithData(_updateBuffer.data(), _dirtyLeft, _dirtyTop, width, height);
+    }
+    else if (width == _currentPageWidth)
+    {
+        texture->updateWithData(_currentPageData + _dirtyTop * _currentPageWidth, 0, _dirtyTop, width, height);
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
-       _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, (int)_currentPageOrigY - startY + _currLineHeight);
+        _updateBuffer.resize(width * height);
+        for (int row = 0; row < height; ++row)
+        {
+            memcpy(_updateBuffer.data() + row * width, _currentPageData + (_dirtyTop + row) * _currentPageWidth + _dirtyLeft, width);
+        }
+        texture->updateWithData(_updateBuffer.data(), _dirtyLeft, _dirtyTop, width, height);
     }
+
+    _dirtyLeft = _dirtyTop = _dirtyRight = _dirtyBottom = 0;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -31,11 +31,13 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
 #include "platform/CCStdC.h" // ssize_t on windows
 #include "renderer/CCTexture2D.h"
+#include "2d/CCSkylinePacker.h"
 
 NS_CC_BEGIN
 
@@ -43,6 +45,7 @@ class Font;
 class EventCustom;
 class EventListenerCustom;
 class FontFreeType;
+struct RasterizedGlyph;
 
 struct FontLetterDefinition
 {
@@ -64,6 +67,27 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    /** Dispatched when glyphs of the atlas moved, were evicted or finished rendering, the labels using it must lay their text out again. */
+    static const char* CMD_UPDATE_FONTATLAS;
+
+    /**
+     * Sets the size a page of a dynamic atlas can grow to, 2048 by default.
+     * A page starts at CacheTextureWidth x CacheTextureHeight and grows in place until it reaches this size,
+     * a new page is only started then. The size is clamped to the maximum texture size of the device.
+     */
+    static void setMaxPageSize(int size);
+    static int getMaxPageSize();
+
+    /**
+     * Sets how many pages a dynamic atlas may use, 0 (no limit) by default.
+     * Once the limit is reached, the least recently used page is cleared for the new glyphs.
+     * Pages drawn or laid out in the current or the previous frame are never cleared, labels drawn
+     * every frame keep their pages. The limit is exceeded when those pages alone don't leave room
+     * for the new glyphs.
+     */
+    static void setMaxPageCount(int count);
+    static int getMaxPageCount();
+
     /**
      * @js ctor
      */
@@ -89,6 +113,9 @@ public:
     Texture2D* getTexture(int slot);
     const Font* getFont() const { return _font; }
 
+    /** Stamps a page as used in this frame, labels call it for the pages they draw. */
+    void touchPage(int slot);
+
     /** listen the event that renderer was recreated on Android/WP8
      It only has effect on Android and WP8.
      */
@@ -122,7 +149,32 @@ protected:
 
     void conversionU32TOGB2312(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
-    void initTextureWithZeros(Texture2D *texture);
+    /** Initializes the storage of a page of the given size, the texels are written by updateTextureContent only. */
+    void initPageTexture(Texture2D *texture, int width, int height);
+
+    /** Adds the definition of a rendered glyph, copying its pixels into the current page. */
+    void addRasterizedGlyph(const RasterizedGlyph& glyph, bool& atlasChanged);
+
+    /** Adds the glyphs rendered by the worker threads since the last frame. */
+    void updateAsyncGlyphs(float dt);
+
+    /** Reserves a rectangle for a glyph, growing the current page or moving to another one when it is full. */
+    bool allocateGlyphRect(int width, int height, int& x, int& y, bool& atlasChanged);
+
+    void growCurrentPage();
+
+    /** Makes the least recently used page the current one and forgets its glyphs, returns false if every page is in use. */
+    bool evictPage();
+
+    void addPage();
+
+    /** Empties the current page and sizes its pixel buffer, the texture is left as it is. */
+    void resetCurrentPage(int width, int height);
+
+    void addDirtyRect(int x, int y, int width, int height);
+
+    /** Stamps the pages holding the glyphs of the text as used in this frame. */
+    void touchPages(const std::u32string& u32Text);
 
     /**
      * Scale each font letter by scaleFactor.
@@ -131,7 +183,8 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
     
-    void updateTextureContent(backend::PixelFormat format, int startY);
+    /** Uploads the dirty rectangle of the current page. */
+    void updateTextureContent();
 
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
@@ -143,18 +196,28 @@ protected:
     // Dynamic GlyphCollection related stuff
     int _currentPage = 0;
     unsigned char *_currentPageData = nullptr;
-    unsigned char *_currentPageDataRGBA = nullptr;
     int _currentPageDataSize = 0;
-    int _currentPageDataSizeRGBA = 0;
-    float _currentPageOrigX = 0;
-    float _currentPageOrigY = 0;
+    int _currentPageWidth = 0;
+    int _currentPageHeight = 0;
+    int _bytesPerPixel = 1;
+    SkylinePacker _currentPagePacker;
+    // the part of the current page written since the last upload
+    int _dirtyLeft = 0;
+    int _dirtyTop = 0;
+    int _dirtyRight = 0;
+    int _dirtyBottom = 0;
+    std::vector<unsigned char> _updateBuffer;
+    // the frame each page was last used in, for the page budget
+    std::vector<unsigned int> _pageLastUse;
     int _letterPadding = 0;
     int _letterEdgeExtend = 0;
 
     int _fontAscender = 0;
     EventListenerCustom* _rendererRecreatedListener = nullptr;
     bool _antialiasEnabled = true;
-    int _currLineHeight = 0;
+    bool _asyncGlyphsScheduled = false;
+    // identifies the atlas in the label layout cache, unlike its address it is never reused
+    unsigned int _id = 0;
 
     friend class Label;
 };
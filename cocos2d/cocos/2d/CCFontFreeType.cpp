@@ -26,11 +26,16 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 #include FT_BBOX_H
+#include FT_ADVANCES_H
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include "edtaa3func.h"
 #include "2d/CCFontAtlas.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCWorkerPool.h"
 
 NS_CC_BEGIN
 
@@ -38,6 +43,9 @@ NS_CC_BEGIN
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
 const int  FontFreeType::DistanceMapSpread = 3;
+const size_t FontFreeType::ASYNC_GLYPH_MIN_COUNT = 8;
+FontFreeType::RasterizationMode FontFreeType::_rasterizationMode = FontFreeType::RasterizationMode::ASYNC;
+FontFreeType::RasterizationStats FontFreeType::_rasterizationStats;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
 const char* FontFreeType::_glyphNEHE = "!\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~ ";
@@ -50,6 +58,8 @@ typedef struct _DataRef
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
 
+static void shutdownGlyphRasterizer(GlyphRasterizer* rasterizer);
+
 FontFreeType * FontFreeType::create(const std::string &fontName, float fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,float outline /* = 0 */)
 {
     FontFreeType *tempFont =  new (std::nothrow) FontFreeType(distanceFieldEnabled,outline);
@@ -105,6 +115,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
 , _lineHeight(0)
+, _charSize(0)
 , _fontAtlas(nullptr)
 , _usedGlyphs(GlyphCollection::ASCII)
 {
@@ -174,6 +185,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
     int fontSizePoints = (int)(64.f * fontSize * CC_CONTENT_SCALE_FACTOR());
     if (FT_Set_Char_Size(face, fontSizePoints, fontSizePoints, dpi, dpi))
         return false;
+    _charSize = fontSizePoints;
     
     // store the face globally
     _fontRef = face;
@@ -185,6 +197,13 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
+    if (_glyphRasterizer)
+    {
+        cancelAsyncGlyphs();
+        // the faces of the worker threads read the font data released below
+        shutdownGlyphRasterizer(_glyphRasterizer.get());
+    }
+
     if (_FTInitialized)
     {
         if (_stroker)
@@ -289,46 +308,92 @@ const char* FontFreeType::getFontFamily() const
     return _fontRef->family_name;
 }
 
-unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+static unsigned char* renderGlyphWithOutline(FT_Library library, FT_Face face, FT_Stroker stroker, uint64_t theChar, FT_BBox &bbox)
+{   
+    unsigned char* ret = nullptr;
+    if (FT_Load_Char(face, static_cast<FT_ULong>(theChar), FT_LOAD_NO_BITMAP) == 0)
+    {
+        if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        {
+            FT_Glyph glyph;
+            if (FT_Get_Glyph(face->glyph, &glyph) == 0)
+            {
+                FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
+                if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+                {
+                    FT_Outline *outline = &reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
+                    FT_Glyph_Get_CBox(glyph,FT_GLYPH_BBOX_GRIDFIT,&bbox);
+                    long width = (bbox.xMax - bbox.xMin)>>6;
+                    long rows = (bbox.yMax - bbox.yMin)>>6;
+
+                    FT_Bitmap bmp;
+                    bmp.buffer = new (std::nothrow) unsigned char[width * rows];
+                    memset(bmp.buffer, 0, width * rows);
+                    bmp.width = (int)width;
+                    bmp.rows = (int)rows;
+                    bmp.pitch = (int)width;
+                    bmp.pixel_mode = FT_PIXEL_MODE_GRAY;
+                    bmp.num_grays = 256;
+
+                    FT_Raster_Params params;
+                    memset(&params, 0, sizeof (params));
+                    params.source = outline;
+                    params.target = &bmp;
+                    params.flags = FT_RASTER_FLAG_AA;
+                    FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
+                    FT_Outline_Render(library, outline, &params);
+
+                    ret = bmp.buffer;
+                }
+                FT_Done_Glyph(glyph);
+            }
+        }
+    }
+
+    return ret;
+}
+
+static unsigned char* renderGlyphBitmap(FT_Library library, FT_Face face, FT_Stroker stroker, bool distanceFieldEnabled, float outlineSize,
+    uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
 {
     bool invalidChar = true;
     unsigned char* ret = nullptr;
 
     do
     {
-        if (_fontRef == nullptr)
+        if (face == nullptr)
             break;
 
-        if (_distanceFieldEnabled)
+        if (distanceFieldEnabled)
         {
-            if (FT_Load_Char(_fontRef, static_cast<FT_ULong>(theChar), FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(face, static_cast<FT_ULong>(theChar), FT_LOAD_RENDER | FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT))
                 break;
         }
         else
         {
-            if (FT_Load_Char(_fontRef, static_cast<FT_ULong>(theChar), FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
+            if (FT_Load_Char(face, static_cast<FT_ULong>(theChar), FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
                 break;
         }
 
-        auto& metrics = _fontRef->glyph->metrics;
+        auto& metrics = face->glyph->metrics;
         outRect.origin.x = static_cast<float>(metrics.horiBearingX >> 6);
         outRect.origin.y = static_cast<float>(-(metrics.horiBearingY >> 6));
         outRect.size.width = static_cast<float>((metrics.width >> 6));
         outRect.size.height = static_cast<float>((metrics.height >> 6));
 
-        xAdvance = (static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6));
+        xAdvance = (static_cast<int>(face->glyph->metrics.horiAdvance >> 6));
 
-        outWidth  = _fontRef->glyph->bitmap.width;
-        outHeight = _fontRef->glyph->bitmap.rows;
-        ret = _fontRef->glyph->bitmap.buffer;
+        outWidth  = face->glyph->bitmap.width;
+        outHeight = face->glyph->bitmap.rows;
+        ret = face->glyph->bitmap.buffer;
 
-        if (_outlineSize > 0 && outWidth > 0 && outHeight > 0)
+        if (outlineSize > 0 && outWidth > 0 && outHeight > 0)
         {
             auto copyBitmap = new (std::nothrow) unsigned char[outWidth * outHeight];
             memcpy(copyBitmap,ret,outWidth * outHeight * sizeof(unsigned char));
 
             FT_BBox bbox;
-            auto outlineBitmap = getGlyphBitmapWithOutline(theChar,bbox);
+            auto outlineBitmap = renderGlyphWithOutline(library, face, stroker, theChar, bbox);
             if(outlineBitmap == nullptr)
             {
                 ret = nullptr;
@@ -354,7 +419,7 @@ unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, lo
             auto blendHeight = blendImageMaxY - MIN(outlineMinY, glyphMinY);
 
             outRect.origin.x = (float)blendImageMinX;
-            outRect.origin.y = -blendImageMaxY + _outlineSize;
+            outRect.origin.y = -blendImageMaxY + outlineSize;
 
             unsigned char *blendImage = nullptr;
             if (blendWidth > 0 && blendHeight > 0)
@@ -416,49 +481,14 @@ unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, lo
     }
 }
 
-unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBox &bbox)
-{   
-    unsigned char* ret = nullptr;
-    if (FT_Load_Char(_fontRef, static_cast<FT_ULong>(theChar), FT_LOAD_NO_BITMAP) == 0)
-    {
-        if (_fontRef->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
-        {
-            FT_Glyph glyph;
-            if (FT_Get_Glyph(_fontRef->glyph, &glyph) == 0)
-            {
-                FT_Glyph_StrokeBorder(&glyph, _stroker, 0, 1);
-                if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
-                {
-                    FT_Outline *outline = &reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
-                    FT_Glyph_Get_CBox(glyph,FT_GLYPH_BBOX_GRIDFIT,&bbox);
-                    long width = (bbox.xMax - bbox.xMin)>>6;
-                    long rows = (bbox.yMax - bbox.yMin)>>6;
-
-                    FT_Bitmap bmp;
-                    bmp.buffer = new (std::nothrow) unsigned char[width * rows];
-                    memset(bmp.buffer, 0, width * rows);
-                    bmp.width = (int)width;
-                    bmp.rows = (int)rows;
-                    bmp.pitch = (int)width;
-                    bmp.pixel_mode = FT_PIXEL_MODE_GRAY;
-                    bmp.num_grays = 256;
-
-                    FT_Raster_Params params;
-                    memset(&params, 0, sizeof (params));
-                    params.source = outline;
-                    params.target = &bmp;
-                    params.flags = FT_RASTER_FLAG_AA;
-                    FT_Outline_Translate(outline,-bbox.xMin,-bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
-
-                    ret = bmp.buffer;
-                }
-                FT_Done_Glyph(glyph);
-            }
-        }
-    }
+unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+{
+    return renderGlyphBitmap(_FTlibrary, _fontRef, _stroker, _distanceFieldEnabled, _outlineSize, theChar, outWidth, outHeight, outRect, xAdvance);
+}
 
-    return ret;
+unsigned char * FontFreeType::getGlyphBitmapWithOutline(uint64_t theChar, FT_BBox &bbox)
+{
+    return renderGlyphWithOutline(_FTlibrary, _fontRef, _stroker, theChar, bbox);
 }
 
 unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
@@ -542,6 +572,451 @@ unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
     return out;
 }
 
+static void rasterizeGlyphPixels(FT_Library library, FT_Face face, FT_Stroker stroker, bool distanceFieldEnabled, float outlineSize,
+    RasterizedGlyph& glyph)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    long bitmapWidth = 0;
+    long bitmapHeight = 0;
+    auto bitmap = renderGlyphBitmap(library, face, stroker, distanceFieldEnabled, outlineSize, glyph.code, bitmapWidth, bitmapHeight, glyph.rect, glyph.xAdvance);
+    glyph.pixels.clear();
+    glyph.width = 0;
+    glyph.height = 0;
+    if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+    {
+        // tightly packed rows: the distance map, AI88 for outlined fonts, A8 otherwise
+        if (distanceFieldEnabled)
+        {
+            auto distanceMap = makeDistanceMap(bitmap, bitmapWidth, bitmapHeight);
+            glyph.width = bitmapWidth + 2 * FontFreeType::DistanceMapSpread;
+            glyph.height = bitmapHeight + 2 * FontFreeType::DistanceMapSpread;
+            glyph.pixels.assign(distanceMap, distanceMap + glyph.width * glyph.height);
+            free(distanceMap);
+        }
+        else
+        {
+            glyph.width = bitmapWidth;
+            glyph.height = bitmapHeight;
+            glyph.pixels.assign(bitmap, bitmap + bitmapWidth * bitmapHeight * (outlineSize > 0 ? 2 : 1));
+        }
+    }
+    // the outlined bitmap is blended into a buffer of its own, the others belong to the face
+    if (outlineSize > 0)
+    {
+        delete [] bitmap;
+    }
+    glyph.rasterizationTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() / 1000.f;
+}
+
+/**
+ * Renders the glyphs of a font on the WorkerPool threads.
+ * FreeType objects are not thread safe, so every job running uses a library and a face of its own,
+ * created from the font data of the FontFreeType. They are kept for the next jobs and destroyed once no
+ * job is running or queued.
+ * Results are picked up by the cocos thread with take(), nothing calls back into the engine from a worker.
+ */
+class GlyphRasterizer : public std::enable_shared_from_this<GlyphRasterizer>
+{
+public:
+    GlyphRasterizer(const Data& fontData, FT_Encoding encoding, int charSize, bool distanceFieldEnabled, float outlineSize)
+    : _fontData(fontData.getBytes())
+    , _fontDataSize(fontData.getSize())
+    , _encoding(encoding)
+    , _charSize(charSize)
+    , _distanceFieldEnabled(distanceFieldEnabled)
+    , _outlineSize(outlineSize)
+    {
+    }
+
+    ~GlyphRasterizer()
+    {
+        shutdown();
+    }
+
+    void rasterize(std::vector<RasterizedGlyph>& glyphs)
+    {
+        auto self = shared_from_this();
+        {
+            // keeps the contexts pooled between the ranges
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_queued;
+        }
+        WorkerPool::getInstance()->parallelFor(glyphs.size(), GLYPHS_PER_JOB, [self, &glyphs](size_t begin, size_t end) {
+            Context* context = nullptr;
+            if (!self->acquireContext(self->_generation.load(), false, context))
+            {
+                return;
+            }
+            for (size_t i = begin; i < end; ++i)
+            {
+                self->rasterizeGlyph(context, glyphs[i]);
+            }
+            self->releaseContext(context);
+        });
+
+        std::vector<Context*> idleContexts;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_queued;
+            takeIdleContextsLocked(idleContexts);
+        }
+        destroyContexts(idleContexts);
+    }
+
+    void rasterizeAsync(std::vector<RasterizedGlyph>& glyphs)
+    {
+        auto self = shared_from_this();
+        auto generation = _generation.load();
+        {
+            // counted up front, so the contexts stay pooled until the last batch is done
+            std::lock_guard<std::mutex> lock(_mutex);
+            _queued += static_cast<int>((glyphs.size() + GLYPHS_PER_JOB - 1) / GLYPHS_PER_JOB);
+        }
+        for (size_t begin = 0; begin < glyphs.size(); begin += GLYPHS_PER_JOB)
+        {
+            auto end = std::min(begin + GLYPHS_PER_JOB, glyphs.size());
+            auto batch = std::make_shared<std::vector<RasterizedGlyph>>(
+                std::make_move_iterator(glyphs.begin() + begin), std::make_move_iterator(glyphs.begin() + end));
+            WorkerPool::getInstance()->enqueue([self, batch, generation]() {
+                self->runBatch(*batch, generation);
+            });
+        }
+        _pendingCount += glyphs.size();
+        glyphs.clear();
+    }
+
+    void take(std::vector<RasterizedGlyph>& glyphs)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingCount -= _completed.size();
+        glyphs.swap(_completed);
+        _completed.clear();
+    }
+
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_generation;
+        _completed.clear();
+        _pendingCount = 0;
+    }
+
+    /** Waits for the jobs using a face and destroys the faces, the font data may be released afterwards. */
+    void shutdown()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _shutdown = true;
+        ++_generation;
+        _completed.clear();
+        _pendingCount = 0;
+        _idle.wait(lock, [this] { return _running == 0; });
+        destroyContexts(_contexts);
+        _contexts.clear();
+    }
+
+    /** Glyphs queued and not taken yet, only used by the cocos thread. */
+    size_t getPendingCount() const { return _pendingCount; }
+
+private:
+    struct Context
+    {
+        FT_Library library = nullptr;
+        FT_Face face = nullptr;
+        FT_Stroker stroker = nullptr;
+    };
+
+    static const size_t GLYPHS_PER_JOB = 4;
+
+    void runBatch(std::vector<RasterizedGlyph>& glyphs, unsigned int generation)
+    {
+        Context* context = nullptr;
+        if (!acquireContext(generation, true, context))
+        {
+            return;
+        }
+        for (auto& glyph : glyphs)
+        {
+            if (_generation.load() != generation)
+                break;
+            rasterizeGlyph(context, glyph);
+        }
+
+        std::vector<Context*> idleContexts;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_generation.load() == generation)
+            {
+                _completed.insert(_completed.end(), std::make_move_iterator(glyphs.begin()), std::make_move_iterator(glyphs.end()));
+            }
+            releaseContextLocked(context, idleContexts);
+        }
+        destroyContexts(idleContexts);
+    }
+
+    void rasterizeGlyph(Context* context, RasterizedGlyph& glyph)
+    {
+        if (context && context->face)
+        {
+            rasterizeGlyphPixels(context->library, context->face, context->stroker, _distanceFieldEnabled, _outlineSize, glyph);
+        }
+    }
+
+    /** Gets a context for a job of the generation, returns false if the generation is stale.
+     * dequeued is true for the jobs counted by rasterizeAsync().
+     * Every successful call must be paired with releaseContext(), even if context is nullptr.
+     */
+    bool acquireContext(unsigned int generation, bool dequeued, Context*& context)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (dequeued)
+            {
+                --_queued;
+            }
+            if (_shutdown || _generation.load() != generation)
+            {
+                return false;
+            }
+            ++_running;
+            if (!_contexts.empty())
+            {
+                context = _contexts.back();
+                _contexts.pop_back();
+            }
+        }
+        if (context == nullptr)
+        {
+            context = createContext();
+        }
+        return true;
+    }
+
+    void releaseContext(Context* context)
+    {
+        std::vector<Context*> idleContexts;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            releaseContextLocked(context, idleContexts);
+        }
+        destroyContexts(idleContexts);
+    }
+
+    /** Pools the context. Once no job runs or is queued, moves the pool to idleContexts for the caller to
+     * destroy after unlocking, so an idle font doesn't keep a face per worker.
+     */
+    void releaseContextLocked(Context* context, std::vector<Context*>& idleContexts)
+    {
+        if (context)
+        {
+            _contexts.push_back(context);
+        }
+        if (--_running == 0)
+        {
+            takeIdleContextsLocked(idleContexts);
+            _idle.notify_all();
+        }
+    }
+
+    void takeIdleContextsLocked(std::vector<Context*>& idleContexts)
+    {
+        if (_running == 0 && _queued == 0)
+        {
+            idleContexts.swap(_contexts);
+        }
+    }
+
+    Context* createContext()
+    {
+        // a context without a face is kept on failure, it renders nothing
+        auto context = new (std::nothrow) Context;
+        if (context == nullptr)
+        {
+            return nullptr;
+        }
+        if (FT_Init_FreeType(&context->library))
+        {
+            context->library = nullptr;
+            return context;
+        }
+        FT_Face face;
+        if (FT_New_Memory_Face(context->library, _fontData, _fontDataSize, 0, &face))
+        {
+            return context;
+        }
+        if (FT_Select_Charmap(face, _encoding) || FT_Set_Char_Size(face, _charSize, _charSize, 72, 72))
+        {
+            FT_Done_Face(face);
+            return context;
+        }
+        context->face = face;
+        if (_outlineSize > 0)
+        {
+            FT_Stroker_New(context->library, &context->stroker);
+            FT_Stroker_Set(context->stroker,
+                (int)(_outlineSize * 64),
+                FT_STROKER_LINECAP_ROUND,
+                FT_STROKER_LINEJOIN_ROUND,
+                0);
+        }
+        return context;
+    }
+
+    static void destroyContexts(const std::vector<Context*>& contexts)
+    {
+        for (auto context : contexts)
+        {
+            if (context->stroker)
+                FT_Stroker_Done(context->stroker);
+            if (context->face)
+                FT_Done_Face(context->face);
+            if (context->library)
+                FT_Done_FreeType(context->library);
+            delete context;
+        }
+    }
+
+    const unsigned char* _fontData;
+    ssize_t _fontDataSize;
+    FT_Encoding _encoding;
+    int _charSize;
+    bool _distanceFieldEnabled;
+    float _outlineSize;
+
+    std::mutex _mutex;
+    std::condition_variable _idle;
+    std::vector<Context*> _contexts;
+    std::vector<RasterizedGlyph> _completed;
+    std::atomic<unsigned int> _generation{0};
+    int _running = 0;
+    int _queued = 0;
+    bool _shutdown = false;
+    size_t _pendingCount = 0;
+};
+
+static void shutdownGlyphRasterizer(GlyphRasterizer* rasterizer)
+{
+    rasterizer->shutdown();
+}
+
+GlyphRasterizer* FontFreeType::getGlyphRasterizer()
+{
+    if (!_glyphRasterizer)
+    {
+        auto it = s_cacheFontData.find(_fontName);
+        if (it == s_cacheFontData.end() || _fontRef == nullptr)
+        {
+            return nullptr;
+        }
+        _glyphRasterizer = std::make_shared<GlyphRasterizer>(it->second.data, _encoding, _charSize, _distanceFieldEnabled, _outlineSize);
+    }
+    return _glyphRasterizer.get();
+}
+
+void FontFreeType::rasterizeGlyph(RasterizedGlyph& glyph)
+{
+    rasterizeGlyphPixels(_FTlibrary, _fontRef, _stroker, _distanceFieldEnabled, _outlineSize, glyph);
+}
+
+void FontFreeType::rasterizeGlyphs(std::vector<RasterizedGlyph>& glyphs)
+{
+    auto rasterizer = getGlyphRasterizer();
+    if (rasterizer == nullptr)
+    {
+        for (auto& glyph : glyphs)
+        {
+            rasterizeGlyph(glyph);
+        }
+        return;
+    }
+
+    auto requestTime = std::chrono::steady_clock::now();
+    for (auto& glyph : glyphs)
+    {
+        glyph.requestTime = requestTime;
+    }
+    rasterizer->rasterize(glyphs);
+    for (const auto& glyph : glyphs)
+    {
+        recordRasterizedGlyph(glyph);
+    }
+}
+
+bool FontFreeType::rasterizeGlyphsAsync(std::vector<RasterizedGlyph>& glyphs)
+{
+    auto rasterizer = getGlyphRasterizer();
+    if (rasterizer == nullptr)
+    {
+        return false;
+    }
+
+    auto requestTime = std::chrono::steady_clock::now();
+    for (auto& glyph : glyphs)
+    {
+        glyph.requestTime = requestTime;
+    }
+    _rasterizationStats.pendingGlyphs += glyphs.size();
+    rasterizer->rasterizeAsync(glyphs);
+    return true;
+}
+
+void FontFreeType::takeRasterizedGlyphs(std::vector<RasterizedGlyph>& glyphs)
+{
+    glyphs.clear();
+    if (_glyphRasterizer)
+    {
+        _glyphRasterizer->take(glyphs);
+        _rasterizationStats.pendingGlyphs -= std::min(_rasterizationStats.pendingGlyphs, glyphs.size());
+        for (const auto& glyph : glyphs)
+        {
+            recordRasterizedGlyph(glyph);
+        }
+    }
+}
+
+void FontFreeType::cancelAsyncGlyphs()
+{
+    if (_glyphRasterizer)
+    {
+        _rasterizationStats.pendingGlyphs -= std::min(_rasterizationStats.pendingGlyphs, _glyphRasterizer->getPendingCount());
+        _glyphRasterizer->cancel();
+    }
+}
+
+bool FontFreeType::hasPendingGlyphs() const
+{
+    return _glyphRasterizer && _glyphRasterizer->getPendingCount() > 0;
+}
+
+int FontFreeType::getGlyphAdvance(uint64_t theChar) const
+{
+    if (_fontRef == nullptr)
+        return 0;
+
+    FT_Int32 loadFlags = _distanceFieldEnabled ? FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT : FT_LOAD_NO_AUTOHINT;
+    FT_Fixed advance;
+    if (FT_Get_Advance(_fontRef, FT_Get_Char_Index(_fontRef, static_cast<FT_ULong>(theChar)), loadFlags, &advance))
+        return 0;
+
+    return static_cast<int>(advance >> 16);
+}
+
+void FontFreeType::recordRasterizedGlyph(const RasterizedGlyph& glyph)
+{
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - glyph.requestTime).count() / 1000.f;
+    auto& stats = _rasterizationStats;
+    stats.rasterizedGlyphs += 1;
+    stats.averageLatency += (latency - stats.averageLatency) / stats.rasterizedGlyphs;
+    stats.maxLatency = std::max(stats.maxLatency, latency);
+    stats.averageRasterizationTime += (glyph.rasterizationTime - stats.averageRasterizationTime) / stats.rasterizedGlyphs;
+}
+
+void FontFreeType::resetRasterizationStats()
+{
+    auto pendingGlyphs = _rasterizationStats.pendingGlyphs;
+    _rasterizationStats = RasterizationStats();
+    _rasterizationStats.pendingGlyphs = pendingGlyphs;
+}
+
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
 {
     int iX = posX;
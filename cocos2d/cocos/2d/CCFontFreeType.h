@@ -32,6 +32,9 @@
 #include "2d/CCFont.h"
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
 #include <ft2build.h>
 
 #include FT_FREETYPE_H
@@ -39,16 +42,74 @@
 
 NS_CC_BEGIN
 
+class GlyphRasterizer;
+
+/** A glyph rendered into pixels ready to be copied into an atlas page. */
+struct RasterizedGlyph
+{
+    char32_t utf32Char = 0;
+    /** The code looked up in the font, it differs from utf32Char for GB2312 fonts. */
+    uint64_t code = 0;
+    /** width x height pixels: the distance map, AI88 for outlined fonts, A8 otherwise. Empty for blank glyphs. */
+    std::vector<unsigned char> pixels;
+    long width = 0;
+    long height = 0;
+    /** The glyph box and advance, as getGlyphBitmap() returns them. */
+    Rect rect;
+    int xAdvance = 0;
+    std::chrono::steady_clock::time_point requestTime;
+    float rasterizationTime = 0;
+};
+
 class CC_DLL FontFreeType : public Font
 {
 public:
     static const int DistanceMapSpread;
 
+    /** Where the glyphs of dynamic atlases are rendered. */
+    enum class RasterizationMode
+    {
+        /** On the cocos thread, when a label needs them. */
+        SYNC,
+        /** On the worker threads, the cocos thread waits for them. */
+        BLOCKING,
+        /** On the worker threads. Labels show the glyphs already rendered and are laid out again as the others arrive. */
+        ASYNC,
+    };
+
+    /** Statistics of the glyphs rendered on the worker threads. Times are in milliseconds. */
+    struct RasterizationStats
+    {
+        /** Glyphs requested and not added to their atlas yet. */
+        size_t pendingGlyphs = 0;
+        /** Glyphs rendered since the statistics were reset. */
+        uint64_t rasterizedGlyphs = 0;
+        /** Average and highest time between requesting a glyph and adding it to its atlas. */
+        float averageLatency = 0;
+        float maxLatency = 0;
+        /** Average time spent rendering a glyph. */
+        float averageRasterizationTime = 0;
+    };
+
     static FontFreeType* create(const std::string &fontName, float fontSize, GlyphCollection glyphs,
         const char *customGlyphs,bool distanceFieldEnabled = false, float outline = 0);
 
     static void shutdownFreeType();
 
+    /** Sets where the glyphs of dynamic atlases are rendered, ASYNC by default.
+     * A text needing fewer than ASYNC_GLYPH_MIN_COUNT new glyphs is always rendered on the cocos thread.
+     * @since v4.0
+     */
+    static void setRasterizationMode(RasterizationMode mode) { _rasterizationMode = mode; }
+    static RasterizationMode getRasterizationMode() { return _rasterizationMode; }
+    static const size_t ASYNC_GLYPH_MIN_COUNT;
+
+    /** Returns the statistics of the worker threads rendering. Must be called on the cocos2d thread.
+     * @since v4.0
+     */
+    static const RasterizationStats& getRasterizationStats() { return _rasterizationStats; }
+    static void resetRasterizationStats();
+
     bool isDistanceFieldEnabled() const { return _distanceFieldEnabled;}
 
     float getOutlineSize() const { return _outlineSize; }
@@ -60,6 +121,28 @@ public:
     int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
     
     unsigned char* getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Renders glyph.code on the cocos thread. */
+    void rasterizeGlyph(RasterizedGlyph& glyph);
+
+    /** Renders the glyphs on the worker threads and waits for them. */
+    void rasterizeGlyphs(std::vector<RasterizedGlyph>& glyphs);
+
+    /** Queues the glyphs for the worker threads, they are returned by takeRasterizedGlyphs() once rendered.
+     * Returns false and leaves glyphs untouched when there are no worker threads.
+     */
+    bool rasterizeGlyphsAsync(std::vector<RasterizedGlyph>& glyphs);
+
+    /** Moves the glyphs rendered since the last call to glyphs. */
+    void takeRasterizedGlyphs(std::vector<RasterizedGlyph>& glyphs);
+
+    /** Drops the queued glyphs, those being rendered are thrown away once done. */
+    void cancelAsyncGlyphs();
+
+    bool hasPendingGlyphs() const;
+
+    /** Returns the advance of a glyph without rendering it, for laying out a glyph still being rendered. */
+    int getGlyphAdvance(uint64_t theChar) const;
     
     int getFontAscender() const;
     const char* getFontFamily() const;
@@ -75,6 +158,8 @@ private:
     static const char* _glyphNEHE;
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
+    static RasterizationMode _rasterizationMode;
+    static RasterizationStats _rasterizationStats;
 
     FontFreeType(bool distanceFieldEnabled = false, float outline = 0);
     virtual ~FontFreeType();
@@ -87,6 +172,9 @@ private:
     int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
     unsigned char* getGlyphBitmapWithOutline(uint64_t code, FT_BBox &bbox);
 
+    GlyphRasterizer* getGlyphRasterizer();
+    static void recordRasterizedGlyph(const RasterizedGlyph& glyph);
+
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
     const char* getGlyphCollection() const;
     
@@ -98,7 +186,9 @@ private:
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
+    int _charSize;
     FontAtlas* _fontAtlas;
+    std::shared_ptr<GlyphRasterizer> _glyphRasterizer;
 
     GlyphCollection _usedGlyphs;
     std::string _customGlyphs;
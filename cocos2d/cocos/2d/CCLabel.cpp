@@ -472,6 +472,14 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 3);
 }
 
 Label::~Label()
@@ -488,6 +496,7 @@ Label::~Label()
     _batchCommands.clear();
     _eventDispatcher->removeEventListener(_purgeTextureListener);
     _eventDispatcher->removeEventListener(_resetTextureListener);
+    _eventDispatcher->removeEventListener(_updateTextureListener);
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
@@ -992,13 +1001,21 @@ bool Label::alignText()
         _lengthOfString = 0;
         _textDesiredHeight = 0.f;
         _linesWidth.clear();
-        if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+        if (_cachedLayout)
         {
-            multilineTextWrapByWord();
+            applyCachedLayout();
         }
         else
         {
-            multilineTextWrapByChar();
+            if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+            {
+                multilineTextWrapByWord();
+            }
+            else
+            {
+                multilineTextWrapByChar();
+            }
+            storeCachedLayout();
         }
         computeAlignmentOffset();
 
@@ -1513,14 +1530,21 @@ void Label::updateContent()
 
     if (_fontAtlas)
     {
-        std::u32string utf32String;
-        if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
+        // the kernings are only needed to wrap the text, which a cached layout already did
+        if (!findCachedLayout())
         {
-            _utf32Text = utf32String;
-        }
+            std::u32string utf32String;
+            if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
+            {
+                _utf32Text = utf32String;
+            }
 
-        computeHorizontalKernings(_utf32Text);
+            computeHorizontalKernings(_utf32Text);
+        }
         updateFinished = alignText();
+
+        _cachedLayout = nullptr;
+        _layoutCacheKey.clear();
     }
     else
     {
@@ -1787,6 +1811,7 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
                 if (!textureAtlas->getTotalQuads())
                     return;
 
+                _fontAtlas->touchPage(i);
                 auto &batch = _batchCommands[i++];
                 auto &&commands = batch.getCommandArray();
                 for (auto command : commands)
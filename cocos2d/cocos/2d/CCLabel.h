@@ -585,6 +585,34 @@ public:
      */
     float getAdditionalKerning() const;
 
+    /** Counters of the layout cache shared by the labels, see setLayoutCacheCapacity. */
+    struct LayoutCacheStats
+    {
+        size_t entries = 0;
+        size_t capacity = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        /** hits / (hits + misses), 0 when nothing was looked up yet. */
+        float hitRate = 0.f;
+    };
+
+    /**
+     * Sets how many text layouts the labels keep, 256 by default, 0 disables the cache.
+     * A layout holds the line breaks and glyph positions of a text for a font atlas and the
+     * wrapping properties of a label, any label laying out the same text in the same way
+     * reuses it instead of wrapping the text again. The least recently used layout is
+     * dropped when the cache is full.
+     * @warning Not support system font.
+     */
+    static void setLayoutCacheCapacity(size_t capacity);
+    static size_t getLayoutCacheCapacity();
+
+    static LayoutCacheStats getLayoutCacheStats();
+    static void resetLayoutCacheStats();
+
+    /** Drops every cached layout, the counters are kept. */
+    static void purgeLayoutCache();
+
     /**
     * set ProgramState of current render command
     */
@@ -678,6 +706,15 @@ protected:
     void computeAlignmentOffset();
     bool computeHorizontalKernings(const std::u32string& stringToRender);
 
+    struct LayoutCacheEntry;
+    class LayoutCache;
+    /** Builds the layout cache key of the text and the wrapping properties, returns false if the layout can't be cached. */
+    bool getLayoutCacheKey(std::string& key);
+    /** Looks the text up in the layout cache and takes its converted text on a hit, the key is kept for storeCachedLayout on a miss. */
+    bool findCachedLayout();
+    void applyCachedLayout();
+    void storeCachedLayout();
+
     void recordLetterInfo(const cocos2d::Vec2& point, char32_t utf32Char, int letterIndex, int lineIndex);
     void recordPlaceholderInfo(int letterIndex, char32_t utf16Char);
     
@@ -730,6 +767,10 @@ protected:
     FontAtlas* _fontAtlas;
     Vector<SpriteBatchNode*> _batchNodes;
     std::vector<LetterInfo> _lettersInfo;
+    // key of the layout being built, empty when it can't be cached
+    std::string _layoutCacheKey;
+    // the cached layout used by the layout being built
+    std::shared_ptr<const LayoutCacheEntry> _cachedLayout;
 
     //! used for optimization
     Sprite *_reusedLetter;
@@ -794,6 +835,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -26,6 +26,9 @@
 
 #include "2d/CCLabel.h"
 #include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "2d/CCFontAtlas.h"
@@ -436,4 +439,220 @@ void Label::recordPlaceholderInfo(int letterIndex, char32_t utf32Char)
     _lettersInfo[letterIndex].valid = false;
 }
 
+struct Label::LayoutCacheEntry
+{
+    std::u32string utf32Text;
+    std::vector<LetterInfo> lettersInfo;
+    std::vector<float> linesWidth;
+    Size contentSize;
+    int numberOfLines;
+    float textDesiredHeight;
+    float tailoredTopY;
+    float tailoredBottomY;
+};
+
+class Label::LayoutCache
+{
+public:
+    static LayoutCache* getInstance()
+    {
+        static LayoutCache s_layoutCache;
+        return &s_layoutCache;
+    }
+
+    std::shared_ptr<const LayoutCacheEntry> find(const std::string& key)
+    {
+        auto it = _index.find(key);
+        if (it == _index.end())
+        {
+            ++_misses;
+            return nullptr;
+        }
+
+        ++_hits;
+        // move the entry to the front, the back is dropped first
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return it->second->second;
+    }
+
+    void add(const std::string& key, std::shared_ptr<const LayoutCacheEntry> entry)
+    {
+        if (_capacity == 0)
+            return;
+
+        auto it = _index.find(key);
+        if (it != _index.end())
+        {
+            it->second->second = entry;
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return;
+        }
+
+        _entries.emplace_front(key, std::move(entry));
+        _index[key] = _entries.begin();
+        trim();
+    }
+
+    void setCapacity(size_t capacity)
+    {
+        _capacity = capacity;
+        trim();
+    }
+
+    size_t getCapacity() const { return _capacity; }
+
+    void clear()
+    {
+        _index.clear();
+        _entries.clear();
+    }
+
+    LayoutCacheStats getStats() const
+    {
+        LayoutCacheStats stats;
+        stats.entries = _entries.size();
+        stats.capacity = _capacity;
+        stats.hits = _hits;
+        stats.misses = _misses;
+        if (_hits + _misses > 0)
+            stats.hitRate = (float)((double)_hits / (double)(_hits + _misses));
+        return stats;
+    }
+
+    void resetStats()
+    {
+        _hits = 0;
+        _misses = 0;
+    }
+
+private:
+    void trim()
+    {
+        while (_entries.size() > _capacity)
+        {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+    }
+
+    typedef std::list<std::pair<std::string, std::shared_ptr<const LayoutCacheEntry>>> EntryList;
+
+    // the most recently used entry first
+    EntryList _entries;
+    std::unordered_map<std::string, EntryList::iterator> _index;
+    size_t _capacity = 256;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+};
+
+void Label::setLayoutCacheCapacity(size_t capacity)
+{
+    LayoutCache::getInstance()->setCapacity(capacity);
+}
+
+size_t Label::getLayoutCacheCapacity()
+{
+    return LayoutCache::getInstance()->getCapacity();
+}
+
+Label::LayoutCacheStats Label::getLayoutCacheStats()
+{
+    return LayoutCache::getInstance()->getStats();
+}
+
+void Label::resetLayoutCacheStats()
+{
+    LayoutCache::getInstance()->resetStats();
+}
+
+void Label::purgeLayoutCache()
+{
+    LayoutCache::getInstance()->clear();
+}
+
+template<typename T>
+static void appendLayoutKeyValue(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool Label::getLayoutCacheKey(std::string& key)
+{
+    key.clear();
+    // shrinking rescales the letter definitions while wrapping, its layouts aren't cached
+    if (_fontAtlas == nullptr || _overflow == Overflow::SHRINK || _utf8Text.empty()
+        || LayoutCache::getInstance()->getCapacity() == 0)
+    {
+        return false;
+    }
+
+    updateBMFontScale();
+
+    key.reserve(64 + _utf8Text.size());
+    appendLayoutKeyValue(key, _fontAtlas->_id);
+    appendLayoutKeyValue(key, _bmfontScale);
+    appendLayoutKeyValue(key, CC_CONTENT_SCALE_FACTOR());
+    appendLayoutKeyValue(key, _maxLineWidth);
+    appendLayoutKeyValue(key, _labelWidth);
+    appendLayoutKeyValue(key, _labelHeight);
+    appendLayoutKeyValue(key, _lineHeight);
+    appendLayoutKeyValue(key, _lineSpacing);
+    appendLayoutKeyValue(key, _additionalKerning);
+    appendLayoutKeyValue(key, _enableWrap);
+    appendLayoutKeyValue(key, _lineBreakWithoutSpaces);
+    key.append(_utf8Text);
+    return true;
+}
+
+bool Label::findCachedLayout()
+{
+    if (getLayoutCacheKey(_layoutCacheKey))
+    {
+        _cachedLayout = LayoutCache::getInstance()->find(_layoutCacheKey);
+    }
+    if (!_cachedLayout)
+        return false;
+
+    _utf32Text = _cachedLayout->utf32Text;
+    return true;
+}
+
+void Label::applyCachedLayout()
+{
+    auto& layout = *_cachedLayout;
+
+    _lengthOfString = static_cast<int>(layout.utf32Text.length());
+    if (_lettersInfo.size() < layout.lettersInfo.size())
+    {
+        _lettersInfo.resize(layout.lettersInfo.size());
+    }
+    std::copy(layout.lettersInfo.begin(), layout.lettersInfo.end(), _lettersInfo.begin());
+
+    _linesWidth = layout.linesWidth;
+    _numberOfLines = layout.numberOfLines;
+    _textDesiredHeight = layout.textDesiredHeight;
+    setContentSize(layout.contentSize);
+    _tailoredTopY = layout.tailoredTopY;
+    _tailoredBottomY = layout.tailoredBottomY;
+}
+
+void Label::storeCachedLayout()
+{
+    // the placeholders of glyphs still being rendered have no size yet, the layout will change once they are done
+    if (_layoutCacheKey.empty() || _fontAtlas->_asyncGlyphsScheduled)
+        return;
+
+    auto entry = std::make_shared<LayoutCacheEntry>();
+    entry->utf32Text = _utf32Text;
+    entry->lettersInfo.assign(_lettersInfo.begin(), _lettersInfo.begin() + std::min(static_cast<size_t>(_lengthOfString), _lettersInfo.size()));
+    entry->linesWidth = _linesWidth;
+    entry->contentSize = _contentSize;
+    entry->numberOfLines = _numberOfLines;
+    entry->textDesiredHeight = _textDesiredHeight;
+    entry->tailoredTopY = _tailoredTopY;
+    entry->tailoredBottomY = _tailoredBottomY;
+
+    LayoutCache::getInstance()->add(_layoutCacheKey, std::move(entry));
+}
+
 NS_CC_END
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCWorkerPool.h"
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
@@ -56,6 +57,8 @@ NS_CC_BEGIN
 
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
+std::uint32_t Node::s_transformPass = 0;
+Node::SortStatistics Node::s_sortStatistics;
 int Node::__attachedNodeCount = 0;
 
 // MARK: Constructor, Destructor, Init
@@ -81,6 +84,14 @@ Node::Node()
 , _additionalTransform(nullptr)
 , _additionalTransformDirty(false)
 , _transformUpdated(true)
+, _transformPass(0)
+, _transformPassParent(nullptr)
+, _transformPassParentFlags(0)
+, _transformPassDirtyFlags(0)
+, _transformRecomputedPass(0)
+, _transformVersion(0)
+, _parallelTransformSafe(true)
+, _serialTransformDescendants(0)
 // children (lazy allocs)
 // lazy alloc
 , _localZOrder$Arrival(0LL)
@@ -654,6 +665,16 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    // the ancestors count the nodes they can't split across workers
+    std::uint32_t serialNodes = _serialTransformDescendants + (_parallelTransformSafe ? 0 : 1);
+    if (serialNodes > 0)
+    {
+        for (auto node = _parent; node; node = node->_parent)
+            node->_serialTransformDescendants -= serialNodes;
+        for (auto node = parent; node; node = node->_parent)
+            node->_serialTransformDescendants += serialNodes;
+    }
+
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
 }
@@ -941,6 +962,9 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
     
     this->insertChild(child, localZOrder);
     
+    // The child's subtree moved in the scene graph, its listeners need new priorities
+    _eventDispatcher->setDirtyForNode(child);
+    
     if (setTag)
         child->setTag(tag);
     else
@@ -1077,6 +1101,7 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
         // set parent nil at the end
         child->setParent(nullptr);
+        _eventDispatcher->setDirtyForNode(child);
     }
     
     _children.clear();
@@ -1109,6 +1134,7 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     // set parent nil at the end
     child->setParent(nullptr);
+    _eventDispatcher->setDirtyForNode(child);
 
     _children.erase(childIndex);
 }
@@ -1136,6 +1162,7 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1144,7 +1171,6 @@ void Node::sortAllChildren()
     {
         sortNodes(_children);
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
     }
 }
 
@@ -1167,7 +1193,7 @@ void Node::visit()
     visit(renderer, parentTransform, FLAGS_TRANSFORM_DIRTY);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::updateNormalizedPosition(uint32_t parentFlags)
 {
     if(_usingNormalizedPosition)
     {
@@ -1181,6 +1207,11 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _normalizedPositionDirty = false;
         }
     }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    updateNormalizedPosition(parentFlags);
 
     // Fixes Github issue #16100. Basically when having two cameras, one camera might set as dirty the
     // node that is not visited by it, and might affect certain calculations. Besides, it is faster to do this.
@@ -1191,9 +1222,25 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
     flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
     
+    bool prepared = false;
+    if (_transformPass != 0)
+    {
+        // updateTransformTree consumed the dirty flags, draw still needs them
+        flags |= _transformPassDirtyFlags;
 
-    if(flags & FLAGS_DIRTY_MASK)
+        // Reuse its transform unless this node or the transform it was computed from changed since
+        bool parentRecomputed = _parent && &parentTransform == &_parent->_modelViewTransform
+            && _parent->_transformRecomputedPass == s_transformPass;
+        prepared = _transformPass == s_transformPass && !_transformUpdated && !parentRecomputed
+            && &parentTransform == _transformPassParent && parentFlags == _transformPassParentFlags;
+        _transformPass = 0;
+    }
+
+    if((flags & FLAGS_DIRTY_MASK) && !prepared)
+    {
         _modelViewTransform = this->transform(parentTransform);
+        _transformRecomputedPass = s_transformPass;
+    }
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1201,6 +1248,88 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     return flags;
 }
 
+void Node::updateTransformTree(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (++s_transformPass == 0)
+    {
+        ++s_transformPass;
+    }
+    prepareTransform(parentTransform, parentFlags);
+}
+
+void Node::setParallelTransformSafe(bool safe)
+{
+    if (safe == _parallelTransformSafe)
+        return;
+
+    _parallelTransformSafe = safe;
+    for (auto node = _parent; node; node = node->_parent)
+    {
+        if (safe)
+            --node->_serialTransformDescendants;
+        else
+            ++node->_serialTransformDescendants;
+    }
+}
+
+void Node::prepareTransform(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // Same rules as visit and processParentFlags, but without emitting anything
+    if (!_visible)
+    {
+        return;
+    }
+
+    updateNormalizedPosition(parentFlags);
+
+    uint32_t flags = parentFlags;
+    if (isVisitableByVisitingCamera())
+    {
+        uint32_t dirtyFlags = (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0) | (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
+        if (_transformPass != 0)
+        {
+            // Not visited since the previous pass, keep its flags for draw
+            dirtyFlags |= _transformPassDirtyFlags;
+        }
+        flags |= dirtyFlags;
+
+        if (flags & FLAGS_DIRTY_MASK)
+            _modelViewTransform = this->transform(parentTransform);
+
+        _transformUpdated = false;
+        _contentSizeDirty = false;
+        _transformPass = s_transformPass;
+        _transformPassParent = &parentTransform;
+        _transformPassParentFlags = parentFlags;
+        _transformPassDirtyFlags = dirtyFlags;
+    }
+
+    // Split large children arrays across the workers, subtrees are independent unless a node below shares
+    // state with other nodes while computing its transform
+    static const size_t PARALLEL_CHILDREN_THRESHOLD = 256;
+    static const size_t PARALLEL_CHILDREN_GRAIN = 64;
+
+    size_t childrenCount = static_cast<size_t>(_children.size());
+    if (childrenCount >= PARALLEL_CHILDREN_THRESHOLD && _serialTransformDescendants == 0)
+    {
+        WorkerPool::getInstance()->parallelFor(childrenCount, PARALLEL_CHILDREN_GRAIN, [this, flags](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (auto child = _children.at(i))
+                    child->prepareTransform(_modelViewTransform, flags);
+            }
+        });
+    }
+    else
+    {
+        for (const auto& child : _children)
+        {
+            if (child)
+                child->prepareTransform(_modelViewTransform, flags);
+        }
+    }
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -1263,6 +1392,8 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
 Mat4 Node::transform(const Mat4& parentTransform)
 {
+    // every visit path recomputing the model view transform goes through here
+    ++_transformVersion;
     return parentTransform * this->getNodeToParentTransform();
 }
 
@@ -1424,6 +1555,13 @@ Action * Node::runAction(Action* action)
     return action;
 }
 
+Action * Node::runTween(Action* action)
+{
+    CCASSERT( action != nullptr, "Argument must be non-nil");
+    _actionManager->addTween(action, this, !_running);
+    return action;
+}
+
 void Node::stopAllActions()
 {
     _actionManager->removeAllActionsFromTarget(this);
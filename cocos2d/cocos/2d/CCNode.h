@@ -920,23 +920,102 @@ public:
      */
     virtual void sortAllChildren();
 
+    /** Counters of sortNodes calls by the path they took, the last three avoid a full sort. */
+    struct SortStatistics
+    {
+        unsigned int fullSorts = 0;         ///< many nodes moved, the whole array was sorted
+        unsigned int insertionSorts = 0;    ///< small array sorted by insertion
+        unsigned int mergedSorts = 0;       ///< only the moved nodes were sorted and merged back
+        unsigned int skippedSorts = 0;      ///< the array was already in order
+    };
+
+    /** Gets the counters of sortNodes calls since the last reset. */
+    static const SortStatistics& getSortStatistics() { return s_sortStatistics; }
+
+    /** Resets the counters of sortNodes calls. */
+    static void resetSortStatistics() { s_sortStatistics = SortStatistics(); }
+
     /**
     * Sorts helper function
     *
+    * Arrays are usually sorted except for the few nodes added or reordered since the last sort.
+    * Those are pulled out in one pass, sorted on their own and merged back in linear time.
+    * Small arrays use an insertion sort, and a full sort is only done when many nodes moved.
     */
     template<typename _T> inline
     static void sortNodes(cocos2d::Vector<_T*>& nodes)
     {
         static_assert(std::is_base_of<Node, _T>::value, "Node::sortNodes: Only accept derived of Node!");
 #if CC_64BITS
-        std::sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
+        auto less = [](_T* n1, _T* n2) {
             return (n1->_localZOrder$Arrival < n2->_localZOrder$Arrival);
-        });
+        };
 #else
-        std::sort(std::begin(nodes), std::end(nodes), [](_T* n1, _T* n2) {
+        auto less = [](_T* n1, _T* n2) {
             return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) || n1->_localZOrder < n2->_localZOrder;
-        });
+        };
 #endif
+        auto first = std::begin(nodes);
+        auto last = std::end(nodes);
+        const ssize_t count = nodes.size();
+
+        if (count <= SMALL_SORT_SIZE)
+        {
+            for (auto it = first; it != last; ++it)
+            {
+                _T* node = *it;
+                auto hole = it;
+                for (; hole != first && less(node, *(hole - 1)); --hole)
+                    *hole = *(hole - 1);
+                *hole = node;
+            }
+            ++s_sortStatistics.insertionSorts;
+            return;
+        }
+
+        // Compact the nodes still in order at the front, collect the moved ones
+        std::vector<_T*> moved;
+        auto kept = first;
+        for (auto it = first; it != last; ++it)
+        {
+            _T* node = *it;
+            if (kept == first || !less(node, *(kept - 1)))
+            {
+                *kept++ = node;
+                continue;
+            }
+
+            // Either this node moved down, or the previous one moved up
+            if (kept - first >= 2 && !less(node, *(kept - 2)))
+            {
+                moved.push_back(*(kept - 1));
+                *(kept - 1) = node;
+            }
+            else
+            {
+                moved.push_back(node);
+            }
+
+            if (static_cast<ssize_t>(moved.size()) * MOVED_NODES_RATIO > count)
+            {
+                // The moved nodes exactly fill the gap up to the current one
+                std::copy(moved.begin(), moved.end(), kept);
+                std::sort(first, last, less);
+                ++s_sortStatistics.fullSorts;
+                return;
+            }
+        }
+
+        if (moved.empty())
+        {
+            ++s_sortStatistics.skippedSorts;
+            return;
+        }
+
+        std::sort(moved.begin(), moved.end(), less);
+        std::copy(moved.begin(), moved.end(), kept);
+        std::inplace_merge(first, kept, last, less);
+        ++s_sortStatistics.mergedSorts;
     }
 
     /// @} end of Children and Parent
@@ -1122,6 +1201,30 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Updates the model view transforms of this node and its visible descendants ahead of visit.
+     *
+     * Children arrays with many nodes are split across WorkerPool threads. visit() then reuses the
+     * transforms, or recomputes them if a node or its parent changed in between, so the result is the
+     * same as visiting alone. Scene calls it when Director::setParallelTransformEnabled() is on.
+     *
+     * @param parentTransform The transform matrix visit will be called with.
+     * @param parentFlags The renderer flags visit will be called with.
+     */
+    void updateTransformTree(const Mat4& parentTransform, uint32_t parentFlags);
+
+    /**
+     * Sets whether the transform of this node may be computed on a WorkerPool thread, next to its siblings.
+     *
+     * A node whose getNodeToParentTransform() writes state shared with other nodes, like a bone chain, must
+     * turn it off. updateTransformTree() then walks every children array above it serially.
+     * On by default.
+     */
+    void setParallelTransformSafe(bool safe);
+
+    /** Whether the transform of this node may be computed on a WorkerPool thread. */
+    bool isParallelTransformSafe() const { return _parallelTransformSafe; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1178,6 +1281,20 @@ public:
      */
     virtual Action* runAction(Action* action);
 
+    /**
+     * Executes an action as a packed tween when it is supported, and returns the action.
+     *
+     * MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn and FadeOut, optionally
+     * wrapped in an ActionEase, are much cheaper to run this way when thousands of them are active.
+     * The action object isn't kept for those, so getActionByTag() won't find it. Other actions
+     * behave exactly like runAction().
+     *
+     * @param action An Action pointer.
+     * @see ActionManager::addTween()
+     * @since v4.0
+     */
+    virtual Action* runTween(Action* action);
+
     /**
      * Stops and removes all actions from the running action list .
      */
@@ -1792,6 +1909,8 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    void prepareTransform(const Mat4& parentTransform, uint32_t parentFlags);
+    void updateNormalizedPosition(uint32_t parentFlags);
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -1854,6 +1973,17 @@ protected:
     mutable bool _additionalTransformDirty; ///< transform dirty ?
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
 
+    std::uint32_t _transformPass;             ///< updateTransformTree pass that computed _modelViewTransform, 0 once visited
+    const Mat4* _transformPassParent;         ///< parent transform used by that pass
+    std::uint32_t _transformPassParentFlags;  ///< parent flags used by that pass
+    std::uint32_t _transformPassDirtyFlags;   ///< own dirty flags consumed by that pass
+    std::uint32_t _transformRecomputedPass;   ///< pass during which visit had to recompute _modelViewTransform
+    std::uint32_t _transformVersion;          ///< incremented each time the transform is recomputed, caches of world bounds compare it
+    bool _parallelTransformSafe;              ///< whether the transform may be computed next to the siblings
+    std::uint32_t _serialTransformDescendants; ///< descendants whose transform isn't parallel safe
+
+    static std::uint32_t s_transformPass;
+
 #if CC_LITTLE_ENDIAN
     union {
         struct {
@@ -1876,6 +2006,10 @@ protected:
 
     static std::uint32_t s_globalOrderOfArrival;
 
+    static const ssize_t SMALL_SORT_SIZE = 16;   ///< arrays up to this size are insertion sorted
+    static const ssize_t MOVED_NODES_RATIO = 8;  ///< full sort once more than 1/8 of the nodes moved
+    static SortStatistics s_sortStatistics;
+
     Vector<Node*> _children;        ///< array of children nodes
     Node *_parent;                  ///< weak reference to parent node
     Director* _director;            //cached director pointer to improve rendering performance
@@ -1950,6 +2084,8 @@ public:
     static int __attachedNodeCount;
     
 private:
+    friend class EventDispatcher;
+    friend class TouchHitGrid;
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
 
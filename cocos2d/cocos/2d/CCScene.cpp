@@ -207,6 +207,10 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
         //clear background with max depth
         camera->clearBackground();
         //visit the scene
+        if (director->isParallelTransformEnabled())
+        {
+            updateTransformTree(transform, 0);
+        }
         visit(renderer, transform, 0);
 #if CC_USE_NAVMESH
         if (_navMesh && _navMeshDebugCamera == camera)
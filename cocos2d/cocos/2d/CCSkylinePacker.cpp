@@ -0,0 +1,173 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCSkylinePacker.h"
+
+#include <algorithm>
+#include <climits>
+
+NS_CC_BEGIN
+
+SkylinePacker::SkylinePacker()
+{
+}
+
+void SkylinePacker::reset(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _skyline.clear();
+    if (width > 0)
+    {
+        _skyline.push_back({0, 0, width});
+    }
+}
+
+void SkylinePacker::grow(int width, int height)
+{
+    if (width > _width)
+    {
+        if (!_skyline.empty() && _skyline.back().y == 0)
+        {
+            _skyline.back().width += width - _width;
+        }
+        else
+        {
+            _skyline.push_back({_width, 0, width - _width});
+        }
+        _width = width;
+    }
+    _height = std::max(_height, height);
+}
+
+int SkylinePacker::findY(size_t index, int width, int height) const
+{
+    if (_skyline[index].x + width > _width)
+    {
+        return -1;
+    }
+
+    int y = _skyline[index].y;
+    int widthLeft = width;
+    for (size_t i = index; widthLeft > 0; ++i)
+    {
+        y = std::max(y, _skyline[i].y);
+        if (y + height > _height)
+        {
+            return -1;
+        }
+        widthLeft -= _skyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int width, int height, int& x, int& y)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    size_t bestIndex = _skyline.size();
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestY = 0;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int segmentY = findY(i, width, height);
+        if (segmentY < 0)
+        {
+            continue;
+        }
+        // lowest top first, the narrowest segment wastes the least space on ties
+        int top = segmentY + height;
+        if (top < bestTop || (top == bestTop && _skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top;
+            bestWidth = _skyline[i].width;
+            bestY = segmentY;
+        }
+    }
+
+    if (bestIndex == _skyline.size())
+    {
+        return false;
+    }
+
+    x = _skyline[bestIndex].x;
+    y = bestY;
+    addSegment(bestIndex, x, bestTop, width);
+    return true;
+}
+
+void SkylinePacker::addSegment(size_t index, int x, int y, int width)
+{
+    _skyline.insert(_skyline.begin() + index, {x, y, width});
+
+    // the segments under the new one are cut away
+    int right = x + width;
+    size_t next = index + 1;
+    while (next < _skyline.size() && _skyline[next].x < right)
+    {
+        auto& segment = _skyline[next];
+        int shrink = right - segment.x;
+        if (segment.width <= shrink)
+        {
+            _skyline.erase(_skyline.begin() + next);
+        }
+        else
+        {
+            segment.x += shrink;
+            segment.width -= shrink;
+            break;
+        }
+    }
+
+    for (size_t i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+int SkylinePacker::getUsedHeight() const
+{
+    int height = 0;
+    for (const auto& segment : _skyline)
+    {
+        height = std::max(height, segment.y);
+    }
+    return height;
+}
+
+NS_CC_END
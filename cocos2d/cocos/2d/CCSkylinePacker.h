@@ -0,0 +1,87 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef _CCSkylinePacker_h_
+#define _CCSkylinePacker_h_
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * Packs rectangles into a bin with the skyline bottom-left heuristic.
+ * The bin keeps the top edge of the placed rectangles as a list of horizontal segments,
+ * each rectangle is placed where its top ends up lowest, so bins of mixed heights stay dense.
+ * The bin can grow afterwards without moving the rectangles already placed.
+ */
+class CC_DLL SkylinePacker
+{
+public:
+    SkylinePacker();
+
+    /** Removes all the rectangles and sets the size of the bin. */
+    void reset(int width, int height);
+
+    /** Grows the bin, the rectangles already placed keep their positions. Shrinking is ignored. */
+    void grow(int width, int height);
+
+    /**
+     * Finds a place for a rectangle and reserves it.
+     * @return false if the rectangle doesn't fit, x and y are left untouched then.
+     */
+    bool insert(int width, int height, int& x, int& y);
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+    /** Returns the height of the highest rectangle placed, zero for an empty bin. */
+    int getUsedHeight() const;
+
+protected:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    /** Returns the y a rectangle starting at segment index would rest on, or -1 if it doesn't fit there. */
+    int findY(size_t index, int width, int height) const;
+
+    void addSegment(size_t index, int x, int y, int width);
+
+    std::vector<Segment> _skyline;
+    int _width = 0;
+    int _height = 0;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif /* _CCSkylinePacker_h_ */
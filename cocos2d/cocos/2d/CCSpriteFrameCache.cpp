@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "2d/SpriteSheetBinary_generated.h"
 
 using namespace std;
 
@@ -51,6 +52,84 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+static bool isBinarySpriteSheetFile(const std::string& file)
+{
+    return FileUtils::getInstance()->getFileExtension(file) == ".ccss";
+}
+
+// Returns the sheet if data holds a valid binary sprite sheet, it points into data
+static const spritesheet::SpriteSheet* getBinarySpriteSheet(const Data& data)
+{
+    if (data.getSize() < 8 || !spritesheet::SpriteSheetBufferHasIdentifier(data.getBytes()))
+        return nullptr;
+
+    flatbuffers::Verifier verifier(data.getBytes(), data.getSize());
+    if (!spritesheet::VerifySpriteSheetBuffer(verifier))
+        return nullptr;
+
+    return spritesheet::GetSpriteSheet(data.getBytes());
+}
+
+// The texture named by the sheet, relative to the sheet file, or the sheet file with a .png extension
+static std::string getSheetTexturePath(const std::string& textureFileName, const std::string& sheetFile)
+{
+    if (!textureFileName.empty())
+    {
+        // build texture path relative to plist file
+        return FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, sheetFile);
+    }
+
+    // build texture path by replacing file extension
+    std::string texturePath = sheetFile;
+
+    // remove .xxx
+    size_t startPos = texturePath.find_last_of('.');
+    if(startPos != string::npos)
+    {
+        texturePath = texturePath.erase(startPos);
+    }
+
+    // append .png
+    texturePath = texturePath.append(".png");
+
+    CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    return texturePath;
+}
+
+static Texture2D* addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
+    Texture2D *texture = nullptr;
+    static std::unordered_map<std::string, backend::PixelFormat> pixelFormats = {
+        {"RGBA8888", backend::PixelFormat::RGBA8888},
+        {"RGBA4444", backend::PixelFormat::RGBA4444},
+        {"RGB5A1", backend::PixelFormat::RGB5A1},
+        {"RGBA5551", backend::PixelFormat::RGB5A1},
+        {"RGB565", backend::PixelFormat::RGB565},
+        {"A8", backend::PixelFormat::A8},
+        {"ALPHA", backend::PixelFormat::A8},
+        {"I8", backend::PixelFormat::I8},
+        {"AI88", backend::PixelFormat::AI88},
+        {"ALPHA_INTENSITY", backend::PixelFormat::AI88},
+        //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+        {"RGB888", backend::PixelFormat::RGB888}
+    };
+
+    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+    if (pixelFormatIt != pixelFormats.end())
+    {
+        const backend::PixelFormat pixelFormat = (*pixelFormatIt).second;
+        const backend::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+    }
+    else
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+    }
+    return texture;
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -287,35 +366,7 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, backend::PixelFormat> pixelFormats = {
-        {"RGBA8888", backend::PixelFormat::RGBA8888},
-        {"RGBA4444", backend::PixelFormat::RGBA4444},
-        {"RGB5A1", backend::PixelFormat::RGB5A1},
-        {"RGBA5551", backend::PixelFormat::RGB5A1},
-        {"RGB565", backend::PixelFormat::RGB565},
-        {"A8", backend::PixelFormat::A8},
-        {"ALPHA", backend::PixelFormat::A8},
-        {"I8", backend::PixelFormat::I8},
-        {"AI88", backend::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", backend::PixelFormat::AI88},
-        //{"BGRA8888", backend::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", backend::PixelFormat::RGB888}
-    };
-
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
-    {
-        const backend::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const backend::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
-    }
-    else
-    {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-    }
+    Texture2D *texture = addSheetTexture(texturePath, pixelFormatName);
     
     if (texture)
     {
@@ -329,6 +380,12 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
+    if (isBinarySpriteSheetFile(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, texture, "");
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
@@ -344,6 +401,12 @@ void SpriteFrameCache::addSpriteFramesWithFileContent(const std::string& plist_c
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const std::string& textureFileName)
 {
     CCASSERT(textureFileName.size()>0, "texture name should not be null");
+    if (isBinarySpriteSheetFile(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, nullptr, textureFileName);
+        return;
+    }
+
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     addSpriteFramesWithDictionary(dict, textureFileName, plist);
@@ -361,39 +424,24 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
         return;
     }
 
+    if (isBinarySpriteSheetFile(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, nullptr, "");
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
-    string texturePath("");
+    string textureFileName("");
 
     if (dict.find("metadata") != dict.end())
     {
         ValueMap& metadataDict = dict["metadata"].asValueMap();
         // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
+        textureFileName = metadataDict["textureFileName"].asString();
     }
 
-    if (!texturePath.empty())
-    {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
-    }
-    else
-    {
-        // build texture path by replacing file extension
-        texturePath = plist;
-
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.'); 
-        if(startPos != string::npos)
-        {
-            texturePath = texturePath.erase(startPos);
-        }
-
-        // append .png
-        texturePath = texturePath.append(".png");
-
-        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
-    }
+    std::string texturePath = getSheetTexturePath(textureFileName, plist);
     addSpriteFramesWithDictionary(dict, texturePath, plist);
 }
 
@@ -460,6 +508,32 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteSheetFile(plist))
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        auto sheet = getBinarySpriteSheet(data);
+        if (!sheet)
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: %s isn't a binary sprite sheet.", plist.c_str());
+            return;
+        }
+
+        std::vector<std::string> keysToRemove;
+        if (sheet->frames())
+        {
+            for (auto frameData : *sheet->frames())
+            {
+                if (frameData->name() && _spriteFramesCache.at(frameData->name()->c_str()))
+                {
+                    keysToRemove.push_back(frameData->name()->c_str());
+                }
+            }
+        }
+        _spriteFramesCache.eraseFrames(keysToRemove);
+        _spriteFramesCache.erasePlistIndex(plist);
+        return;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
     {
@@ -666,37 +740,45 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+
+    if (isBinarySpriteSheetFile(plist))
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        auto sheet = getBinarySpriteSheet(data);
+        if (!sheet)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s isn't a binary sprite sheet", plist.c_str());
+            return true;
+        }
+
+        std::string texturePath = getSheetTexturePath(sheet->textureFileName() ? sheet->textureFileName()->c_str() : "", plist);
+        Texture2D *texture = nullptr;
+        if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
+            texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
+
+        if (texture)
+        {
+            addSpriteFramesWithBinary(sheet, texture, plist, true);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        return true;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
-    string texturePath("");
+    string textureFileName("");
 
     if (dict.find("metadata") != dict.end())
     {
         ValueMap& metadataDict = dict["metadata"].asValueMap();
         // try to read  texture file name from meta data
-        texturePath = metadataDict["textureFileName"].asString();
+        textureFileName = metadataDict["textureFileName"].asString();
     }
 
-    if (!texturePath.empty())
-    {
-        // build texture path relative to plist file
-        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
-    }
-    else
-    {
-        // build texture path by replacing file extension
-        texturePath = plist;
-
-        // remove .xxx
-        size_t startPos = texturePath.find_last_of('.');
-        if(startPos != string::npos)
-        {
-            texturePath = texturePath.erase(startPos);
-        }
-        
-        // append .png
-        texturePath = texturePath.append(".png");
-    }
+    std::string texturePath = getSheetTexturePath(textureFileName, plist);
 
     Texture2D *texture = nullptr;
     if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
@@ -714,6 +796,124 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
 }
 
 
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& sheetFile, Texture2D *texture, const std::string& textureFileName)
+{
+    // the sheet points into data, keep it until the frames are built
+    Data data = FileUtils::getInstance()->getDataFromFile(sheetFile);
+    auto sheet = getBinarySpriteSheet(data);
+    if (!sheet)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s isn't a binary sprite sheet", sheetFile.c_str());
+        return;
+    }
+
+    if (!texture)
+    {
+        std::string texturePath = textureFileName;
+        if (texturePath.empty())
+        {
+            texturePath = getSheetTexturePath(sheet->textureFileName() ? sheet->textureFileName()->c_str() : "", sheetFile);
+        }
+        texture = addSheetTexture(texturePath, sheet->pixelFormat() ? sheet->pixelFormat()->c_str() : "");
+        if (!texture)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            return;
+        }
+    }
+
+    addSpriteFramesWithBinary(sheet, texture, sheetFile, false);
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinary(const spritesheet::SpriteSheet *sheet, Texture2D *texture, const std::string &sheetFile, bool reload)
+{
+    auto frames = sheet->frames();
+    if (!frames)
+        return;
+
+    Size textureSize;
+    if (sheet->textureSize())
+    {
+        textureSize = Size(sheet->textureSize()->width(), sheet->textureSize()->height());
+    }
+
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    for (auto frameData : *frames)
+    {
+        if (!frameData->name() || !frameData->rect())
+            continue;
+
+        std::string spriteFrameName = frameData->name()->c_str();
+        if (reload)
+        {
+            _spriteFramesCache.eraseFrame(spriteFrameName);
+        }
+        else if (_spriteFramesCache.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        // the values are stored as they are used, no string parsing needed
+        auto rect = frameData->rect();
+        Vec2 offset = frameData->offset() ? Vec2(frameData->offset()->x(), frameData->offset()->y()) : Vec2::ZERO;
+        Size sourceSize = frameData->sourceSize() ? Size(frameData->sourceSize()->width(), frameData->sourceSize()->height()) : Size(rect->width(), rect->height());
+
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(rect->x(), rect->y(), rect->width(), rect->height()),
+                                                                  frameData->rotated() != 0,
+                                                                  offset,
+                                                                  sourceSize);
+
+        if (frameData->aliases())
+        {
+            for (auto alias : *frameData->aliases())
+            {
+                std::string oneAlias = alias->c_str();
+                if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+                {
+                    CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+                }
+
+                _spriteFramesAliases[oneAlias] = Value(spriteFrameName);
+            }
+        }
+
+        if (frameData->vertices() && frameData->verticesUV() && frameData->triangles())
+        {
+            std::vector<int> vertices(frameData->vertices()->begin(), frameData->vertices()->end());
+            std::vector<int> verticesUV(frameData->verticesUV()->begin(), frameData->verticesUV()->end());
+            std::vector<int> indices(frameData->triangles()->begin(), frameData->triangles()->end());
+
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (frameData->anchor())
+        {
+            spriteFrame->setAnchorPoint(Vec2(frameData->anchor()->x(), frameData->anchor()->y()));
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(Director::getInstance()->getTextureCache()->getTextureFilePath(texture));
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+
+        // add sprite frame
+        _spriteFramesCache.insertFrame(sheetFile, spriteFrameName, spriteFrame);
+    }
+    if (!reload)
+    {
+        _spriteFramesCache.markPlistFull(sheetFile, true);
+    }
+    CC_SAFE_DELETE(image);
+}
+
 void SpriteFrameCache::PlistFramesCache::insertFrame(const std::string &plist, const std::string &frame, SpriteFrame *spriteFrame)
 {
     _spriteFrames.insert(frame, spriteFrame);   //add SpriteFrame
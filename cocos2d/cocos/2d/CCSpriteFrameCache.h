@@ -45,6 +45,11 @@ class Sprite;
 class Texture2D;
 class PolygonInfo;
 
+namespace spritesheet
+{
+    struct SpriteSheet;
+}
+
 /**
  * @addtogroup _2d
  * @{
@@ -79,6 +84,10 @@ class PolygonInfo;
      - `size`:            size of the texture (optional)
      - `textureFileName`: name of the texture's image file
  
+ The frames may also be loaded from a binary .ccss file, converted from the .plist with
+ tools/spritesheet-converter. It holds the same data without the XML and string parsing, so large sheets load
+ much faster. Pass the .ccss file to the methods taking a plist, files with any other extension are read as .plist.
+
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
@@ -301,6 +310,16 @@ protected:
 
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture, const std::string &plist);
 
+    /** Adds the frames of a binary sprite sheet file, with the given texture if any, else with the texture it names.
+    * @since v4.0
+    */
+    void addSpriteFramesWithBinaryFile(const std::string& sheetFile, Texture2D *texture, const std::string& textureFileName);
+
+    /** Adds the frames of a binary sprite sheet, or replaces them when reloading.
+    * @since v4.0
+    */
+    void addSpriteFramesWithBinary(const spritesheet::SpriteSheet *sheet, Texture2D *texture, const std::string &sheetFile, bool reload);
+
     ValueMap _spriteFramesAliases;
     PlistFramesCache _spriteFramesCache;
 };
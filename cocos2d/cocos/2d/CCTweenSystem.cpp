@@ -0,0 +1,569 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCTweenSystem.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+#include "2d/CCActionEase.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCNode.h"
+#include "2d/CCTweenFunction.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    typedef float (*EasingFunction)(float);
+    typedef float (*RateEasingFunction)(float, float);
+
+    struct EasingEntry
+    {
+        const std::type_info* type;
+        EasingFunction function;
+    };
+
+    // Index 0 is reserved for linear tweens, see EASING_LINEAR.
+    const EasingEntry s_easings[] = {
+        { nullptr, nullptr },
+        { &typeid(EaseExponentialIn), tweenfunc::expoEaseIn },
+        { &typeid(EaseExponentialOut), tweenfunc::expoEaseOut },
+        { &typeid(EaseExponentialInOut), tweenfunc::expoEaseInOut },
+        { &typeid(EaseSineIn), tweenfunc::sineEaseIn },
+        { &typeid(EaseSineOut), tweenfunc::sineEaseOut },
+        { &typeid(EaseSineInOut), tweenfunc::sineEaseInOut },
+        { &typeid(EaseBounceIn), tweenfunc::bounceEaseIn },
+        { &typeid(EaseBounceOut), tweenfunc::bounceEaseOut },
+        { &typeid(EaseBounceInOut), tweenfunc::bounceEaseInOut },
+        { &typeid(EaseBackIn), tweenfunc::backEaseIn },
+        { &typeid(EaseBackOut), tweenfunc::backEaseOut },
+        { &typeid(EaseBackInOut), tweenfunc::backEaseInOut },
+        { &typeid(EaseQuadraticActionIn), tweenfunc::quadraticIn },
+        { &typeid(EaseQuadraticActionOut), tweenfunc::quadraticOut },
+        { &typeid(EaseQuadraticActionInOut), tweenfunc::quadraticInOut },
+        { &typeid(EaseQuarticActionIn), tweenfunc::quartEaseIn },
+        { &typeid(EaseQuarticActionOut), tweenfunc::quartEaseOut },
+        { &typeid(EaseQuarticActionInOut), tweenfunc::quartEaseInOut },
+        { &typeid(EaseQuinticActionIn), tweenfunc::quintEaseIn },
+        { &typeid(EaseQuinticActionOut), tweenfunc::quintEaseOut },
+        { &typeid(EaseQuinticActionInOut), tweenfunc::quintEaseInOut },
+        { &typeid(EaseCircleActionIn), tweenfunc::circEaseIn },
+        { &typeid(EaseCircleActionOut), tweenfunc::circEaseOut },
+        { &typeid(EaseCircleActionInOut), tweenfunc::circEaseInOut },
+        { &typeid(EaseCubicActionIn), tweenfunc::cubicEaseIn },
+        { &typeid(EaseCubicActionOut), tweenfunc::cubicEaseOut },
+        { &typeid(EaseCubicActionInOut), tweenfunc::cubicEaseInOut },
+    };
+
+    const uint8_t EASING_LINEAR = 0;
+    const uint8_t EASING_TABLE_COUNT = sizeof(s_easings) / sizeof(s_easings[0]);
+    // Rate based easings are numbered after the table.
+    const uint8_t EASING_RATE_IN = EASING_TABLE_COUNT;
+    const uint8_t EASING_RATE_OUT = EASING_TABLE_COUNT + 1;
+    const uint8_t EASING_RATE_IN_OUT = EASING_TABLE_COUNT + 2;
+    const uint8_t EASING_INVALID = 0xff;
+
+    uint8_t getEasingId(Action* action, float* rate)
+    {
+        const std::type_info& type = typeid(*action);
+        if (type == typeid(EaseIn))
+        {
+            *rate = static_cast<EaseRateAction*>(action)->getRate();
+            return EASING_RATE_IN;
+        }
+        if (type == typeid(EaseOut))
+        {
+            *rate = static_cast<EaseRateAction*>(action)->getRate();
+            return EASING_RATE_OUT;
+        }
+        if (type == typeid(EaseInOut))
+        {
+            *rate = static_cast<EaseRateAction*>(action)->getRate();
+            return EASING_RATE_IN_OUT;
+        }
+        for (uint8_t i = 1; i < EASING_TABLE_COUNT; ++i)
+        {
+            if (type == *s_easings[i].type)
+                return i;
+        }
+        return EASING_INVALID;
+    }
+
+    // Only the exact classes are accepted: a subclass may override update() and the
+    // packed tween would silently skip that behaviour.
+    bool isSupportedTween(Action* action)
+    {
+        const std::type_info& type = typeid(*action);
+        return type == typeid(MoveBy) || type == typeid(MoveTo)
+            || type == typeid(ScaleTo) || type == typeid(ScaleBy)
+            || type == typeid(RotateTo) || type == typeid(RotateBy)
+            || type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut);
+    }
+
+    // Returns the tween action and fills the easing, or nullptr if the action can't be packed.
+    ActionInterval* unwrapTween(Action* action, uint8_t* easing, float* rate)
+    {
+        *easing = EASING_LINEAR;
+        *rate = 1.0f;
+        if (isSupportedTween(action))
+            return static_cast<ActionInterval*>(action);
+
+        auto ease = dynamic_cast<ActionEase*>(action);
+        if (ease == nullptr || ease->getInnerAction() == nullptr)
+            return nullptr;
+
+        *easing = getEasingId(action, rate);
+        if (*easing == EASING_INVALID || !isSupportedTween(ease->getInnerAction()))
+            return nullptr;
+        return ease->getInnerAction();
+    }
+}
+
+TweenSystem::TweenSystem()
+: _removedCount(0)
+, _updating(false)
+{
+}
+
+TweenSystem::~TweenSystem()
+{
+    removeAllTweens();
+}
+
+bool TweenSystem::isSupported(Action *action)
+{
+    uint8_t easing;
+    float rate;
+    return action != nullptr && unwrapTween(action, &easing, &rate) != nullptr;
+}
+
+bool TweenSystem::addTween(Action *action, Node *target, bool paused)
+{
+    CCASSERT(action != nullptr, "action can't be nullptr!");
+    CCASSERT(target != nullptr, "target can't be nullptr!");
+    if (action == nullptr || target == nullptr)
+        return false;
+
+    uint8_t easing;
+    float rate;
+    auto tween = unwrapTween(action, &easing, &rate);
+    if (tween == nullptr)
+        return false;
+
+    // Let the action compute its start and delta values exactly as it would when run.
+    tween->startWithTarget(target);
+
+    Property property;
+    Vec3 from;
+    Vec3 delta;
+    if (auto moveBy = dynamic_cast<MoveBy*>(tween))
+    {
+        property = Property::POSITION;
+        from = moveBy->_startPosition;
+        delta = moveBy->_positionDelta;
+    }
+    else if (auto scaleTo = dynamic_cast<ScaleTo*>(tween))
+    {
+        property = Property::SCALE;
+        from.set(scaleTo->_startScaleX, scaleTo->_startScaleY, scaleTo->_startScaleZ);
+        delta.set(scaleTo->_deltaX, scaleTo->_deltaY, scaleTo->_deltaZ);
+    }
+    else if (auto rotateTo = dynamic_cast<RotateTo*>(tween))
+    {
+        property = rotateTo->_is3D ? Property::ROTATION_3D : Property::ROTATION_SKEW;
+        from = rotateTo->_startAngle;
+        delta = rotateTo->_diffAngle;
+    }
+    else if (auto rotateBy = dynamic_cast<RotateBy*>(tween))
+    {
+        property = rotateBy->_is3D ? Property::ROTATION_3D : Property::ROTATION_SKEW;
+        from = rotateBy->_startAngle;
+        delta = rotateBy->_deltaAngle;
+    }
+    else
+    {
+        auto fadeTo = static_cast<FadeTo*>(tween);
+        property = Property::OPACITY;
+        from.x = fadeTo->_fromOpacity;
+        delta.x = static_cast<float>(fadeTo->_toOpacity - fadeTo->_fromOpacity);
+    }
+    tween->stop();
+
+    // setRotation() writes both skew angles at once.
+    if (property == Property::ROTATION_SKEW && from.x == from.y && delta.x == delta.y)
+        property = Property::ROTATION;
+
+    auto it = _targetEntries.find(target);
+    if (it == _targetEntries.end())
+    {
+        target->retain();
+        it = _targetEntries.emplace(target, TargetEntry{0, paused}).first;
+    }
+    ++it->second.tweens;
+
+    _targets.push_back(target);
+    _properties.push_back(property);
+    _easings.push_back(easing);
+    _paused.push_back(it->second.paused || paused);
+    _firstTick.push_back(true);
+    _tags.push_back(action->getTag());
+    _elapsed.push_back(0.0f);
+    _durations.push_back(static_cast<ActionInterval*>(action)->getDuration());
+    _rates.push_back(rate);
+    _times.push_back(0.0f);
+    _fromX.push_back(from.x);
+    _fromY.push_back(from.y);
+    _fromZ.push_back(from.z);
+    _deltaX.push_back(delta.x);
+    _deltaY.push_back(delta.y);
+    _deltaZ.push_back(delta.z);
+    _previousX.push_back(from.x);
+    _previousY.push_back(from.y);
+    _previousZ.push_back(from.z);
+    return true;
+}
+
+void TweenSystem::removeTweenAtIndex(size_t index)
+{
+    Node* target = _targets[index];
+    if (target == nullptr)
+        return;
+
+    _targets[index] = nullptr;
+    ++_removedCount;
+
+    auto it = _targetEntries.find(target);
+    CCASSERT(it != _targetEntries.end(), "tween target isn't registered!");
+    if (--it->second.tweens == 0)
+    {
+        _targetEntries.erase(it);
+        target->release();
+    }
+}
+
+void TweenSystem::compact()
+{
+    if (_removedCount == 0)
+        return;
+
+    // Stable compaction keeps the order tweens were added in, so the latest tween
+    // on a property still wins when several of them overlap.
+    size_t count = _targets.size();
+    size_t dst = 0;
+    for (size_t src = 0; src < count; ++src)
+    {
+        if (_targets[src] == nullptr)
+            continue;
+        if (dst != src)
+        {
+            _targets[dst] = _targets[src];
+            _properties[dst] = _properties[src];
+            _easings[dst] = _easings[src];
+            _paused[dst] = _paused[src];
+            _firstTick[dst] = _firstTick[src];
+            _tags[dst] = _tags[src];
+            _elapsed[dst] = _elapsed[src];
+            _durations[dst] = _durations[src];
+            _rates[dst] = _rates[src];
+            _times[dst] = _times[src];
+            _fromX[dst] = _fromX[src];
+            _fromY[dst] = _fromY[src];
+            _fromZ[dst] = _fromZ[src];
+            _deltaX[dst] = _deltaX[src];
+            _deltaY[dst] = _deltaY[src];
+            _deltaZ[dst] = _deltaZ[src];
+            _previousX[dst] = _previousX[src];
+            _previousY[dst] = _previousY[src];
+            _previousZ[dst] = _previousZ[src];
+        }
+        ++dst;
+    }
+
+    _targets.resize(dst);
+    _properties.resize(dst);
+    _easings.resize(dst);
+    _paused.resize(dst);
+    _firstTick.resize(dst);
+    _tags.resize(dst);
+    _elapsed.resize(dst);
+    _durations.resize(dst);
+    _rates.resize(dst);
+    _times.resize(dst);
+    _fromX.resize(dst);
+    _fromY.resize(dst);
+    _fromZ.resize(dst);
+    _deltaX.resize(dst);
+    _deltaY.resize(dst);
+    _deltaZ.resize(dst);
+    _previousX.resize(dst);
+    _previousY.resize(dst);
+    _previousZ.resize(dst);
+    _removedCount = 0;
+}
+
+void TweenSystem::removeAllTweens()
+{
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        removeTweenAtIndex(i);
+    }
+    if (!_updating)
+        compact();
+}
+
+void TweenSystem::removeAllTweensFromTarget(Node *target)
+{
+    if (target == nullptr || _targetEntries.find(target) == _targetEntries.end())
+        return;
+
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        if (_targets[i] == target)
+            removeTweenAtIndex(i);
+    }
+    if (!_updating)
+        compact();
+}
+
+bool TweenSystem::removeTweenByTag(int tag, Node *target)
+{
+    if (target == nullptr || _targetEntries.find(target) == _targetEntries.end())
+        return false;
+
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        if (_targets[i] == target && _tags[i] == tag)
+        {
+            removeTweenAtIndex(i);
+            if (!_updating)
+                compact();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TweenSystem::removeAllTweensByTag(int tag, Node *target)
+{
+    if (target == nullptr || _targetEntries.find(target) == _targetEntries.end())
+        return;
+
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        if (_targets[i] == target && _tags[i] == tag)
+            removeTweenAtIndex(i);
+    }
+    if (!_updating)
+        compact();
+}
+
+void TweenSystem::pauseTarget(Node *target)
+{
+    auto it = _targetEntries.find(target);
+    if (it == _targetEntries.end() || it->second.paused)
+        return;
+
+    it->second.paused = true;
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        if (_targets[i] == target)
+            _paused[i] = true;
+    }
+}
+
+void TweenSystem::resumeTarget(Node *target)
+{
+    auto it = _targetEntries.find(target);
+    if (it == _targetEntries.end())
+        return;
+
+    it->second.paused = false;
+    for (size_t i = 0, count = _targets.size(); i < count; ++i)
+    {
+        if (_targets[i] == target)
+            _paused[i] = false;
+    }
+}
+
+void TweenSystem::pauseAllTargets(Vector<Node*>& pausedTargets)
+{
+    for (auto& entry : _targetEntries)
+    {
+        if (!entry.second.paused)
+        {
+            entry.second.paused = true;
+            if (!pausedTargets.contains(entry.first))
+                pausedTargets.pushBack(entry.first);
+        }
+    }
+    std::fill(_paused.begin(), _paused.end(), true);
+}
+
+ssize_t TweenSystem::getNumberOfTweens() const
+{
+    return static_cast<ssize_t>(_targets.size() - _removedCount);
+}
+
+ssize_t TweenSystem::getNumberOfTweensInTarget(const Node *target) const
+{
+    auto it = _targetEntries.find(const_cast<Node*>(target));
+    return it != _targetEntries.end() ? it->second.tweens : 0;
+}
+
+size_t TweenSystem::getNumberOfTweensInTargetByTag(const Node *target, int tag) const
+{
+    if (_targetEntries.find(const_cast<Node*>(target)) == _targetEntries.end())
+        return 0;
+
+    size_t count = 0;
+    for (size_t i = 0, total = _targets.size(); i < total; ++i)
+    {
+        if (_targets[i] == target && _tags[i] == tag)
+            ++count;
+    }
+    return count;
+}
+
+void TweenSystem::applyTweens(size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        Node* target = _targets[i];
+        if (target == nullptr || _paused[i])
+            continue;
+
+        const float t = _times[i];
+        switch (_properties[i])
+        {
+        case Property::POSITION:
+        {
+            Vec3 position(_fromX[i] + _deltaX[i] * t, _fromY[i] + _deltaY[i] * t, _fromZ[i] + _deltaZ[i] * t);
+#if CC_ENABLE_STACKABLE_ACTIONS
+            // Same as MoveBy: movements applied by others since the last frame are kept.
+            Vec3 current = target->getPosition3D();
+            float diffX = current.x - _previousX[i];
+            float diffY = current.y - _previousY[i];
+            float diffZ = current.z - _previousZ[i];
+            _fromX[i] += diffX;
+            _fromY[i] += diffY;
+            _fromZ[i] += diffZ;
+            position.add(diffX, diffY, diffZ);
+            _previousX[i] = position.x;
+            _previousY[i] = position.y;
+            _previousZ[i] = position.z;
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+            target->setPosition3D(position);
+            break;
+        }
+        case Property::SCALE:
+            target->setScaleX(_fromX[i] + _deltaX[i] * t);
+            target->setScaleY(_fromY[i] + _deltaY[i] * t);
+            target->setScaleZ(_fromZ[i] + _deltaZ[i] * t);
+            break;
+        case Property::ROTATION:
+            target->setRotation(_fromX[i] + _deltaX[i] * t);
+            break;
+        case Property::ROTATION_SKEW:
+            target->setRotationSkewX(_fromX[i] + _deltaX[i] * t);
+            target->setRotationSkewY(_fromY[i] + _deltaY[i] * t);
+            break;
+        case Property::ROTATION_3D:
+            target->setRotation3D(Vec3(_fromX[i] + _deltaX[i] * t, _fromY[i] + _deltaY[i] * t, _fromZ[i] + _deltaZ[i] * t));
+            break;
+        case Property::OPACITY:
+            target->setOpacity((uint8_t)(_fromX[i] + _deltaX[i] * t));
+            break;
+        }
+    }
+}
+
+void TweenSystem::update(float dt)
+{
+    // Tweens added by setters called from this update start on the next frame.
+    const size_t count = _targets.size();
+    if (count == 0)
+        return;
+
+    _updating = true;
+
+    // Drop tweens whose targets are only kept alive by us, like ActionManager does.
+    for (auto it = _targetEntries.begin(); it != _targetEntries.end(); )
+    {
+        Node* target = it->first;
+        ++it;
+        if (target->getReferenceCount() == 1)
+            removeAllTweensFromTarget(target);
+    }
+
+    // Advance time, with the same first tick rule as ActionInterval::step().
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (_paused[i] || _targets[i] == nullptr)
+            continue;
+
+        if (_firstTick[i])
+        {
+            _firstTick[i] = false;
+            _elapsed[i] = 0;
+        }
+        else
+        {
+            _elapsed[i] += dt;
+        }
+        _times[i] = std::max(0.0f, std::min(1.0f, _elapsed[i] / _durations[i]));
+    }
+
+    // Ease. Linear tweens are the common case and need no work.
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t easing = _easings[i];
+        if (easing == EASING_LINEAR || _paused[i] || _targets[i] == nullptr)
+            continue;
+
+        if (easing < EASING_TABLE_COUNT)
+            _times[i] = s_easings[easing].function(_times[i]);
+        else if (easing == EASING_RATE_IN)
+            _times[i] = tweenfunc::easeIn(_times[i], _rates[i]);
+        else if (easing == EASING_RATE_OUT)
+            _times[i] = tweenfunc::easeOut(_times[i], _rates[i]);
+        else
+            _times[i] = tweenfunc::easeInOut(_times[i], _rates[i]);
+    }
+
+    applyTweens(0, count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!_paused[i] && _elapsed[i] >= _durations[i])
+            removeTweenAtIndex(i);
+    }
+
+    _updating = false;
+    compact();
+}
+
+NS_CC_END
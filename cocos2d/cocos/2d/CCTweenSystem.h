@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __ACTION_CCTWEEN_SYSTEM_H__
+#define __ACTION_CCTWEEN_SYSTEM_H__
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCVector.h"
+
+NS_CC_BEGIN
+
+class Action;
+class Node;
+
+/**
+ * @addtogroup actions
+ * @{
+ */
+
+/** @class TweenSystem
+ @brief Runs simple property tweens in packed arrays instead of one Action object per tween.
+
+ The tween system understands MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo,
+ FadeIn and FadeOut, optionally wrapped in one of the non-elastic ActionEase classes.
+ Such an action is converted when it is added: its start and delta values are copied into the
+ arrays and the action object itself is not kept. All tweens are then advanced, eased and applied
+ in a few tight loops per frame, which is much cheaper than stepping thousands of Action objects.
+
+ The tween system is owned by ActionManager. Use Node::runTween() or ActionManager::addTween()
+ to run an action through it; both fall back to the regular action path for any other action.
+ @since v4.0
+ */
+class CC_DLL TweenSystem
+{
+public:
+    /** The node property a tween writes to. */
+    enum class Property : uint8_t
+    {
+        POSITION,
+        SCALE,
+        ROTATION,
+        ROTATION_SKEW,
+        ROTATION_3D,
+        OPACITY
+    };
+
+    TweenSystem();
+    ~TweenSystem();
+
+    /** Whether an action can be converted into a packed tween.
+     *
+     * @param action    A certain action.
+     * @return True if addTween() would accept the action.
+     */
+    static bool isSupported(Action *action);
+
+    /** Converts a supported action into a packed tween on the target.
+     * The action is started with the target to compute its start values and is then stopped;
+     * the caller keeps its ownership and may reuse it.
+     *
+     * @param action    A certain action.
+     * @param target    The target which the tween is applied to.
+     * @param paused    Whether the tween starts paused.
+     * @return False if the action isn't supported; nothing is added in that case.
+     */
+    bool addTween(Action *action, Node *target, bool paused);
+
+    /** Removes all tweens from all the targets. */
+    void removeAllTweens();
+
+    /** Removes all tweens from a certain target.
+     *
+     * @param target    A certain target.
+     */
+    void removeAllTweensFromTarget(Node *target);
+
+    /** Removes the first tween with the given tag on the target.
+     *
+     * @param tag       The action's tag when it was converted.
+     * @param target    A certain target.
+     * @return True if a tween was removed.
+     */
+    bool removeTweenByTag(int tag, Node *target);
+
+    /** Removes all tweens with the given tag on the target.
+     *
+     * @param tag       The action's tag when it was converted.
+     * @param target    A certain target.
+     */
+    void removeAllTweensByTag(int tag, Node *target);
+
+    /** Pauses the tweens of the target, including tweens added later on. */
+    void pauseTarget(Node *target);
+
+    /** Resumes the tweens of the target. */
+    void resumeTarget(Node *target);
+
+    /** Pauses all targets that have running tweens and appends them to pausedTargets. */
+    void pauseAllTargets(Vector<Node*>& pausedTargets);
+
+    /** Returns the number of tweens running in all targets. */
+    ssize_t getNumberOfTweens() const;
+
+    /** Returns the number of tweens running in a certain target. */
+    ssize_t getNumberOfTweensInTarget(const Node *target) const;
+
+    /** Returns the number of tweens running in a certain target with a specific tag. */
+    size_t getNumberOfTweensInTargetByTag(const Node *target, int tag) const;
+
+    /** Advances, eases and applies all running tweens.
+     * @param dt    In seconds.
+     */
+    void update(float dt);
+
+protected:
+    struct TargetEntry
+    {
+        int tweens;
+        bool paused;
+    };
+
+    void removeTweenAtIndex(size_t index);
+    void compact();
+    void applyTweens(size_t begin, size_t end);
+
+    std::unordered_map<Node*, TargetEntry> _targetEntries;
+
+    // One slot per tween, a removed tween keeps a null target until the next compaction.
+    std::vector<Node*> _targets;
+    std::vector<Property> _properties;
+    std::vector<uint8_t> _easings;
+    std::vector<uint8_t> _paused;
+    std::vector<uint8_t> _firstTick;
+    std::vector<int> _tags;
+    std::vector<float> _elapsed;
+    std::vector<float> _durations;
+    std::vector<float> _rates;
+    std::vector<float> _times;
+    std::vector<float> _fromX, _fromY, _fromZ;
+    std::vector<float> _deltaX, _deltaY, _deltaZ;
+    std::vector<float> _previousX, _previousY, _previousZ;
+
+    size_t _removedCount;
+    bool _updating;
+};
+
+// end of actions group
+/// @}
+
+NS_CC_END
+
+#endif // __ACTION_CCTWEEN_SYSTEM_H__
@@ -0,0 +1,231 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// automatically generated by the FlatBuffers compiler, do not modify
+
+#ifndef FLATBUFFERS_GENERATED_SPRITESHEETBINARY_COCOS2D_SPRITESHEET_H_
+#define FLATBUFFERS_GENERATED_SPRITESHEETBINARY_COCOS2D_SPRITESHEET_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+
+namespace cocos2d {
+namespace spritesheet {
+
+struct FrameVec2;
+struct FrameSize;
+struct FrameRect;
+struct SpriteFrameData;
+struct SpriteSheet;
+
+MANUALLY_ALIGNED_STRUCT(4) FrameVec2 {
+ private:
+  float x_;
+  float y_;
+
+ public:
+  FrameVec2(float x, float y)
+    : x_(flatbuffers::EndianScalar(x)), y_(flatbuffers::EndianScalar(y)) { }
+
+  float x() const { return flatbuffers::EndianScalar(x_); }
+  float y() const { return flatbuffers::EndianScalar(y_); }
+};
+STRUCT_END(FrameVec2, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) FrameSize {
+ private:
+  float width_;
+  float height_;
+
+ public:
+  FrameSize(float width, float height)
+    : width_(flatbuffers::EndianScalar(width)), height_(flatbuffers::EndianScalar(height)) { }
+
+  float width() const { return flatbuffers::EndianScalar(width_); }
+  float height() const { return flatbuffers::EndianScalar(height_); }
+};
+STRUCT_END(FrameSize, 8);
+
+MANUALLY_ALIGNED_STRUCT(4) FrameRect {
+ private:
+  float x_;
+  float y_;
+  float width_;
+  float height_;
+
+ public:
+  FrameRect(float x, float y, float width, float height)
+    : x_(flatbuffers::EndianScalar(x)), y_(flatbuffers::EndianScalar(y)), width_(flatbuffers::EndianScalar(width)), height_(flatbuffers::EndianScalar(height)) { }
+
+  float x() const { return flatbuffers::EndianScalar(x_); }
+  float y() const { return flatbuffers::EndianScalar(y_); }
+  float width() const { return flatbuffers::EndianScalar(width_); }
+  float height() const { return flatbuffers::EndianScalar(height_); }
+};
+STRUCT_END(FrameRect, 16);
+
+struct SpriteFrameData : private flatbuffers::Table {
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(4); }
+  const FrameRect *rect() const { return GetStruct<const FrameRect *>(6); }
+  uint8_t rotated() const { return GetField<uint8_t>(8, 0); }
+  const FrameVec2 *offset() const { return GetStruct<const FrameVec2 *>(10); }
+  const FrameSize *sourceSize() const { return GetStruct<const FrameSize *>(12); }
+  const FrameVec2 *anchor() const { return GetStruct<const FrameVec2 *>(14); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *aliases() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(16); }
+  const flatbuffers::Vector<int32_t> *vertices() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(18); }
+  const flatbuffers::Vector<int32_t> *verticesUV() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(20); }
+  const flatbuffers::Vector<int32_t> *triangles() const { return GetPointer<const flatbuffers::Vector<int32_t> *>(22); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 4 /* name */) &&
+           verifier.Verify(name()) &&
+           VerifyField<FrameRect>(verifier, 6 /* rect */) &&
+           VerifyField<uint8_t>(verifier, 8 /* rotated */) &&
+           VerifyField<FrameVec2>(verifier, 10 /* offset */) &&
+           VerifyField<FrameSize>(verifier, 12 /* sourceSize */) &&
+           VerifyField<FrameVec2>(verifier, 14 /* anchor */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 16 /* aliases */) &&
+           verifier.Verify(aliases()) &&
+           verifier.VerifyVectorOfStrings(aliases()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 18 /* vertices */) &&
+           verifier.Verify(vertices()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 20 /* verticesUV */) &&
+           verifier.Verify(verticesUV()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 22 /* triangles */) &&
+           verifier.Verify(triangles()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SpriteFrameDataBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(4, name); }
+  void add_rect(const FrameRect *rect) { fbb_.AddStruct(6, rect); }
+  void add_rotated(uint8_t rotated) { fbb_.AddElement<uint8_t>(8, rotated, 0); }
+  void add_offset(const FrameVec2 *offset) { fbb_.AddStruct(10, offset); }
+  void add_sourceSize(const FrameSize *sourceSize) { fbb_.AddStruct(12, sourceSize); }
+  void add_anchor(const FrameVec2 *anchor) { fbb_.AddStruct(14, anchor); }
+  void add_aliases(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> aliases) { fbb_.AddOffset(16, aliases); }
+  void add_vertices(flatbuffers::Offset<flatbuffers::Vector<int32_t>> vertices) { fbb_.AddOffset(18, vertices); }
+  void add_verticesUV(flatbuffers::Offset<flatbuffers::Vector<int32_t>> verticesUV) { fbb_.AddOffset(20, verticesUV); }
+  void add_triangles(flatbuffers::Offset<flatbuffers::Vector<int32_t>> triangles) { fbb_.AddOffset(22, triangles); }
+  SpriteFrameDataBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  SpriteFrameDataBuilder &operator=(const SpriteFrameDataBuilder &);
+  flatbuffers::Offset<SpriteFrameData> Finish() {
+    auto o = flatbuffers::Offset<SpriteFrameData>(fbb_.EndTable(start_, 10));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<SpriteFrameData> CreateSpriteFrameData(flatbuffers::FlatBufferBuilder &_fbb,
+   flatbuffers::Offset<flatbuffers::String> name = 0,
+   const FrameRect *rect = 0,
+   uint8_t rotated = 0,
+   const FrameVec2 *offset = 0,
+   const FrameSize *sourceSize = 0,
+   const FrameVec2 *anchor = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>> aliases = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> vertices = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> verticesUV = 0,
+   flatbuffers::Offset<flatbuffers::Vector<int32_t>> triangles = 0) {
+  SpriteFrameDataBuilder builder_(_fbb);
+  builder_.add_triangles(triangles);
+  builder_.add_verticesUV(verticesUV);
+  builder_.add_vertices(vertices);
+  builder_.add_aliases(aliases);
+  builder_.add_anchor(anchor);
+  builder_.add_sourceSize(sourceSize);
+  builder_.add_offset(offset);
+  builder_.add_rect(rect);
+  builder_.add_name(name);
+  builder_.add_rotated(rotated);
+  return builder_.Finish();
+}
+
+struct SpriteSheet : private flatbuffers::Table {
+  int32_t version() const { return GetField<int32_t>(4, 1); }
+  const flatbuffers::String *textureFileName() const { return GetPointer<const flatbuffers::String *>(6); }
+  const FrameSize *textureSize() const { return GetStruct<const FrameSize *>(8); }
+  const flatbuffers::String *pixelFormat() const { return GetPointer<const flatbuffers::String *>(10); }
+  const flatbuffers::Vector<flatbuffers::Offset<SpriteFrameData>> *frames() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<SpriteFrameData>> *>(12); }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, 4 /* version */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 6 /* textureFileName */) &&
+           verifier.Verify(textureFileName()) &&
+           VerifyField<FrameSize>(verifier, 8 /* textureSize */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 10 /* pixelFormat */) &&
+           verifier.Verify(pixelFormat()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 12 /* frames */) &&
+           verifier.Verify(frames()) &&
+           verifier.VerifyVectorOfTables(frames()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SpriteSheetBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_version(int32_t version) { fbb_.AddElement<int32_t>(4, version, 1); }
+  void add_textureFileName(flatbuffers::Offset<flatbuffers::String> textureFileName) { fbb_.AddOffset(6, textureFileName); }
+  void add_textureSize(const FrameSize *textureSize) { fbb_.AddStruct(8, textureSize); }
+  void add_pixelFormat(flatbuffers::Offset<flatbuffers::String> pixelFormat) { fbb_.AddOffset(10, pixelFormat); }
+  void add_frames(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<SpriteFrameData>>> frames) { fbb_.AddOffset(12, frames); }
+  SpriteSheetBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
+  SpriteSheetBuilder &operator=(const SpriteSheetBuilder &);
+  flatbuffers::Offset<SpriteSheet> Finish() {
+    auto o = flatbuffers::Offset<SpriteSheet>(fbb_.EndTable(start_, 5));
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<SpriteSheet> CreateSpriteSheet(flatbuffers::FlatBufferBuilder &_fbb,
+   int32_t version = 1,
+   flatbuffers::Offset<flatbuffers::String> textureFileName = 0,
+   const FrameSize *textureSize = 0,
+   flatbuffers::Offset<flatbuffers::String> pixelFormat = 0,
+   flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<SpriteFrameData>>> frames = 0) {
+  SpriteSheetBuilder builder_(_fbb);
+  builder_.add_frames(frames);
+  builder_.add_pixelFormat(pixelFormat);
+  builder_.add_textureSize(textureSize);
+  builder_.add_textureFileName(textureFileName);
+  builder_.add_version(version);
+  return builder_.Finish();
+}
+
+inline const SpriteSheet *GetSpriteSheet(const void *buf) { return flatbuffers::GetRoot<SpriteSheet>(buf); }
+
+inline bool VerifySpriteSheetBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<SpriteSheet>(); }
+
+inline void FinishSpriteSheetBuffer(flatbuffers::FlatBufferBuilder &fbb, flatbuffers::Offset<SpriteSheet> root) { fbb.Finish(root, "CCSS"); }
+
+inline bool SpriteSheetBufferHasIdentifier(const void *buf) { return flatbuffers::BufferHasIdentifier(buf, "CCSS"); }
+
+}  // namespace spritesheet
+}  // namespace cocos2d
+
+#endif  // FLATBUFFERS_GENERATED_SPRITESHEETBINARY_COCOS2D_SPRITESHEET_H_
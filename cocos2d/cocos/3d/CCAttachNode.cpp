@@ -40,7 +40,8 @@ AttachNode* AttachNode::create(Bone3D* attachBone)
 AttachNode::AttachNode()
 : _attachBone(nullptr)
 {
-    
+    // the transform updates the world matrices of the bone chain, shared with the other attach nodes
+    setParallelTransformSafe(false);
 }
 AttachNode::~AttachNode()
 {
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCAutoreleasePool.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -138,6 +139,7 @@ protected:
                                           }
                                           
                                           task();
+                                          PoolManager::clearThreadPool();
                                           Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback.callback, callback.callbackParam));
                                       }
                                   }
@@ -25,6 +25,9 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#include "base/CCThreadLocal.h"
+
+#include <thread>
 
 NS_CC_BEGIN
 
@@ -70,7 +73,18 @@ void AutoreleasePool::clear()
     releasings.swap(_managedObjectArray);
     for (const auto &obj : releasings)
     {
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+        obj->release();
+#else
+        // Bulk release: most pooled objects are still owned by the scene graph or a container, so only the
+        // references that reach 0 need to go through the full release path.
+        if (obj->_referenceCount > 1)
+        {
+            --obj->_referenceCount;
+            continue;
+        }
         obj->release();
+#endif
     }
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     _isClearing = false;
@@ -105,16 +119,64 @@ void AutoreleasePool::dump()
 //--------------------------------------------------------------------
 
 PoolManager* PoolManager::s_singleInstance = nullptr;
+std::atomic<std::thread::id> PoolManager::s_cocosThreadId;
+
+/** Owns the pool managers of the threads other than the cocos thread. Their pools are drained when the thread exits. */
+struct PoolManager::ThreadInstance
+{
+    static void release(PoolManager* manager);
+
+    typedef ThreadLocalPtr<PoolManager, &release> Slot;
+
+    static Slot& getSlot()
+    {
+        static Slot* slot = new Slot();
+        return *slot;
+    }
+};
+
+void PoolManager::ThreadInstance::release(PoolManager* manager)
+{
+    // the pools pop themselves from the manager of the thread while they are deleted
+    getSlot().set(manager);
+    delete manager;
+    getSlot().set(nullptr);
+}
 
 PoolManager* PoolManager::getInstance()
 {
+    if (std::this_thread::get_id() == s_cocosThreadId.load(std::memory_order_acquire))
+    {
+        if (s_singleInstance == nullptr)
+        {
+            s_singleInstance = new (std::nothrow) PoolManager();
+            // Add the first auto release pool
+            new AutoreleasePool("cocos2d autorelease pool");
+        }
+        return s_singleInstance;
+    }
+
+    auto& threadInstance = ThreadInstance::getSlot();
+    auto manager = threadInstance.get();
+    if (manager == nullptr)
+    {
+        manager = new (std::nothrow) PoolManager();
+        threadInstance.set(manager);
+        new AutoreleasePool("thread autorelease pool");
+    }
+    return manager;
+}
+
+void PoolManager::setCocosThread()
+{
+    auto& threadInstance = ThreadInstance::getSlot();
     if (s_singleInstance == nullptr)
     {
-        s_singleInstance = new (std::nothrow) PoolManager();
-        // Add the first auto release pool
-        new AutoreleasePool("cocos2d autorelease pool");
+        // objects autoreleased before the director existed are drained with the ones of the first frame
+        s_singleInstance = threadInstance.get();
+        threadInstance.set(nullptr);
     }
-    return s_singleInstance;
+    s_cocosThreadId.store(std::this_thread::get_id(), std::memory_order_release);
 }
 
 void PoolManager::destroyInstance()
@@ -123,6 +185,15 @@ void PoolManager::destroyInstance()
     s_singleInstance = nullptr;
 }
 
+void PoolManager::clearThreadPool()
+{
+    auto manager = ThreadInstance::getSlot().get();
+    if (manager != nullptr && !manager->_releasePoolStack.empty())
+    {
+        manager->getCurrentPool()->clear();
+    }
+}
+
 PoolManager::PoolManager()
 {
     _releasePoolStack.reserve(10);
@@ -26,8 +26,10 @@ THE SOFTWARE.
 #ifndef __AUTORELEASEPOOL_H__
 #define __AUTORELEASEPOOL_H__
 
+#include <atomic>
 #include <vector>
 #include <string>
+#include <thread>
 #include "base/CCRef.h"
 
 /**
@@ -154,8 +156,24 @@ class CC_DLL PoolManager
 {
 public:
 
+    /**
+     * Returns the pool manager of the calling thread. The cocos thread shares the engine wide instance, every
+     * other thread gets its own one, created on first use and drained when the thread exits.
+     */
     static PoolManager* getInstance();
     static void destroyInstance();
+
+    /**
+     * Makes the calling thread the cocos thread. Called by Director::init(), until then every thread, the main
+     * one included, gets a pool manager of its own.
+     */
+    static void setCocosThread();
+
+    /**
+     * Clears the current auto release pool of the calling worker thread, if it has one.
+     * Worker loops call it after each task, the cocos thread is drained by Director::mainLoop().
+     */
+    static void clearThreadPool();
     
     /**
      * Get current auto release pool, there is at least one auto release pool that created by engine.
@@ -167,6 +185,8 @@ public:
 
 
     friend class AutoreleasePool;
+
+    struct ThreadInstance;
     
 private:
     PoolManager();
@@ -176,6 +196,7 @@ private:
     void pop();
     
     static PoolManager* s_singleInstance;
+    static std::atomic<std::thread::id> s_cocosThreadId;
     
     std::vector<AutoreleasePool*> _releasePoolStack;
 };
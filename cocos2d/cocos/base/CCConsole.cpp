@@ -59,6 +59,7 @@
 #include "platform/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
 #include "2d/CCScene.h"
+#include "2d/CCActionPool.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
 #include "base/base64.h"
@@ -485,6 +486,7 @@ Console::Console()
 , _sendDebugStrings(false)
 , _bindAddress("")
 {
+    createCommandActionPool();
     createCommandAllocator();
     createCommandConfig();
     createCommandDebugMsg();
@@ -1017,6 +1019,16 @@ void Console::addClient()
 // create commands
 //
 
+void Console::createCommandActionPool()
+{
+    addCommand({"actionpool", "Flush, reset or print the action pool statistics. Args: [-h | help | flush | reset | ]",
+        CC_CALLBACK_2(Console::commandActionPool, this)});
+    addSubCommand("actionpool", {"flush", "Releases the free blocks of the action pool.",
+        CC_CALLBACK_2(Console::commandActionPoolSubCommandFlush, this)});
+    addSubCommand("actionpool", {"reset", "Resets the hit and miss counters.",
+        CC_CALLBACK_2(Console::commandActionPoolSubCommandReset, this)});
+}
+
 void Console::createCommandAllocator()
 {
     addCommand({"allocator", "Display allocator diagnostics for all allocators. Args: [-h | help | ]",
@@ -1101,10 +1113,12 @@ void Console::createCommandSceneGraph()
 
 void Console::createCommandTexture()
 {
-    addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | ] ",
+    addCommand({"texture", "Flush, reset or print the TextureCache info. Args: [-h | help | flush | reset | ] ",
         CC_CALLBACK_2(Console::commandTextures, this)});
     addSubCommand("texture", {"flush", "Purges the dictionary of loaded textures.",
         CC_CALLBACK_2(Console::commandTexturesSubCommandFlush, this)});
+    addSubCommand("texture", {"reset", "Resets the hit, miss and eviction counters.",
+        CC_CALLBACK_2(Console::commandTexturesSubCommandReset, this)});
 }
 
 void Console::createCommandTouch()
@@ -1130,6 +1144,25 @@ void Console::createCommandVersion()
 // commands
 //
 
+void Console::commandActionPool(int fd, const std::string& /*args*/)
+{
+    Console::Utility::mydprintf(fd, "%s", ActionPool::getStatisticsInfo().c_str());
+}
+
+void Console::commandActionPoolSubCommandFlush(int /*fd*/, const std::string& /*args*/)
+{
+    // the free lists belong to the thread using them
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [](){
+        ActionPool::purge();
+    });
+}
+
+void Console::commandActionPoolSubCommandReset(int /*fd*/, const std::string& /*args*/)
+{
+    ActionPool::resetStatistics();
+}
+
 void Console::commandAllocator(int fd, const std::string& /*args*/)
 {
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
@@ -1339,6 +1372,14 @@ void Console::commandTexturesSubCommandFlush(int /*fd*/, const std::string& /*ar
     });
 }
 
+void Console::commandTexturesSubCommandReset(int /*fd*/, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [](){
+        Director::getInstance()->getTextureCache()->resetStatistics();
+    });
+}
+
 void Console::commandTouchSubCommandTap(int fd, const std::string& args)
 {
     auto argv = Console::Utility::split(args,' ');
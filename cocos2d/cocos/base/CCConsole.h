@@ -226,6 +226,7 @@ protected:
     void addClient();
     
     // create a map of command.
+    void createCommandActionPool();
     void createCommandAllocator();
     void createCommandConfig();
     void createCommandDebugMsg();
@@ -243,6 +244,9 @@ protected:
     void createCommandVersion();
 
     // Add commands here
+    void commandActionPool(int fd, const std::string& args);
+    void commandActionPoolSubCommandFlush(int fd, const std::string& args);
+    void commandActionPoolSubCommandReset(int fd, const std::string& args);
     void commandAllocator(int fd, const std::string& args);
     void commandConfig(int fd, const std::string& args);
     void commandDebugMsg(int fd, const std::string& args);
@@ -266,6 +270,7 @@ protected:
     void commandSceneGraph(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
+    void commandTexturesSubCommandReset(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
     void commandUpload(int fd);
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
+#include "2d/CCActionPool.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCFontAtlasCache.h"
 #include "2d/CCAnimationCache.h"
@@ -52,11 +53,13 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCEventChannel.h"
 #include "base/CCEventCustom.h"
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkerPool.h"
 #include "base/ObjectFactory.h"
 #include "platform/CCApplication.h"
 #include "renderer/backend/ProgramCache.h"
@@ -113,6 +116,9 @@ Director::Director()
 
 bool Director::init()
 {
+    _cocos2d_thread_id = std::this_thread::get_id();
+    PoolManager::setCocosThread();
+
     setDefaultValues();
 
     _scenesStack.reserve(15);
@@ -647,6 +653,7 @@ void Director::purgeCachedData()
 {
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    ActionPool::purge();
 
     if (s_SharedDirector->getOpenGLView())
     {
@@ -973,6 +980,7 @@ void Director::reset()
     {
         _eventDispatcher->removeAllEventListeners();
     }
+    EventChannel::destroyInstance();
     
     if(_notificationNode)
     {
@@ -1020,6 +1028,7 @@ void Director::reset()
     SpriteFrameCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    WorkerPool::destroyInstance();
     backend::ProgramCache::destroyInstance();
     
     
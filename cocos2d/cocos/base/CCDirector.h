@@ -507,6 +507,16 @@ public:
      */
     bool isValid() const { return !_invalid; }
 
+    /** Enables updating node transforms in a separate pass before visiting, spread across WorkerPool threads.
+     * Worth it for scenes with many thousands of nodes, see Node::updateTransformTree. Disabled by default.
+     * getNodeToParentTransform() may then run on a worker: nodes overriding it to write state shared with
+     * other nodes must call Node::setParallelTransformSafe(false).
+     */
+    void setParallelTransformEnabled(bool enabled) { _parallelTransformEnabled = enabled; }
+
+    /** Whether node transforms are updated in a parallel pass before visiting. */
+    bool isParallelTransformEnabled() const { return _parallelTransformEnabled; }
+
 protected:
     void reset();
     
@@ -644,6 +654,9 @@ protected:
     /* whether or not the director is in a valid state */
     bool _invalid = false;
 
+    /* whether or not transforms are updated in parallel before visiting */
+    bool _parallelTransformEnabled = false;
+
     // GLView will recreate stats labels to fit visible rect
     friend class GLView;
 };
@@ -0,0 +1,284 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCEventChannel.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // Event types are process wide so IDs cached by callers survive Director::reset()
+    struct EventTypeRegistry
+    {
+        std::unordered_map<std::string, EventChannel::TypeID> ids;
+        std::vector<std::string> names{ std::string() };
+    };
+
+    EventTypeRegistry& getEventTypeRegistry()
+    {
+        static EventTypeRegistry registry;
+        return registry;
+    }
+}
+
+EventPayload::EventPayload()
+: _data(nullptr)
+, _type(nullptr)
+, _destroy(nullptr)
+{
+}
+
+EventPayload::~EventPayload()
+{
+    reset();
+}
+
+void EventPayload::reset()
+{
+    if (_destroy)
+    {
+        _destroy(_data);
+    }
+    _data = nullptr;
+    _type = nullptr;
+    _destroy = nullptr;
+}
+
+EventChannel* EventChannel::s_sharedEventChannel = nullptr;
+
+EventChannel* EventChannel::getInstance()
+{
+    if (s_sharedEventChannel == nullptr)
+    {
+        s_sharedEventChannel = new (std::nothrow) EventChannel();
+    }
+    return s_sharedEventChannel;
+}
+
+void EventChannel::destroyInstance()
+{
+    delete s_sharedEventChannel;
+    s_sharedEventChannel = nullptr;
+}
+
+EventChannel::TypeID EventChannel::registerEventType(const std::string& name)
+{
+    CCASSERT(!name.empty(), "Event type name can't be empty");
+
+    auto& registry = getEventTypeRegistry();
+    auto found = registry.ids.find(name);
+    if (found != registry.ids.end())
+        return found->second;
+
+    auto type = static_cast<TypeID>(registry.names.size());
+    registry.names.push_back(name);
+    registry.ids.emplace(name, type);
+    return type;
+}
+
+EventChannel::TypeID EventChannel::getEventType(const std::string& name)
+{
+    auto& registry = getEventTypeRegistry();
+    auto found = registry.ids.find(name);
+    return found != registry.ids.end() ? found->second : INVALID_TYPE;
+}
+
+const std::string& EventChannel::getEventTypeName(TypeID type)
+{
+    auto& registry = getEventTypeRegistry();
+    return type < registry.names.size() ? registry.names[type] : registry.names[INVALID_TYPE];
+}
+
+EventChannel::EventChannel()
+: _nextHandle(INVALID_HANDLE)
+{
+}
+
+EventChannel::~EventChannel()
+{
+    CCASSERT(std::none_of(_lists.begin(), _lists.end(), [](const ListenerList& list) { return list.dispatchDepth > 0; }),
+             "EventChannel destroyed while dispatching");
+}
+
+EventChannel::ListenerHandle EventChannel::addListener(TypeID type, const Callback& callback, int priority)
+{
+    CCASSERT(type != INVALID_TYPE && type < getEventTypeRegistry().names.size(), "Unregistered event type");
+    CCASSERT(callback, "Invalid callback");
+
+    if (type >= _lists.size())
+    {
+        _lists.resize(type + 1);
+    }
+
+    if (++_nextHandle == INVALID_HANDLE)
+    {
+        ++_nextHandle;
+    }
+
+    Listener listener;
+    listener.callback = callback;
+    listener.handle = _nextHandle;
+    listener.priority = priority;
+    listener.removed = false;
+    _handleTypes.emplace(listener.handle, type);
+
+    auto& list = _lists[type];
+    if (list.dispatchDepth > 0)
+    {
+        // Don't move the listeners being iterated, the new one is called from the next dispatch
+        list.pending.push_back(std::move(listener));
+        list.dirty = true;
+    }
+    else
+    {
+        insertListener(list, std::move(listener));
+    }
+    return _nextHandle;
+}
+
+void EventChannel::insertListener(ListenerList& list, Listener&& listener)
+{
+    auto position = std::upper_bound(list.listeners.begin(), list.listeners.end(), listener.priority,
+                                     [](int priority, const Listener& l) { return priority < l.priority; });
+    list.listeners.insert(position, std::move(listener));
+}
+
+void EventChannel::flushListenerList(ListenerList& list)
+{
+    if (!list.dirty)
+        return;
+
+    list.listeners.erase(std::remove_if(list.listeners.begin(), list.listeners.end(),
+                                        [](const Listener& l) { return l.removed; }),
+                         list.listeners.end());
+
+    for (auto& listener : list.pending)
+    {
+        if (!listener.removed)
+        {
+            insertListener(list, std::move(listener));
+        }
+    }
+    list.pending.clear();
+    list.dirty = false;
+}
+
+void EventChannel::removeListener(ListenerHandle handle)
+{
+    auto found = _handleTypes.find(handle);
+    if (found == _handleTypes.end())
+        return;
+
+    auto& list = _lists[found->second];
+    _handleTypes.erase(found);
+
+    auto matches = [handle](const Listener& l) { return l.handle == handle; };
+    if (list.dispatchDepth > 0)
+    {
+        auto iter = std::find_if(list.listeners.begin(), list.listeners.end(), matches);
+        if (iter == list.listeners.end())
+        {
+            iter = std::find_if(list.pending.begin(), list.pending.end(), matches);
+        }
+        iter->removed = true;
+        list.dirty = true;
+    }
+    else
+    {
+        list.listeners.erase(std::find_if(list.listeners.begin(), list.listeners.end(), matches));
+    }
+}
+
+void EventChannel::removeListenersForType(TypeID type)
+{
+    if (type >= _lists.size())
+        return;
+
+    auto& list = _lists[type];
+    auto forget = [this](Listener& l) {
+        _handleTypes.erase(l.handle);
+        l.removed = true;
+    };
+    std::for_each(list.listeners.begin(), list.listeners.end(), forget);
+    std::for_each(list.pending.begin(), list.pending.end(), forget);
+    list.dirty = true;
+
+    if (list.dispatchDepth == 0)
+    {
+        flushListenerList(list);
+    }
+}
+
+void EventChannel::removeAllListeners()
+{
+    for (TypeID type = 0; type < _lists.size(); ++type)
+    {
+        removeListenersForType(type);
+    }
+}
+
+bool EventChannel::hasListeners(TypeID type) const
+{
+    if (type >= _lists.size())
+        return false;
+
+    const auto& list = _lists[type];
+    return !list.listeners.empty() || !list.pending.empty();
+}
+
+void EventChannel::dispatch(TypeID type, const EventPayload& payload)
+{
+    if (type >= _lists.size())
+        return;
+
+    // While the depth is positive, removed listeners are only flagged and new ones are pending,
+    // so the listeners vector and its callbacks stay in place even if a callback changes the list
+    ++_lists[type].dispatchDepth;
+    const size_t count = _lists[type].listeners.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto& listener = _lists[type].listeners[i];
+        if (!listener.removed)
+        {
+            listener.callback(payload);
+        }
+    }
+
+    auto& list = _lists[type];
+    if (--list.dispatchDepth == 0)
+    {
+        flushListenerList(list);
+    }
+}
+
+void EventChannel::dispatch(TypeID type)
+{
+    EventPayload payload;
+    dispatch(type, payload);
+}
+
+NS_CC_END
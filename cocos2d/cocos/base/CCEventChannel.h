@@ -0,0 +1,246 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_EVENT_CHANNEL_H__
+#define __CC_EVENT_CHANNEL_H__
+
+#include <functional>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/ccMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class EventPayload
+ * @brief Typed data carried by an EventChannel event.
+ *
+ * Values up to BUFFER_SIZE bytes are stored inline, larger ones on the heap.
+ * The payload only lives while the event is dispatched.
+ */
+class CC_DLL EventPayload
+{
+public:
+    static const size_t BUFFER_SIZE = 32;
+
+    /** Creates an empty payload. */
+    EventPayload();
+
+    /** Creates a payload holding a copy of value. */
+    template<typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, EventPayload>::value>::type>
+    explicit EventPayload(T&& value)
+    : EventPayload()
+    {
+        set(std::forward<T>(value));
+    }
+
+    ~EventPayload();
+
+    /** Replaces the held value. */
+    template<typename T>
+    void set(T&& value)
+    {
+        typedef typename std::decay<T>::type Value;
+
+        reset();
+        if (sizeof(Value) <= BUFFER_SIZE && alignof(Value) <= alignof(Buffer))
+        {
+            _data = new (&_buffer) Value(std::forward<T>(value));
+            _destroy = [](void* data) { static_cast<Value*>(data)->~Value(); };
+        }
+        else
+        {
+            _data = new Value(std::forward<T>(value));
+            _destroy = [](void* data) { delete static_cast<Value*>(data); };
+        }
+        _type = &typeid(Value);
+    }
+
+    /** Gets the held value, T must be the type the payload was created with. */
+    template<typename T>
+    const T& get() const
+    {
+        CCASSERT(is<T>(), "EventPayload holds a different type");
+        return *static_cast<const T*>(_data);
+    }
+
+    /** Whether the payload holds a value of type T. */
+    template<typename T>
+    bool is() const { return _type != nullptr && *_type == typeid(T); }
+
+    /** Whether the payload holds no value. */
+    bool empty() const { return _type == nullptr; }
+
+    /** Destroys the held value. */
+    void reset();
+
+private:
+    typedef std::aligned_storage<BUFFER_SIZE>::type Buffer;
+    typedef void (*Destroyer)(void*);
+
+    Buffer _buffer;
+    void* _data;
+    const std::type_info* _type;
+    Destroyer _destroy;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(EventPayload);
+};
+
+/** @class EventChannel
+ * @brief Dispatches events identified by integer types to typed listeners.
+ *
+ * Unlike EventCustom, event types are registered once by name and then used as
+ * indices into the listener arrays, so dispatching does no string hashing or map
+ * lookup and the payload doesn't need to be a pointer to a caller's variable.
+ * Listeners are called in ascending priority, listeners with the same priority
+ * in the order they were added. Must be used from the cocos thread only.
+ */
+class CC_DLL EventChannel
+{
+public:
+    /** Event type identifier, obtained from registerEventType. */
+    typedef unsigned int TypeID;
+    /** Identifies an added listener, used to remove it. */
+    typedef unsigned int ListenerHandle;
+    /** Callback receiving the payload of a dispatched event. */
+    typedef std::function<void(const EventPayload&)> Callback;
+
+    static const TypeID INVALID_TYPE = 0;
+    static const ListenerHandle INVALID_HANDLE = 0;
+
+    /** Returns the shared event channel. */
+    static EventChannel* getInstance();
+
+    /** Destroys the shared event channel and all of its listeners. */
+    static void destroyInstance();
+
+    /** Registers an event type by name, registering the same name again returns the same ID.
+     * IDs stay valid for the lifetime of the process, so they can be cached in statics.
+     */
+    static TypeID registerEventType(const std::string& name);
+
+    /** Gets the ID of a registered event type, or INVALID_TYPE. */
+    static TypeID getEventType(const std::string& name);
+
+    /** Gets the name an event type was registered with. */
+    static const std::string& getEventTypeName(TypeID type);
+
+    /** Adds a listener receiving the untyped payload.
+     *
+     * @param type The event type.
+     * @param callback Called for every dispatched event of this type.
+     * @param priority Lower priorities are called first.
+     * @return A handle for removeListener.
+     */
+    ListenerHandle addListener(TypeID type, const Callback& callback, int priority = 0);
+
+    /** Adds a listener receiving the payload as T. Events of this type must carry a T. */
+    template<typename T>
+    ListenerHandle addListener(TypeID type, const std::function<void(const T&)>& callback, int priority = 0)
+    {
+        return addListener(type, Callback([callback](const EventPayload& payload) {
+            callback(payload.get<T>());
+        }), priority);
+    }
+
+    /** Removes a listener, it won't be called anymore even during the current dispatch. */
+    void removeListener(ListenerHandle handle);
+
+    /** Removes all listeners of an event type. */
+    void removeListenersForType(TypeID type);
+
+    /** Removes all listeners. */
+    void removeAllListeners();
+
+    /** Whether an event type has listeners. */
+    bool hasListeners(TypeID type) const;
+
+    /** Dispatches an event with a payload. */
+    void dispatch(TypeID type, const EventPayload& payload);
+
+    /** Dispatches an event carrying a copy of value. */
+    template<typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, EventPayload>::value>::type>
+    void dispatch(TypeID type, T&& value)
+    {
+        // Skip building the payload when nobody listens
+        if (!hasListeners(type))
+            return;
+
+        EventPayload payload(std::forward<T>(value));
+        dispatch(type, payload);
+    }
+
+    /** Dispatches an event without payload. */
+    void dispatch(TypeID type);
+
+private:
+    struct Listener
+    {
+        Callback callback;
+        ListenerHandle handle;
+        int priority;
+        bool removed;
+    };
+
+    struct ListenerList
+    {
+        std::vector<Listener> listeners;
+        /** Listeners added while the type was being dispatched */
+        std::vector<Listener> pending;
+        int dispatchDepth = 0;
+        bool dirty = false;
+    };
+
+    EventChannel();
+    ~EventChannel();
+
+    void insertListener(ListenerList& list, Listener&& listener);
+    void flushListenerList(ListenerList& list);
+
+    /** Listener lists indexed by event type */
+    std::vector<ListenerList> _lists;
+    std::unordered_map<ListenerHandle, TypeID> _handleTypes;
+    ListenerHandle _nextHandle;
+
+    static EventChannel* s_sharedEventChannel;
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_EVENT_CHANNEL_H__
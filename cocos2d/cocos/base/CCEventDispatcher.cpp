@@ -38,6 +38,7 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCTouchHitGrid.h"
 #include "2d/CCCamera.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
@@ -200,9 +201,10 @@ void EventDispatcher::EventListenerVector::clear()
 
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _nodeOrderRoot(nullptr)
+, _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
+, _touchHitGrid(new (std::nothrow) TouchHitGrid())
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -220,75 +222,80 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+    CC_SAFE_DELETE(_touchHitGrid);
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
+const EventDispatcher::NodeOrderKey& EventDispatcher::getNodeOrderKey(Node* node, Node* rootNode)
 {
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
+    auto found = _nodeOrderKeys.find(node);
+    if (found != _nodeOrderKeys.end())
     {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
+        return found->second;
+    }
+
+    // The key only depends on the node's ancestors, adding or reordering siblings leaves it valid
+    NodeOrderKey& key = _nodeOrderKeys[node];
+    key.inScene = false;
+    key.globalZOrder = node->getGlobalZOrder();
+
+    Node* current = node;
+    for (Node* parent = node->getParent(); parent != nullptr; parent = parent->getParent())
+    {
+        // Protected children aren't part of getChildren(), they don't get a scene graph priority
+        const auto& siblings = parent->getChildren();
+        if (std::find(siblings.begin(), siblings.end(), current) == siblings.end())
         {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
+            key.path.clear();
+            return key;
         }
+
+        key.path.push_back(current->_localZOrder$Arrival);
+        current = parent;
+    }
+
+    if (current == rootNode)
+    {
+        key.inScene = true;
+        std::reverse(key.path.begin(), key.path.end());
     }
     else
     {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
+        key.path.clear();
     }
-    
-    if (isRootNode)
+
+    return key;
+}
+
+bool EventDispatcher::isNodeOrderedBefore(const NodeOrderKey& k1, const NodeOrderKey& k2)
+{
+    // Greater global Z order first, then the node visited later in the scene graph.
+    // Nodes out of the running scene have the lowest priority.
+    if (k1.inScene != k2.inScene)
+        return k1.inScene;
+
+    if (!k1.inScene)
+        return false;
+
+    if (k1.globalZOrder != k2.globalZOrder)
+        return k1.globalZOrder > k2.globalZOrder;
+
+    const auto& p1 = k1.path;
+    const auto& p2 = k2.path;
+    size_t common = std::min(p1.size(), p2.size());
+    for (size_t i = 0; i < common; ++i)
     {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
+        if (p1[i] != p2[i])
+            return p1[i] > p2[i];
     }
+
+    // A node is visited after its children with a negative local Z order and before the others
+    if (p1.size() < p2.size())
+        return p2[common] < 0;
+
+    if (p1.size() > p2.size())
+        return p1[common] >= 0;
+
+    return false;
 }
 
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
@@ -357,7 +364,7 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
 {
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
-    _nodePriorityMap.erase(target);
+    _nodeOrderKeys.erase(target);
     _dirtyNodes.erase(target);
 
     auto listenerIter = _nodeListenersMap.find(target);
@@ -436,6 +443,7 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
+            _nodeOrderKeys.erase(node);
             delete listeners;
         }
     }
@@ -552,8 +560,8 @@ void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
         }
     }
     
-    // Check the node priority map
-    for (const auto & keyValuePair : _nodePriorityMap)
+    // Check the node order key cache
+    for (const auto & keyValuePair : _nodeOrderKeys)
     {
         CCASSERT(keyValuePair.first != node,
                  "Node should have no event listeners registered for it upon destruction!");
@@ -801,7 +809,7 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, c
     }
 }
 
-void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Touch* hitTestTouch)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -843,6 +851,15 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
                     sceneListeners.push_back(l);
                 }
             }
+            // only ask the listeners whose node may contain the touch, the grid keeps their order
+            bool useHitGrid = false;
+            std::vector<EventListener*> hitCandidates;
+            if (hitTestTouch && _touchHitGrid)
+            {
+                _touchHitGrid->update(*sceneGraphPriorityListeners);
+                useHitGrid = _touchHitGrid->hasCulledListeners();
+            }
+            
             // second, for all camera call all listeners
             // get a copy of cameras, prevent it's been modified in listener callback
             // if camera's depth is greater, process it earlier
@@ -855,14 +872,26 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
                     continue;
                 }
                 
+                const std::vector<EventListener*>* cameraListeners = &sceneListeners;
+                Vec2 worldPoint;
+                if (useHitGrid && TouchHitGrid::locationToWorldPlane(camera, hitTestTouch->getLocation(), &worldPoint))
+                {
+                    _touchHitGrid->query(worldPoint, hitCandidates);
+                    cameraListeners = &hitCandidates;
+                }
+                
                 Camera::_visitingCamera = camera;
                 auto cameraFlag = (unsigned short)camera->getCameraFlag();
-                for (auto& l : sceneListeners)
+                for (auto& l : *cameraListeners)
                 {
                     if (nullptr == l->getAssociatedNode() || 0 == (l->getAssociatedNode()->getCameraMask() & cameraFlag))
                     {
                         continue;
                     }
+                    if (cameraListeners == &hitCandidates && !(l->isEnabled() && !l->isPaused() && l->isRegistered()))
+                    {
+                        continue;
+                    }
                     if (onEvent(l))
                     {
                         shouldStopPropagation = true;
@@ -918,10 +947,6 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     sortEventListeners(listenerID);
     
-    auto pfnDispatchEventToListeners = &EventDispatcher::dispatchEventToListeners;
-    if (event->getType() == Event::Type::MOUSE) {
-        pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
-    }
     auto iter = _listenerMap.find(listenerID);
     if (iter != _listenerMap.end())
     {
@@ -933,7 +958,14 @@ void EventDispatcher::dispatchEvent(Event* event)
             return event->isStopped();
         };
         
-        (this->*pfnDispatchEventToListeners)(listeners, onEvent);
+        if (event->getType() == Event::Type::MOUSE)
+        {
+            dispatchTouchEventToListeners(listeners, onEvent, nullptr);
+        }
+        else
+        {
+            dispatchEventToListeners(listeners, onEvent);
+        }
     }
     
     updateListeners(event);
@@ -1068,7 +1100,8 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
             };
             
             //
-            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            const Touch* hitTestTouch = event->getEventCode() == EventTouch::EventCode::BEGAN ? touches : nullptr;
+            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent, hitTestTouch);
             if (event->isStopped())
             {
                 return;
@@ -1134,7 +1167,7 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
             return false;
         };
         
-        dispatchTouchEventToListeners(allAtOnceListeners, onTouchesEvent);
+        dispatchTouchEventToListeners(allAtOnceListeners, onTouchesEvent, nullptr);
         if (event->isStopped())
         {
             return;
@@ -1262,6 +1295,8 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     {
         for (auto& node : _dirtyNodes)
         {
+            _nodeOrderKeys.erase(node);
+            
             auto iter = _nodeListenersMap.find(node);
             if (iter != _nodeListenersMap.end())
             {
@@ -1322,22 +1357,37 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    // Keys are relative to the running scene, drop them all when it changes
+    if (_nodeOrderRoot != rootNode)
+    {
+        _nodeOrderKeys.clear();
+        _nodeOrderRoot = rootNode;
+    }
+    
+    std::vector<std::pair<EventListener*, const NodeOrderKey*>> keyedListeners;
+    keyedListeners.reserve(sceneGraphListeners->size());
+    for (auto& l : *sceneGraphListeners)
+    {
+        auto node = l->getAssociatedNode();
+        keyedListeners.emplace_back(l, node ? &getNodeOrderKey(node, rootNode) : &_detachedNodeOrderKey);
+    }
     
     // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+    std::stable_sort(keyedListeners.begin(), keyedListeners.end(), [](const std::pair<EventListener*, const NodeOrderKey*>& l1, const std::pair<EventListener*, const NodeOrderKey*>& l2) {
+        return isNodeOrderedBefore(*l1.second, *l2.second);
     });
     
+    for (size_t i = 0, size = keyedListeners.size(); i < size; ++i)
+    {
+        (*sceneGraphListeners)[i] = keyedListeners[i].first;
+    }
+    
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global Z (%f), depth (%d)", l->_node ? typeid(*l->_node).name() : "null", l->_node,
+            l->_node ? l->_node->getGlobalZOrder() : 0.0f, l->_node ? (int)getNodeOrderKey(l->_node, rootNode).path.size() : 0);
     }
 #endif
 }
@@ -1529,6 +1579,10 @@ bool EventDispatcher::isEnabled() const
 
 void EventDispatcher::setDirtyForNode(Node* node)
 {
+    // Nothing to reorder, skip walking the subtree
+    if (_nodeListenersMap.empty())
+        return;
+    
     // Mark the node dirty only when there is an eventlistener associated with it. 
     if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
     {
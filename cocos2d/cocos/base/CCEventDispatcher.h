@@ -49,6 +49,8 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class Touch;
+class TouchHitGrid;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -292,8 +294,10 @@ protected:
      *      order by viewport/camera first, because the touch location convert
      *      to 3D world space is different by different camera.
      *  When listener process touch event, can get current camera by Camera::getVisitingCamera().
+     *  If hitTestTouch is not null, scene graph listeners with hit area culling are
+     *  only called when the touch hits their node.
      */
-    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, const Touch* hitTestTouch);
     
     void releaseListener(EventListener* listener);
     
@@ -309,8 +313,20 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Position of a node in the scene graph priority order */
+    struct NodeOrderKey
+    {
+        bool inScene = false;
+        float globalZOrder = 0.0f;
+        /** Local Z order and arrival of each node on the path from the root, root excluded */
+        std::vector<std::int64_t> path;
+    };
+    
+    /** Gets the cached order key of a node, computing it from its ancestors if needed */
+    const NodeOrderKey& getNodeOrderKey(Node* node, Node* rootNode);
+    
+    /** Whether a listener of the first node is called before one of the second */
+    static bool isNodeOrderedBefore(const NodeOrderKey& k1, const NodeOrderKey& k2);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
@@ -324,11 +340,14 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
+    /** Cached order keys of the nodes with listeners, invalidated through setDirtyForNode */
+    std::unordered_map<Node*, NodeOrderKey> _nodeOrderKeys;
+    
+    /** The scene the order keys were computed for */
+    Node* _nodeOrderRoot;
     
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** Order key of listeners that lost their node */
+    NodeOrderKey _detachedNodeOrderKey;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -345,7 +364,8 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
+    /** Spatial index of the one-by-one touch listeners, used for touch began hit-testing */
+    TouchHitGrid* _touchHitGrid;
     
     std::set<std::string> _internalCustomListenerIDs;
 };
@@ -175,6 +175,7 @@ protected:
     bool _paused;           // Whether the listener is paused
     bool _isEnabled;        // Whether the listener is enabled
     friend class EventDispatcher;
+    friend class TouchHitGrid;
 };
 
 NS_CC_END
@@ -68,6 +68,22 @@ public:
      * @return True if needs to swall touches.
      */
     bool isSwallowTouches();
+
+    /** Whether to skip onTouchBegan for touches outside the associated node.
+     *
+     * When enabled, EventDispatcher may skip this listener for touches that do not hit
+     * the content rect of its node, using a spatial index instead of asking every listener.
+     * Only enable it when onTouchBegan rejects such touches anyway, e.g. after a hitTest.
+     * Nodes with an empty content size or a 3D transform are never skipped.
+     *
+     * @param enabled True to cull touch began events by the node's bounds.
+     */
+    void setHitAreaCulling(bool enabled) { _hitAreaCulling = enabled; }
+    /** Is hit area culling enabled or not.
+     *
+     * @return True if touch began events are culled by the node's bounds.
+     */
+    bool isHitAreaCulling() const { return _hitAreaCulling; }
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -91,6 +107,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _hitAreaCulling;
     
     friend class EventDispatcher;
 };
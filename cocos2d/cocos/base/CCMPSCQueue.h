@@ -0,0 +1,149 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __BASE_CCMPSCQUEUE_H__
+#define __BASE_CCMPSCQUEUE_H__
+/// @cond DO_NOT_SHOW
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * Unbounded multi-producer single-consumer queue.
+ *
+ * push() may be called from any thread and never blocks: it links a new node with a single atomic exchange.
+ * pop(), empty() and the destructor must only be called from the consumer thread.
+ * Based on Dmitry Vyukov's intrusive MPSC node-based queue.
+ */
+template <typename T>
+class MPSCQueue
+{
+public:
+    MPSCQueue()
+    : _head(&_stub)
+    , _tail(&_stub)
+    , _size(0)
+    {
+        _stub.next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue()
+    {
+        T value;
+        while (pop(value))
+        {
+        }
+    }
+
+    /** Appends a value. Thread safe. */
+    void push(T&& value)
+    {
+        Node* node = new (std::nothrow) Node(std::move(value));
+        if (node)
+        {
+            // counted first, so the size never drops below the number of linked values
+            _size.fetch_add(1, std::memory_order_release);
+            pushNode(node);
+        }
+    }
+
+    /** Removes the oldest value. Consumer thread only.
+     * @return False if the queue is empty, or if the oldest producer hasn't finished linking its value yet;
+     *         in both cases the caller can simply try again later.
+     */
+    bool pop(T& value)
+    {
+        Node* tail = _tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &_stub)
+        {
+            if (next == nullptr)
+                return false;
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next == nullptr)
+        {
+            // tail is the last linked node, unless a producer is in the middle of a push
+            if (tail != _head.load(std::memory_order_acquire))
+                return false;
+
+            // put the stub back so that tail can be handed out
+            pushNode(&_stub);
+            next = tail->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+                return false;
+        }
+
+        _tail = next;
+        value = std::move(tail->value);
+        delete tail;
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /** Number of values pushed and not popped yet. Exact on the consumer thread, approximate elsewhere. */
+    size_t size() const { return _size.load(std::memory_order_acquire); }
+
+    /** Whether the queue looks empty. Cheap enough to be polled every frame. */
+    bool empty() const { return size() == 0; }
+
+private:
+    struct Node
+    {
+        Node() {}
+        explicit Node(T&& v) : value(std::move(v)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    void pushNode(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    std::atomic<Node*> _head;   // last pushed node, shared by the producers
+    Node* _tail;                // next node to pop, consumer only
+    Node _stub;
+    std::atomic<size_t> _size;
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif // __BASE_CCMPSCQUEUE_H__
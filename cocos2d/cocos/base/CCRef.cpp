@@ -83,72 +83,92 @@ Ref::~Ref()
 
 
 #if CC_REF_LEAK_DETECTION
-    if (_referenceCount != 0)
+    if (getReferenceCount() != 0)
         untrackRef(this);
 #endif
 }
 
 void Ref::retain()
 {
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    CCASSERT(_referenceCount.value.load(std::memory_order_relaxed) > 0, "reference count should be greater than 0");
+    _referenceCount.value.fetch_add(1, std::memory_order_relaxed);
+#else
     CCASSERT(_referenceCount > 0, "reference count should be greater than 0");
     ++_referenceCount;
+#endif
 }
 
 void Ref::release()
 {
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    // acq_rel: the thread dropping the last reference must see every write made by the previous owners
+    const unsigned int previousCount = _referenceCount.value.fetch_sub(1, std::memory_order_acq_rel);
+    CCASSERT(previousCount > 0, "reference count should be greater than 0");
+    if (previousCount == 1)
+    {
+        destroyUnreferenced();
+    }
+#else
     CCASSERT(_referenceCount > 0, "reference count should be greater than 0");
     --_referenceCount;
 
     if (_referenceCount == 0)
     {
+        destroyUnreferenced();
+    }
+#endif
+}
+
+void Ref::destroyUnreferenced()
+{
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
-        auto poolManager = PoolManager::getInstance();
-        if (!poolManager->getCurrentPool()->isClearing() && poolManager->isObjectInPools(this))
-        {
-            // Trigger an assert if the reference count is 0 but the Ref is still in autorelease pool.
-            // This happens when 'autorelease/release' were not used in pairs with 'new/retain'.
-            //
-            // Wrong usage (1):
-            //
-            // auto obj = Node::create();   // Ref = 1, but it's an autorelease Ref which means it was in the autorelease pool.
-            // obj->autorelease();   // Wrong: If you wish to invoke autorelease several times, you should retain `obj` first.
-            //
-            // Wrong usage (2):
-            //
-            // auto obj = Node::create();
-            // obj->release();   // Wrong: obj is an autorelease Ref, it will be released when clearing current pool.
-            //
-            // Correct usage (1):
-            //
-            // auto obj = Node::create();
-            //                     |-   new Node();     // `new` is the pair of the `autorelease` of next line
-            //                     |-   autorelease();  // The pair of `new Node`.
-            //
-            // obj->retain();
-            // obj->autorelease();  // This `autorelease` is the pair of `retain` of previous line.
-            //
-            // Correct usage (2):
-            //
-            // auto obj = Node::create();
-            // obj->retain();
-            // obj->release();   // This `release` is the pair of `retain` of previous line.
-            CCASSERT(false, "The reference shouldn't be 0 because it is still in autorelease pool.");
-        }
+    auto poolManager = PoolManager::getInstance();
+    if (!poolManager->getCurrentPool()->isClearing() && poolManager->isObjectInPools(this))
+    {
+        // Trigger an assert if the reference count is 0 but the Ref is still in autorelease pool.
+        // This happens when 'autorelease/release' were not used in pairs with 'new/retain'.
+        //
+        // Wrong usage (1):
+        //
+        // auto obj = Node::create();   // Ref = 1, but it's an autorelease Ref which means it was in the autorelease pool.
+        // obj->autorelease();   // Wrong: If you wish to invoke autorelease several times, you should retain `obj` first.
+        //
+        // Wrong usage (2):
+        //
+        // auto obj = Node::create();
+        // obj->release();   // Wrong: obj is an autorelease Ref, it will be released when clearing current pool.
+        //
+        // Correct usage (1):
+        //
+        // auto obj = Node::create();
+        //                     |-   new Node();     // `new` is the pair of the `autorelease` of next line
+        //                     |-   autorelease();  // The pair of `new Node`.
+        //
+        // obj->retain();
+        // obj->autorelease();  // This `autorelease` is the pair of `retain` of previous line.
+        //
+        // Correct usage (2):
+        //
+        // auto obj = Node::create();
+        // obj->retain();
+        // obj->release();   // This `release` is the pair of `retain` of previous line.
+        CCASSERT(false, "The reference shouldn't be 0 because it is still in autorelease pool.");
+    }
 #endif
 
 #if CC_ENABLE_SCRIPT_BINDING
-        ScriptEngineProtocol* pEngine = ScriptEngineManager::getInstance()->getScriptEngine();
-        if (pEngine != nullptr && pEngine->getScriptType() == kScriptTypeJavascript)
-        {
-            pEngine->removeObjectProxy(this);
-        }
+    ScriptEngineProtocol* pEngine = ScriptEngineManager::getInstance()->getScriptEngine();
+    if (pEngine != nullptr && pEngine->getScriptType() == kScriptTypeJavascript)
+    {
+        pEngine->removeObjectProxy(this);
+    }
 #endif // CC_ENABLE_SCRIPT_BINDING
 
 #if CC_REF_LEAK_DETECTION
-        untrackRef(this);
+    untrackRef(this);
 #endif
-        delete this;
-    }
+    delete this;
 }
 
 Ref* Ref::autorelease()
@@ -159,7 +179,11 @@ Ref* Ref::autorelease()
 
 unsigned int Ref::getReferenceCount() const
 {
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    return _referenceCount.value.load(std::memory_order_relaxed);
+#else
     return _referenceCount;
+#endif
 }
 
 #if CC_REF_LEAK_DETECTION
@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/ccConfig.h"
 
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#include <atomic>
+#endif
+
 #define CC_REF_LEAK_DETECTION 0
 
 /**
@@ -134,8 +138,30 @@ public:
     virtual ~Ref();
 
 protected:
+#if CC_ENABLE_ATOMIC_REFERENCE_COUNT
+    /** Atomic counter that keeps Ref copyable, a copy starts from the count of its source like the plain counter does. */
+    struct ReferenceCount
+    {
+        ReferenceCount(unsigned int count) : value(count) {}
+        ReferenceCount(const ReferenceCount& other) : value(other.value.load(std::memory_order_relaxed)) {}
+        ReferenceCount& operator=(const ReferenceCount& other)
+        {
+            value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        std::atomic<unsigned int> value;
+    };
+
+    /// count of references
+    ReferenceCount _referenceCount;
+#else
     /// count of references
     unsigned int _referenceCount;
+#endif
+
+    /** Destroys the Ref once its last reference has been released. */
+    void destroyUnreferenced();
 
     friend class AutoreleasePool;
 
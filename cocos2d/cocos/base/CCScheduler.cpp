@@ -25,48 +25,162 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
-
 #include "base/CCScheduler.h"
+
+#include <algorithm>
+
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
+// An entry of the per-frame "updates with priority"
+typedef struct _updateEntry
 {
-    struct _listEntry   *prev, *next;
     ccSchedulerFunc     callback;
     void                *target;
     int                 priority;
     bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
+    bool                markedForDeletion; // callback will no longer be called and entry will be removed at the next tick
+} tUpdateEntry;
 
-typedef struct _hashUpdateEntry
+// The entries sharing a priority, called in the order they were scheduled
+typedef struct _updateBucket
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
+    int                         priority;
+    std::vector<tUpdateEntry*>  entries;
+} tUpdateBucket;
 
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
+// The timers of a target, used for lookup, pause and unschedule
+typedef struct _timerTargetEntry
 {
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
+    std::vector<Timer*> timers; // retained
     bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+} tTimerTargetEntry;
+
+// A timer waiting for its tick. The slot is stale when the timer was re-armed, paused or aborted since.
+typedef struct _timerWheelEntry
+{
+    Timer               *timer; // retained
+    unsigned int        generation;
+    uint64_t            dueTick;
+} tTimerWheelEntry;
+
+// Hierarchical timing wheel: a timer is only looked at when its tick comes, instead of on every frame.
+// Level 0 has one slot per tick, each upper level slot covers a whole turn of the level below and is
+// cascaded down when that turn starts.
+typedef struct _timerWheel
+{
+    static const int        TICKS_PER_SECOND = 1000;
+    static const int        LEVEL0_BITS = 8;
+    static const int        LEVEL_BITS = 6;
+    static const int        UPPER_LEVELS = 3;
+    static const uint64_t   LEVEL0_SIZE = 1 << LEVEL0_BITS;
+    static const uint64_t   LEVEL_SIZE = 1 << LEVEL_BITS;
+    static const uint64_t   MAX_DELTA = (uint64_t)1 << (LEVEL0_BITS + LEVEL_BITS * UPPER_LEVELS);
+
+    std::vector<tTimerWheelEntry>   level0[LEVEL0_SIZE];
+    std::vector<tTimerWheelEntry>   levels[UPPER_LEVELS][LEVEL_SIZE];
+    uint64_t                        currentTick = 0;
+    size_t                          count = 0;
+
+    std::vector<tTimerWheelEntry>   frameTimers; // timers updated on every tick
+    std::vector<tTimerWheelEntry>   dueTimers;   // timers updated in the current tick
+
+    void insert(const tTimerWheelEntry& entry)
+    {
+        uint64_t delta = entry.dueTick - currentTick;
+        ++count;
+        if (delta < LEVEL0_SIZE)
+        {
+            level0[entry.dueTick & (LEVEL0_SIZE - 1)].push_back(entry);
+            return;
+        }
+
+        // Timers beyond the wheel wait in the last slot range and are cascaded again until they fit.
+        uint64_t tick = delta < MAX_DELTA ? entry.dueTick : currentTick + MAX_DELTA - 1;
+        for (int level = 0; level < UPPER_LEVELS; ++level)
+        {
+            int shift = LEVEL0_BITS + LEVEL_BITS * level;
+            if (delta < ((uint64_t)1 << (shift + LEVEL_BITS)) || level == UPPER_LEVELS - 1)
+            {
+                levels[level][(tick >> shift) & (LEVEL_SIZE - 1)].push_back(entry);
+                return;
+            }
+        }
+    }
+
+    // Moves the timers of an upper level slot to the levels below, returns the slot index.
+    uint64_t cascade(int level)
+    {
+        uint64_t index = (currentTick >> (LEVEL0_BITS + LEVEL_BITS * level)) & (LEVEL_SIZE - 1);
+        std::vector<tTimerWheelEntry> entries;
+        entries.swap(levels[level][index]);
+        count -= entries.size();
+        for (const auto& entry : entries)
+        {
+            if (entry.dueTick <= currentTick)
+            {
+                ++count;
+                level0[currentTick & (LEVEL0_SIZE - 1)].push_back(entry);
+            }
+            else
+            {
+                insert(entry);
+            }
+        }
+        return index;
+    }
+
+    // Advances to tick and appends the timers that are due to dueTimers.
+    void advance(uint64_t tick)
+    {
+        if (count == 0)
+        {
+            currentTick = std::max(currentTick, tick);
+            return;
+        }
+
+        while (currentTick < tick && count > 0)
+        {
+            ++currentTick;
+            if ((currentTick & (LEVEL0_SIZE - 1)) == 0)
+            {
+                for (int level = 0; level < UPPER_LEVELS && cascade(level) == 0; ++level)
+                {
+                }
+            }
+
+            auto& slot = level0[currentTick & (LEVEL0_SIZE - 1)];
+            if (!slot.empty())
+            {
+                count -= slot.size();
+                dueTimers.insert(dueTimers.end(), slot.begin(), slot.end());
+                slot.clear();
+            }
+        }
+        currentTick = std::max(currentTick, tick);
+    }
+
+    template <typename Function>
+    void forEach(Function function)
+    {
+        for (auto& slot : level0)
+            for (auto& entry : slot)
+                function(entry);
+        for (auto& level : levels)
+            for (auto& slot : level)
+                for (auto& entry : slot)
+                    function(entry);
+        for (auto& entry : frameTimers)
+            function(entry);
+        for (auto& entry : dueTimers)
+            function(entry);
+    }
+} tTimerWheel;
 
 // implementation Timer
 
@@ -80,6 +194,9 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _lastUpdateTime(0.0)
+, _pausedElapsed(0.0f)
+, _wheelGeneration(0)
 {
 }
 
@@ -252,86 +369,165 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler()
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _clock(0.0)
+, _deletedUpdateEntries(0)
+, _timerWheel(nullptr)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performSequence(0)
+, _performDiscardSequence(0)
+, _performFunctionsTimeBudget(0.0f)
+, _performLatencySum(0.0)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    _timerWheel = new (std::nothrow) tTimerWheel();
 }
 
 Scheduler::~Scheduler()
 {
     unscheduleAll();
-}
 
-void Scheduler::removeHashElement(_hashSelectorEntry *element)
-{
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    // release the entries still waiting for the next tick
+    flushUpdateEntries();
+    _timerWheel->forEach([](tTimerWheelEntry& entry) {
+        entry.timer->release();
+    });
+    CC_SAFE_DELETE(_timerWheel);
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+tTimerTargetEntry* Scheduler::getTimerTargetEntry(void *target, bool paused)
 {
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+    auto iter = _timerTargets.find(target);
+    if (iter != _timerTargets.end())
+    {
+        CCASSERT(iter->second->paused == paused, "element's paused should be paused!");
+        return iter->second;
+    }
+
+    // Is this the 1st element ? Then set the pause level to all the selectors of this target
+    auto element = new (std::nothrow) tTimerTargetEntry();
+    element->paused = paused;
+    element->timers.reserve(4);
+    _timerTargets.emplace(target, element);
+    return element;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+void Scheduler::removeTimerAtIndex(tTimerTargetEntry *element, void *target, size_t index)
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    // The timer may still sit in the wheel or be running, those hold their own reference.
+    Timer *timer = element->timers[index];
+    timer->setAborted();
+    element->timers.erase(element->timers.begin() + index);
+    timer->release();
 
-    if (! element)
+    if (element->timers.empty())
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+        _timerTargets.erase(target);
+        delete element;
+    }
+}
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+void Scheduler::armTimer(Timer *timer)
+{
+    // only one slot of a timer is live, older ones are dropped when their tick comes
+    tTimerWheelEntry entry;
+    entry.timer = timer;
+    entry.generation = ++timer->_wheelGeneration;
+    entry.dueTick = 0;
+    timer->retain();
+
+    // Timers which didn't start yet or fire on every frame are updated on every tick.
+    if (timer->_elapsed == -1 || (!timer->_useDelay && timer->_interval <= 0))
+    {
+        _timerWheel->frameTimers.push_back(entry);
+        return;
+    }
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+    // Rounding down may wake the timer up a tick early, Timer::update() then just re-arms it.
+    float remaining = (timer->_useDelay ? timer->_delay : timer->_interval) - timer->_elapsed;
+    double due = timer->_lastUpdateTime + std::max(0.0f, remaining);
+    entry.dueTick = (uint64_t)(due * tTimerWheel::TICKS_PER_SECOND);
+    if (entry.dueTick <= _timerWheel->currentTick)
+    {
+        _timerWheel->frameTimers.push_back(entry);
     }
     else
     {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
+        _timerWheel->insert(entry);
     }
+}
+
+void Scheduler::runDueTimers()
+{
+    auto& dueTimers = _timerWheel->dueTimers;
+    CCASSERT(dueTimers.empty(), "Scheduler::update can't be called recursively");
+
+    // Per-frame timers go first, then the timers whose tick came, in tick order.
+    dueTimers.swap(_timerWheel->frameTimers);
+    _timerWheel->advance((uint64_t)(_clock * tTimerWheel::TICKS_PER_SECOND));
 
-    if (element->timers == nullptr)
+    // Timers armed from the callbacks go to the wheel or to frameTimers, never to dueTimers.
+    for (size_t i = 0; i < dueTimers.size(); ++i)
     {
-        element->timers = ccArrayNew(10);
+        Timer *timer = dueTimers[i].timer;
+        if (dueTimers[i].generation == timer->_wheelGeneration && !timer->isAborted())
+        {
+            float dt = static_cast<float>(_clock - timer->_lastUpdateTime);
+            unsigned int generation = timer->_wheelGeneration;
+            timer->_lastUpdateTime = _clock;
+            timer->update(dt);
+
+            // not re-armed if the callback unscheduled, paused or rescheduled it
+            if (!timer->isAborted() && timer->_wheelGeneration == generation)
+            {
+                armTimer(timer);
+            }
+        }
+
+        // the slot's reference kept the timer alive while its callback ran
+        timer->release();
     }
-    else 
+    dueTimers.clear();
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
+
+    tTimerTargetEntry *element = getTimerTargetEntry(target, paused);
+
+    for (auto timer : element->timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        TimerTargetCallback *timerCallback = dynamic_cast<TimerTargetCallback*>(timer);
 
-            if (timer && !timer->isExhausted() && key == timer->getKey())
+        if (timerCallback && !timerCallback->isExhausted() && key == timerCallback->getKey())
+        {
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            timer->_pausedElapsed = 0;
+            if (! element->paused)
             {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
+                armTimer(timer);
             }
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    timer->_lastUpdateTime = _clock;
+    element->timers.push_back(timer);
+    if (! element->paused)
+    {
+        armTimer(timer);
+    }
 }
 
 void Scheduler::unschedule(const std::string &key, void *target)
@@ -342,139 +538,96 @@ void Scheduler::unschedule(const std::string &key, void *target)
         return;
     }
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
-
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto iter = _timerTargets.find(target);
+    if (iter == _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
-        {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
-
-            if (timer && key == timer->getKey())
-            {
-                if (timer == element->currentTimer && (! timer->isAborted()))
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
+        return;
+    }
 
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
+    tTimerTargetEntry *element = iter->second;
+    for (size_t i = 0; i < element->timers.size(); ++i)
+    {
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers[i]);
 
-                return;
-            }
+        if (timer && key == timer->getKey())
+        {
+            removeTimerAtIndex(element, target, i);
+            return;
         }
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::insertUpdateEntry(tUpdateEntry *entry)
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
+    // most of the updates are going to be 0, so there are only a few buckets
+    auto iter = std::lower_bound(_updateBuckets.begin(), _updateBuckets.end(), entry->priority,
+        [](const tUpdateBucket *bucket, int priority) { return bucket->priority < priority; });
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
-
-    // empty list ?
-    if (! *list)
+    if (iter == _updateBuckets.end() || (*iter)->priority != entry->priority)
     {
-        DL_APPEND(*list, listElement);
+        auto bucket = new (std::nothrow) tUpdateBucket();
+        bucket->priority = entry->priority;
+        iter = _updateBuckets.insert(iter, bucket);
     }
-    else
-    {
-        bool added = false;
 
-        for (tListEntry *element = *list; element; element = element->next)
+    (*iter)->entries.push_back(entry);
+}
+
+void Scheduler::flushUpdateEntries()
+{
+    CCASSERT(!_updateHashLocked, "Update entries can't be flushed during update");
+
+    // remove the entries unscheduled since the last tick
+    if (_deletedUpdateEntries > 0)
+    {
+        for (auto iter = _updateBuckets.begin(); iter != _updateBuckets.end(); )
         {
-            if (priority < element->priority)
-            {
-                if (element == *list)
+            auto& entries = (*iter)->entries;
+            auto last = std::remove_if(entries.begin(), entries.end(), [](tUpdateEntry *entry) {
+                if (entry->markedForDeletion)
                 {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
-
-                    element->prev->next = listElement;
-                    element->prev = listElement;
+                    delete entry;
+                    return true;
                 }
+                return false;
+            });
+            entries.erase(last, entries.end());
 
-                added = true;
-                break;
+            if (entries.empty())
+            {
+                delete *iter;
+                iter = _updateBuckets.erase(iter);
+            }
+            else
+            {
+                ++iter;
             }
         }
+    }
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+    // add the entries scheduled during the last tick
+    for (auto entry : _pendingUpdateEntries)
+    {
+        if (entry->markedForDeletion)
         {
-            DL_APPEND(*list, listElement);
+            delete entry;
+        }
+        else
+        {
+            insertUpdateEntry(entry);
         }
     }
-
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    memset(&hashElement->hh, 0, sizeof(hashElement->hh));
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
-}
-
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
-{
-    tListEntry *listElement = new (std::nothrow) tListEntry();
-
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
-
-    DL_APPEND(*list, listElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    memset(&hashElement->hh, 0, sizeof(hashElement->hh));
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    _pendingUpdateEntries.clear();
+    _deletedUpdateEntries = 0;
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    auto iter = _updateEntries.find(target);
+    if (iter != _updateEntries.end())
     {
         // change priority: should unschedule it first
-        if (hashElement->entry->priority != priority)
+        if (iter->second->priority != priority)
         {
             unscheduleUpdate(target);
         }
@@ -486,20 +639,22 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
+    tUpdateEntry *entry = new (std::nothrow) tUpdateEntry();
+    entry->callback = callback;
+    entry->target = target;
+    entry->priority = priority;
+    entry->paused = paused;
+    entry->markedForDeletion = false;
+    _updateEntries.emplace(target, entry);
+
+    // The buckets are being iterated, the entry will be called from the next tick on.
+    if (_updateHashLocked)
     {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
+        _pendingUpdateEntries.push_back(entry);
     }
     else
     {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
+        insertUpdateEntry(entry);
     }
 }
 
@@ -508,24 +663,17 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
+    auto iter = _timerTargets.find(const_cast<void*>(target));
+    if (iter == _timerTargets.end())
     {
         return false;
     }
     
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto timer : iter->second->timers)
     {
-        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        TimerTargetCallback *timerCallback = dynamic_cast<TimerTargetCallback*>(timer);
         
-        if (timer && !timer->isExhausted() && key == timer->getKey())
+        if (timerCallback && !timerCallback->isExhausted() && key == timerCallback->getKey())
         {
             return true;
         }
@@ -534,29 +682,6 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     return false;
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        if (!_updateHashLocked)
-            CC_SAFE_DELETE(element->entry);
-        else
-        {
-            element->entry->markedForDeletion = true;
-            _updateDeleteVector.push_back(element->entry);
-        }
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
-}
-
 void Scheduler::unscheduleUpdate(void *target)
 {
     if (target == nullptr)
@@ -564,10 +689,14 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
-        this->removeUpdateFromHash(element->entry);
+    auto iter = _updateEntries.find(target);
+    if (iter != _updateEntries.end())
+    {
+        // The entry is removed from its bucket on the next tick, so unscheduling is always safe during update.
+        iter->second->markedForDeletion = true;
+        _updateEntries.erase(iter);
+        ++_deletedUpdateEntries;
+    }
 }
 
 void Scheduler::unscheduleAll()
@@ -578,44 +707,29 @@ void Scheduler::unscheduleAll()
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    std::vector<void*> targets;
+    targets.reserve(_timerTargets.size() + _updateEntries.size());
+    for (const auto& iter : _timerTargets)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
-
-        element = nextElement;
+        targets.push_back(iter.first);
     }
-
-    // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto target : targets)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-        {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
-        }
+        unscheduleAllForTarget(target);
     }
 
-    if(minPriority <= 0)
+    // Updates selectors
+    targets.clear();
+    for (const auto& iter : _updateEntries)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
+        if (iter.second->priority >= minPriority)
         {
-            unscheduleUpdate(entry->target);
+            targets.push_back(iter.first);
         }
     }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    for (auto target : targets)
     {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        unscheduleUpdate(target);
     }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
@@ -631,27 +745,17 @@ void Scheduler::unscheduleAllForTarget(void *target)
     }
 
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-
-    if (element)
+    auto iter = _timerTargets.find(target);
+    if (iter != _timerTargets.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimer->isAborted()))
+        tTimerTargetEntry *element = iter->second;
+        for (auto timer : element->timers)
         {
-            element->currentTimer->retain();
-            element->currentTimer->setAborted();
-        }
-        ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
+            timer->setAborted();
+            timer->release();
         }
+        _timerTargets.erase(iter);
+        delete element;
     }
 
     // update selector
@@ -686,20 +790,24 @@ void Scheduler::resumeTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto iter = _timerTargets.find(target);
+    if (iter != _timerTargets.end() && iter->second->paused)
     {
-        element->paused = false;
+        iter->second->paused = false;
+        for (auto timer : iter->second->timers)
+        {
+            // continue from where the timer was paused
+            timer->_lastUpdateTime = _clock - timer->_pausedElapsed;
+            timer->_pausedElapsed = 0;
+            armTimer(timer);
+        }
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto updateIter = _updateEntries.find(target);
+    if (updateIter != _updateEntries.end())
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        updateIter->second->paused = false;
     }
 }
 
@@ -708,20 +816,23 @@ void Scheduler::pauseTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto iter = _timerTargets.find(target);
+    if (iter != _timerTargets.end() && !iter->second->paused)
     {
-        element->paused = true;
+        iter->second->paused = true;
+        for (auto timer : iter->second->timers)
+        {
+            // drop the pending slot and remember how far the timer got
+            timer->_pausedElapsed = static_cast<float>(_clock - timer->_lastUpdateTime);
+            ++timer->_wheelGeneration;
+        }
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    auto updateIter = _updateEntries.find(target);
+    if (updateIter != _updateEntries.end())
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        updateIter->second->paused = true;
     }
 }
 
@@ -730,19 +841,17 @@ bool Scheduler::isTargetPaused(void *target)
     CCASSERT( target != nullptr, "target must be non nil" );
 
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    auto iter = _timerTargets.find(target);
+    if (iter != _timerTargets.end())
     {
-        return element->paused;
+        return iter->second->paused;
     }
     
     // We should check update selectors if target does not have custom selectors
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if ( elementUpdate )
+    auto updateIter = _updateEntries.find(target);
+    if (updateIter != _updateEntries.end())
     {
-        return elementUpdate->entry->paused;
+        return updateIter->second->paused;
     }
     
     return false;  // should never get here
@@ -758,42 +867,19 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (const auto& iter : _timerTargets)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        pauseTarget(iter.first);
+        idsWithSelectors.insert(iter.first);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
-    {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
-        {
-            if(entry->priority >= minPriority)
-            {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
-            }
-        }
-    }
-
-    if(minPriority <= 0)
+    for (const auto& iter : _updateEntries)
     {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
+        if (iter.second->priority >= minPriority)
         {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            iter.second->paused = true;
+            idsWithSelectors.insert(iter.first);
         }
     }
 
@@ -809,109 +895,109 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    PerformFunctionEntry entry;
+    entry.function = std::move(function);
+    entry.queueTime = std::chrono::steady_clock::now();
+    entry.sequence = _performSequence.fetch_add(1, std::memory_order_relaxed);
+    _functionsToPerform.push(std::move(entry));
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+    // Only the cocos2d thread may pop, so the queued functions are skipped when their turn comes.
+    _performDiscardSequence.store(_performSequence.load(std::memory_order_relaxed), std::memory_order_release);
 }
 
-// main loop
-void Scheduler::update(float dt)
+void Scheduler::resetPerformFunctionStats()
 {
-    _updateHashLocked = true;
+    _performFunctionStats = PerformFunctionStats();
+    _performLatencySum = 0.0;
+}
 
-    if (_timeScale != 1.0f)
+void Scheduler::performFunctions()
+{
+    typedef std::chrono::duration<float, std::milli> Milliseconds;
+
+    auto& stats = _performFunctionStats;
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float>(_performFunctionsTimeBudget);
+    const uint64_t discardSequence = _performDiscardSequence.load(std::memory_order_acquire);
+
+    // Functions queued while these run wait for the next frame.
+    const size_t count = _functionsToPerform.size();
+    stats.queueDepth = count;
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, count);
+    stats.lastFramePerformed = 0;
+
+    auto now = start;
+    PerformFunctionEntry entry;
+    for (size_t processed = 0; processed < count && _functionsToPerform.pop(entry); )
     {
-        dt *= _timeScale;
-    }
+        ++processed;
+        if (entry.sequence < discardSequence)
+        {
+            continue;
+        }
 
-    //
-    // Selector callbacks
-    //
+        float latency = Milliseconds(now - entry.queueTime).count();
+        _performLatencySum += latency;
+        stats.maxLatency = std::max(stats.maxLatency, latency);
+        ++stats.totalPerformed;
+        ++stats.lastFramePerformed;
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
+        entry.function();
+        // release the captures now, not when the next entry is popped
+        entry.function = nullptr;
 
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        now = std::chrono::steady_clock::now();
+        if (_performFunctionsTimeBudget > 0 && now - start >= budget && processed < count)
         {
-            entry->callback(dt);
+            ++stats.budgetExceededFrames;
+            break;
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    stats.lastFrameTime = Milliseconds(now - start).count();
+    if (stats.totalPerformed > 0)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
+        stats.averageLatency = static_cast<float>(_performLatencySum / stats.totalPerformed);
     }
+}
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+// main loop
+void Scheduler::update(float dt)
+{
+    flushUpdateEntries();
+
+    _updateHashLocked = true;
+
+    if (_timeScale != 1.0f)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
-        {
-            entry->callback(dt);
-        }
+        dt *= _timeScale;
     }
+    _clock += dt;
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+    //
+    // Selector callbacks
+    //
 
-        if (! _currentTarget->paused)
+    // Iterate over all the Updates' selectors, in priority order.
+    // The buckets don't change while locked: new entries wait in _pendingUpdateEntries.
+    for (auto bucket : _updateBuckets)
+    {
+        for (auto entry : bucket->entries)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
+            if ((! entry->paused) && (! entry->markedForDeletion))
             {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
+                entry->callback(dt);
             }
         }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
     }
- 
-    // delete all updates that are removed in update
-    for (auto &e : _updateDeleteVector)
-        delete e;
 
-    _updateDeleteVector.clear();
+    // Iterate over the custom selectors whose time has come
+    runDueTimers();
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -939,17 +1025,9 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
+    // Testing size is cheap and almost never there will be functions scheduled to be called.
     if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
+        performFunctions();
     }
 }
 
@@ -957,48 +1035,33 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
 {
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    tTimerTargetEntry *element = getTimerTargetEntry(target, paused);
     
-    if (! element)
+    for (auto timer : element->timers)
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+        TimerTargetSelector *timerSelector = dynamic_cast<TimerTargetSelector*>(timer);
         
-        HASH_ADD_PTR(_hashForTimers, target, element);
-        
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
-    }
-    else
-    {
-        CCASSERT(element->paused == paused, "element's paused should be paused.");
-    }
-    
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
-    {
-        for (int i = 0; i < element->timers->num; ++i)
+        if (timerSelector && !timerSelector->isExhausted() && selector == timerSelector->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && !timer->isExhausted() && selector == timer->getSelector())
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            timer->_pausedElapsed = 0;
+            if (! element->paused)
             {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
+                armTimer(timer);
             }
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+    timer->_lastUpdateTime = _clock;
+    element->timers.push_back(timer);
+    if (! element->paused)
+    {
+        armTimer(timer);
+    }
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1011,24 +1074,17 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, const Ref *target) const
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
-    
-    if (element->timers == nullptr)
+    auto iter = _timerTargets.find(const_cast<Ref*>(target));
+    if (iter == _timerTargets.end())
     {
         return false;
     }
 
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto timer : iter->second->timers)
     {
-        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+        TimerTargetSelector *timerSelector = dynamic_cast<TimerTargetSelector*>(timer);
         
-        if (timer && !timer->isExhausted() && selector == timer->getSelector())
+        if (timerSelector && !timerSelector->isExhausted() && selector == timerSelector->getSelector())
         {
             return true;
         }
@@ -1045,45 +1101,21 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
         return;
     }
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (element)
+    auto iter = _timerTargets.find(target);
+    if (iter == _timerTargets.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        return;
+    }
+
+    tTimerTargetEntry *element = iter->second;
+    for (size_t i = 0; i < element->timers.size(); ++i)
+    {
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers[i]);
+        
+        if (timer && selector == timer->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && selector == timer->getSelector())
-            {
-                if (timer == element->currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
-                
-                return;
-            }
+            removeTimerAtIndex(element, target, i);
+            return;
         }
     }
 }
@@ -29,13 +29,17 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
-#include "base/uthash.h"
+#include "base/CCMPSCQueue.h"
 
 NS_CC_BEGIN
 
@@ -72,6 +76,12 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // Bookkeeping of the scheduler's timing wheel
+    friend class Scheduler;
+    double _lastUpdateTime;          // scheduler clock of the last update() call
+    float _pausedElapsed;            // time the timer had run since its last update when its target got paused
+    unsigned int _wheelGeneration;   // bumped whenever the pending wheel slot of the timer becomes stale
 };
 
 
@@ -140,9 +150,10 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
+struct _updateEntry;
+struct _updateBucket;
+struct _timerTargetEntry;
+struct _timerWheel;
 
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
@@ -422,7 +433,7 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and lock free. Functions run in the order they were queued, at the end of update().
      @param function The function to be run in cocos2d thread.
      @since v3.0
      @js NA
@@ -437,6 +448,41 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /** Statistics of the functions queued with performFunctionInCocosThread(). Times are in milliseconds. */
+    struct PerformFunctionStats
+    {
+        /** Functions waiting when the last frame started. */
+        size_t queueDepth = 0;
+        /** Highest queueDepth seen. */
+        size_t maxQueueDepth = 0;
+        /** Functions run by the last frame. */
+        size_t lastFramePerformed = 0;
+        /** Functions run since the statistics were reset. */
+        uint64_t totalPerformed = 0;
+        /** Frames that left functions for the next frame because the time budget ran out. */
+        unsigned int budgetExceededFrames = 0;
+        /** Time spent running functions in the last frame. */
+        float lastFrameTime = 0;
+        /** Average and highest time between queueing a function and running it. */
+        float averageLatency = 0;
+        float maxLatency = 0;
+    };
+
+    /** Limits the time update() spends running functions queued with performFunctionInCocosThread().
+     * Once the budget is spent the remaining functions wait for the next frame, so a burst of completions
+     * is spread over several frames instead of causing a spike. At least one function runs per frame.
+     * @param seconds The budget in seconds, 0 (the default) means no limit.
+     * @since v4.0
+     */
+    void setPerformFunctionsTimeBudget(float seconds) { _performFunctionsTimeBudget = seconds; }
+    float getPerformFunctionsTimeBudget() const { return _performFunctionsTimeBudget; }
+
+    /** Returns the statistics of performFunctionInCocosThread(). Must be called on the cocos2d thread.
+     * @since v4.0
+     */
+    const PerformFunctionStats& getPerformFunctionStats() const { return _performFunctionStats; }
+    void resetPerformFunctionStats();
     
 protected:
     
@@ -449,31 +495,40 @@ protected:
      */
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
-    void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+    struct _timerTargetEntry* getTimerTargetEntry(void *target, bool paused);
+    void removeTimerAtIndex(struct _timerTargetEntry *element, void *target, size_t index);
+
+    // timer specific
+
+    void armTimer(Timer *timer);
+    void runDueTimers();
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    void insertUpdateEntry(struct _updateEntry *entry);
+    void flushUpdateEntries();
+
+    // perform function specific
+
+    void performFunctions();
 
 
     float _timeScale;
+    // Scaled time accumulated by update(), the clock of the timing wheel
+    double _clock;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
-    std::vector<struct _listEntry *> _updateDeleteVector; // the vector holds list entries that needs to be deleted after update
+    std::vector<struct _updateBucket *> _updateBuckets;                   // one contiguous array per priority, sorted by priority
+    std::unordered_map<void*, struct _updateEntry *> _updateEntries;     // used to fetch quickly the entries for pause,delete,etc
+    std::vector<struct _updateEntry *> _pendingUpdateEntries;             // entries scheduled during update, added to the buckets on the next tick
+    size_t _deletedUpdateEntries;                                         // entries marked for deletion, removed from the buckets on the next tick
 
     // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
+    std::unordered_map<void*, struct _timerTargetEntry *> _timerTargets;
+    struct _timerWheel *_timerWheel;                                      // hierarchical timing wheel of the armed timers
+    // If true unschedule will not remove anything from the buckets. Entries will only be marked for deletion.
     bool _updateHashLocked;
     
 #if CC_ENABLE_SCRIPT_BINDING
@@ -481,8 +536,18 @@ protected:
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    struct PerformFunctionEntry
+    {
+        std::function<void()> function;
+        std::chrono::steady_clock::time_point queueTime;
+        uint64_t sequence;
+    };
+    MPSCQueue<PerformFunctionEntry> _functionsToPerform;
+    std::atomic<uint64_t> _performSequence;         // sequence of the next queued function
+    std::atomic<uint64_t> _performDiscardSequence;  // functions queued before this sequence were removed
+    float _performFunctionsTimeBudget;
+    PerformFunctionStats _performFunctionStats;
+    double _performLatencySum;
 };
 
 // end of base group
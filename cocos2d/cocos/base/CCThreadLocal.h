@@ -0,0 +1,108 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __BASE_CCTHREADLOCAL_H__
+#define __BASE_CCTHREADLOCAL_H__
+/// @cond DO_NOT_SHOW
+
+#include "platform/CCPlatformConfig.h"
+#include "platform/CCPlatformMacros.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+NS_CC_BEGIN
+
+/**
+ * A pointer holding one value per thread, on top of the platform TLS API.
+ *
+ * thread_local can't be used by the engine: Apple clang only supports it from iOS 9 on.
+ * Cleanup is called with the value of a thread when that thread exits, unless the value is null. A value set
+ * while the thread exits, by Cleanup or by the cleanup of another slot, is cleaned up in a further round; the
+ * platform only runs a few of them, so such values should be markers that own nothing.
+ * The slot is never freed, values may still be read by static destructors at exit. Create it once, e.g. as a
+ * function local static.
+ */
+template <typename T, void (*Cleanup)(T*)>
+class ThreadLocalPtr
+{
+public:
+    ThreadLocalPtr()
+    {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+        _index = FlsAlloc(&ThreadLocalPtr::onThreadExit);
+#else
+        pthread_key_create(&_key, &ThreadLocalPtr::onThreadExit);
+#endif
+    }
+
+    T* get() const
+    {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+        return static_cast<T*>(FlsGetValue(_index));
+#else
+        return static_cast<T*>(pthread_getspecific(_key));
+#endif
+    }
+
+    void set(T* value)
+    {
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+        FlsSetValue(_index, value);
+#else
+        pthread_setspecific(_key, value);
+#endif
+    }
+
+private:
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    static void NTAPI onThreadExit(void* value)
+#else
+    static void onThreadExit(void* value)
+#endif
+    {
+        if (value != nullptr)
+        {
+            Cleanup(static_cast<T*>(value));
+        }
+    }
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+    DWORD _index;
+#else
+    pthread_key_t _key;
+#endif
+
+    ThreadLocalPtr(const ThreadLocalPtr&) = delete;
+    ThreadLocalPtr& operator=(const ThreadLocalPtr&) = delete;
+};
+
+NS_CC_END
+
+/// @endcond
+#endif // __BASE_CCTHREADLOCAL_H__
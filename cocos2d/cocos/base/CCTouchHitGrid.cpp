@@ -0,0 +1,316 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCTouchHitGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/CCEventListenerTouch.h"
+#include "math/CCAffineTransform.h"
+#include "2d/CCNode.h"
+#include "2d/CCCamera.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const int MAX_GRID_SIDE = 32;
+
+    /** Entries spanning more cells than this fraction of the grid stay loose. */
+    const int WIDE_ENTRY_DIVISOR = 4;
+
+    bool isRectInside(const Rect& inner, const Rect& outer)
+    {
+        return inner.getMinX() >= outer.getMinX() && inner.getMaxX() <= outer.getMaxX()
+            && inner.getMinY() >= outer.getMinY() && inner.getMaxY() <= outer.getMaxY();
+    }
+
+    void insertSorted(std::vector<uint32_t>& indices, uint32_t index)
+    {
+        indices.insert(std::lower_bound(indices.begin(), indices.end(), index), index);
+    }
+
+    void eraseSorted(std::vector<uint32_t>& indices, uint32_t index)
+    {
+        auto it = std::lower_bound(indices.begin(), indices.end(), index);
+        if (it != indices.end() && *it == index)
+            indices.erase(it);
+    }
+
+    // The content rect (x, y, 0) must map to z = 0 through an affine transform
+    bool isPlanarTransform(const Mat4& m)
+    {
+        return m.m[2] == 0.0f && m.m[6] == 0.0f && m.m[14] == 0.0f
+            && m.m[3] == 0.0f && m.m[7] == 0.0f && m.m[11] == 0.0f && m.m[15] == 1.0f;
+    }
+}
+
+TouchHitGrid::TouchHitGrid()
+: _columns(0)
+, _rows(0)
+, _cellWidth(0.0f)
+, _cellHeight(0.0f)
+, _culledCount(0)
+, _outsideCount(0)
+{
+}
+
+void TouchHitGrid::update(const std::vector<EventListener*>& listeners)
+{
+    if (_listeners != listeners)
+    {
+        _listeners = listeners;
+        rebuild();
+        return;
+    }
+
+    // Only the nodes a visit moved or resized since the last update need new bounds
+    const size_t count = _listeners.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto listener = _listeners[i];
+        auto node = listener->getAssociatedNode();
+        bool culling = node != nullptr && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+            && static_cast<EventListenerTouchOneByOne*>(listener)->isHitAreaCulling();
+
+        auto& entry = _entries[i];
+        if (culling == entry.culling && (!culling || node->_transformVersion == entry.version))
+            continue;
+
+        auto index = static_cast<uint32_t>(i);
+        removeEntry(index);
+        if (entry.culled)
+            --_culledCount;
+        if (computeBounds(i))
+            ++_culledCount;
+        insertEntry(index);
+    }
+
+    // Too many listeners left the grid to be looked up by cell, size it again
+    if (_outsideCount > 0 && _outsideCount * WIDE_ENTRY_DIVISOR > _culledCount)
+    {
+        rebin();
+    }
+}
+
+bool TouchHitGrid::computeBounds(size_t index)
+{
+    auto& entry = _entries[index];
+    auto listener = _listeners[index];
+    auto node = listener->getAssociatedNode();
+
+    entry.culling = node != nullptr && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->isHitAreaCulling();
+    entry.culled = false;
+    if (!entry.culling)
+        return false;
+
+    entry.version = node->_transformVersion;
+
+    const Size& size = node->getContentSize();
+    if (size.width <= 0 || size.height <= 0)
+        return false;
+
+    const Mat4 transform = node->getNodeToWorldTransform();
+    if (!isPlanarTransform(transform))
+        return false;
+
+    entry.bounds = RectApplyTransform(Rect(0, 0, size.width, size.height), transform);
+    entry.culled = true;
+    return true;
+}
+
+void TouchHitGrid::rebuild()
+{
+    const size_t count = _listeners.size();
+    _entries.assign(count, Entry());
+    _culledCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (computeBounds(i))
+            ++_culledCount;
+    }
+
+    rebin();
+}
+
+void TouchHitGrid::rebin()
+{
+    _looseIndices.clear();
+    _cells.clear();
+    _columns = _rows = 0;
+    _outsideCount = 0;
+
+    bool first = true;
+    for (const auto& entry : _entries)
+    {
+        if (!entry.culled)
+            continue;
+
+        if (first)
+        {
+            _gridBounds = entry.bounds;
+            first = false;
+        }
+        else
+        {
+            _gridBounds.merge(entry.bounds);
+        }
+    }
+
+    if (_culledCount > 0 && _gridBounds.size.width > 0 && _gridBounds.size.height > 0)
+    {
+        int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(_culledCount))));
+        _columns = _rows = std::max(1, std::min(side, MAX_GRID_SIDE));
+        _cellWidth = _gridBounds.size.width / _columns;
+        _cellHeight = _gridBounds.size.height / _rows;
+    }
+    _cells.resize(_columns * _rows);
+
+    // Indices are inserted in increasing order, every run stays sorted
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        insertEntry(static_cast<uint32_t>(i));
+    }
+}
+
+bool TouchHitGrid::getCellRange(const Rect& r, int& x0, int& y0, int& x1, int& y1) const
+{
+    if (_columns == 0)
+        return false;
+
+    x0 = static_cast<int>(clampf(std::floor((r.getMinX() - _gridBounds.getMinX()) / _cellWidth), 0, _columns - 1));
+    x1 = static_cast<int>(clampf(std::floor((r.getMaxX() - _gridBounds.getMinX()) / _cellWidth), 0, _columns - 1));
+    y0 = static_cast<int>(clampf(std::floor((r.getMinY() - _gridBounds.getMinY()) / _cellHeight), 0, _rows - 1));
+    y1 = static_cast<int>(clampf(std::floor((r.getMaxY() - _gridBounds.getMinY()) / _cellHeight), 0, _rows - 1));
+
+    const int wideLimit = std::max(1, _columns * _rows / WIDE_ENTRY_DIVISOR);
+    return (x1 - x0 + 1) * (y1 - y0 + 1) <= wideLimit;
+}
+
+void TouchHitGrid::insertEntry(uint32_t index)
+{
+    auto& entry = _entries[index];
+    entry.x0 = entry.y0 = entry.x1 = entry.y1 = -1;
+    entry.outside = false;
+
+    if (entry.culled && _columns > 0)
+    {
+        // Cells only cover the grid bounds, a point outside of them is matched against the loose entries only
+        if (!isRectInside(entry.bounds, _gridBounds))
+        {
+            entry.outside = true;
+            ++_outsideCount;
+        }
+        else if (getCellRange(entry.bounds, entry.x0, entry.y0, entry.x1, entry.y1))
+        {
+            for (int y = entry.y0; y <= entry.y1; ++y)
+                for (int x = entry.x0; x <= entry.x1; ++x)
+                    insertSorted(_cells[y * _columns + x], index);
+            return;
+        }
+        else
+        {
+            entry.x0 = entry.y0 = entry.x1 = entry.y1 = -1;
+        }
+    }
+
+    insertSorted(_looseIndices, index);
+}
+
+void TouchHitGrid::removeEntry(uint32_t index)
+{
+    auto& entry = _entries[index];
+    if (entry.x0 >= 0)
+    {
+        for (int y = entry.y0; y <= entry.y1; ++y)
+            for (int x = entry.x0; x <= entry.x1; ++x)
+                eraseSorted(_cells[y * _columns + x], index);
+        return;
+    }
+
+    if (entry.outside)
+    {
+        entry.outside = false;
+        --_outsideCount;
+    }
+    eraseSorted(_looseIndices, index);
+}
+
+void TouchHitGrid::query(const Vec2& worldPoint, std::vector<EventListener*>& candidates) const
+{
+    candidates.clear();
+
+    const uint32_t* cell = nullptr;
+    const uint32_t* cellEnd = nullptr;
+    if (_columns > 0 && _gridBounds.containsPoint(worldPoint))
+    {
+        int x = std::min(static_cast<int>((worldPoint.x - _gridBounds.getMinX()) / _cellWidth), _columns - 1);
+        int y = std::min(static_cast<int>((worldPoint.y - _gridBounds.getMinY()) / _cellHeight), _rows - 1);
+        const auto& indices = _cells[y * _columns + x];
+        cell = indices.data();
+        cellEnd = indices.data() + indices.size();
+    }
+
+    // Merge the two sorted index runs to keep the listener order
+    auto loose = _looseIndices.begin();
+    auto looseEnd = _looseIndices.end();
+    while (loose != looseEnd || cell != cellEnd)
+    {
+        uint32_t index;
+        if (cell == cellEnd || (loose != looseEnd && *loose < *cell))
+        {
+            index = *loose++;
+        }
+        else
+        {
+            index = *cell++;
+        }
+
+        const auto& entry = _entries[index];
+        if (entry.culled && !entry.bounds.containsPoint(worldPoint))
+            continue;
+
+        candidates.push_back(_listeners[index]);
+    }
+}
+
+bool TouchHitGrid::locationToWorldPlane(const Camera* camera, const Vec2& location, Vec2* worldPoint)
+{
+    Vec3 nearPoint = camera->unprojectGL(Vec3(location.x, location.y, -1));
+    Vec3 farPoint = camera->unprojectGL(Vec3(location.x, location.y, 1));
+
+    float dz = farPoint.z - nearPoint.z;
+    if (std::abs(dz) < FLT_EPSILON)
+        return false;
+
+    float t = -nearPoint.z / dz;
+    worldPoint->x = nearPoint.x + t * (farPoint.x - nearPoint.x);
+    worldPoint->y = nearPoint.y + t * (farPoint.y - nearPoint.y);
+    return true;
+}
+
+NS_CC_END
@@ -0,0 +1,130 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_TOUCH_HIT_GRID_H__
+#define __CC_TOUCH_HIT_GRID_H__
+
+#include <vector>
+#include <cstdint>
+
+#include "platform/CCPlatformMacros.h"
+#include "math/CCGeometry.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/// @cond DO_NOT_SHOW
+
+class Camera;
+class EventListener;
+
+/**
+ * Uniform grid over the world-space bounds of scene graph priority touch listeners.
+ *
+ * EventDispatcher uses it to find the one-by-one touch listeners that may claim a
+ * touch in O(cell) instead of calling every listener's onTouchBegan. Only listeners
+ * with hit area culling enabled and whose node lies in the z = 0 world plane are
+ * indexed; every other listener is always returned, so the result is conservative.
+ * Candidates are returned in the order of the listener vector the grid was built
+ * from, which keeps scene graph priority semantics intact.
+ *
+ * The grid is kept across touches. It is only rebuilt when the listener vector
+ * changes; otherwise only the listeners whose node transform was recomputed by a
+ * visit since the last update are binned again.
+ */
+class TouchHitGrid
+{
+public:
+    TouchHitGrid();
+
+    /** Rebuilds the grid if the listener list changed, re-bins the listeners whose node moved otherwise. */
+    void update(const std::vector<EventListener*>& listeners);
+
+    /** Whether at least one listener is culled by its bounds. */
+    bool hasCulledListeners() const { return _culledCount > 0; }
+
+    /** Collects, in listener order, the listeners that may be hit at the world point. */
+    void query(const Vec2& worldPoint, std::vector<EventListener*>& candidates) const;
+
+    /** Intersects the camera ray through a GL location with the z = 0 world plane. */
+    static bool locationToWorldPlane(const Camera* camera, const Vec2& location, Vec2* worldPoint);
+
+private:
+    struct Entry
+    {
+        Rect bounds;
+        /** Node::_transformVersion the bounds were computed at. */
+        std::uint32_t version = 0;
+        /** isHitAreaCulling() when the entry was binned. */
+        bool culling = false;
+        /** Whether the listener is skipped for points outside its bounds. */
+        bool culled = false;
+        /** Whether the culled bounds left the grid bounds, the entry is loose then. */
+        bool outside = false;
+        /** Cell range holding the entry, x0 < 0 when it is loose. */
+        int x0 = -1;
+        int y0 = -1;
+        int x1 = -1;
+        int y1 = -1;
+    };
+
+    void rebuild();
+    /** Sizes the grid to the current bounds and bins every entry again. */
+    void rebin();
+    /** Computes the bounds of a listener, returns whether it can be culled by them. */
+    bool computeBounds(size_t index);
+    /** Finds the cells an entry covers, returns false if it must stay loose. */
+    bool getCellRange(const Rect& bounds, int& x0, int& y0, int& x1, int& y1) const;
+    void insertEntry(uint32_t index);
+    void removeEntry(uint32_t index);
+
+    std::vector<EventListener*> _listeners;
+    std::vector<Entry> _entries;
+    /** Sorted indices that are not stored in any cell. */
+    std::vector<uint32_t> _looseIndices;
+    /** Sorted indices per cell. */
+    std::vector<std::vector<uint32_t>> _cells;
+    Rect _gridBounds;
+    int _columns;
+    int _rows;
+    float _cellWidth;
+    float _cellHeight;
+    size_t _culledCount;
+    /** Culled entries that moved out of the grid bounds since the last rebuild. */
+    size_t _outsideCount;
+};
+
+/// @endcond
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_TOUCH_HIT_GRID_H__
@@ -29,129 +29,129 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
+#include <zlib.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <io.h>
+#include "platform/win32/CCUtils-win32.h"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // root name of xml
 #define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
 
 #define XML_FILE_NAME "UserDefault.xml"
+#define STORE_FILE_NAME "UserDefault.store"
+#define JOURNAL_FILE_NAME "UserDefault.journal"
 
 using namespace std;
 
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The store and the journal share one format: an 8 bytes header (magic and version) followed by records.
+ * A record is an op byte, the key and value lengths (uint32 each), the key and value bytes and a crc32
+ * of everything before it. The files never leave the device, so integers are kept in native byte order.
+ * A store is only valid when it ends with a RECORD_END record; the journal may end with a torn record,
+ * which is dropped together with anything after it.
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+namespace
 {
-    tinyxml2::XMLElement* curNode = nullptr;
-
-    // check the key value
-    if (! pKey)
-    {
-        return nullptr;
-    }
-
-    do 
-    {
-        tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
-        *rootNode = nullptr;
-
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
-
-        if (!xmlBuffer.empty())
-        {
-            xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
-
-            // get root node
-            *rootNode = xmlDoc->RootElement();
-        }
-
-        if (nullptr == *rootNode)
-        {
-            // try to insert xml declaration
-            if (!xmlDoc->FirstChild())
-            {
-                tinyxml2::XMLDeclaration *xmlDeclaration = xmlDoc->NewDeclaration(nullptr);
-                if (nullptr != xmlDeclaration)
-                {
-                    xmlDoc->LinkEndChild(xmlDeclaration);
-                }
-            }
+    const char STORE_MAGIC[4] = { 'C', 'C', 'U', 'S' };
+    const char JOURNAL_MAGIC[4] = { 'C', 'C', 'U', 'J' };
+    const uint32_t FORMAT_VERSION = 1;
+    const size_t HEADER_SIZE = 8;
+    const size_t RECORD_OVERHEAD = 13;
+
+    const unsigned char RECORD_SET = 1;
+    const unsigned char RECORD_DELETE = 2;
+    const unsigned char RECORD_END = 3;
+
+    // pending records are written right away instead of on the next frame once they reach this size
+    const size_t MAX_PENDING_SIZE = 64 * 1024;
+    // the journal is folded into the store once it is larger than both this and the store
+    const size_t MIN_COMPACTION_SIZE = 64 * 1024;
+}
 
-            // create root element
-            tinyxml2::XMLElement *rootEle = xmlDoc->NewElement(USERDEFAULT_ROOT_NAME);
-            if (nullptr == rootEle)
-                break;
+static void appendUInt32(std::string& out, uint32_t value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
 
-            xmlDoc->LinkEndChild(rootEle);
-            *rootNode = rootEle;
-        }
+static uint32_t readUInt32(const unsigned char* bytes)
+{
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
 
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
-        {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
-            {
-                break;
-            }
+static void appendHeader(std::string& out, const char* magic)
+{
+    out.append(magic, 4);
+    appendUInt32(out, FORMAT_VERSION);
+}
 
-            curNode = curNode->NextSiblingElement();
-        }
-    } while (0);
+static void appendRecordTo(std::string& out, unsigned char op, const std::string& key, const std::string& value)
+{
+    size_t start = out.size();
+    out.push_back(static_cast<char>(op));
+    appendUInt32(out, static_cast<uint32_t>(key.size()));
+    appendUInt32(out, static_cast<uint32_t>(value.size()));
+    out.append(key);
+    out.append(value);
+
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(out.data() + start), static_cast<uInt>(out.size() - start));
+    appendUInt32(out, static_cast<uint32_t>(crc));
+}
 
-    return curNode;
+static std::string getSiblingPath(const std::string& xmlFilePath, const char* fileName)
+{
+    return xmlFilePath.substr(0, xmlFilePath.size() - strlen(XML_FILE_NAME)) + fileName;
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+static bool syncFile(FILE* fp)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
+    if (fflush(fp) != 0)
     {
-        return;
+        return false;
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
-    {
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
-    }
-    else
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+// replace the file atomically, readers see either the old or the new content
+static bool replaceFile(const std::string& from, const std::string& to)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    return MoveFileExW(StringUtf8ToWideChar(from).c_str(), StringUtf8ToWideChar(to).c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(from.c_str(), to.c_str()) != 0)
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        return false;
     }
 
-    // save file and free doc
-    if (doc)
+    // make the rename itself durable before the journal is truncated
+    std::string dir = to.substr(0, to.find_last_of('/') + 1);
+    int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd >= 0)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        fsync(fd);
+        close(fd);
     }
+    return true;
+#endif
 }
 
 /**
@@ -164,6 +164,16 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    if (_isStoreLoaded)
+    {
+        writeJournal(true);
+    }
+
+    if (_journalFile)
+    {
+        fclose(_journalFile);
+        _journalFile = nullptr;
+    }
 }
 
 UserDefault::UserDefault()
@@ -177,26 +187,15 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* value = getValueForKey(pKey);
 
     bool ret = defaultValue;
 
     if (value)
     {
-        ret = (! strcmp(value, "true"));
+        ret = (*value == "true");
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -207,30 +206,15 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* value = getValueForKey(pKey);
 
     int ret = defaultValue;
 
     if (value)
     {
-        ret = atoi(value);
+        ret = atoi(value->c_str());
     }
 
-    if(doc)
-    {
-        delete doc;
-    }
-
-
     return ret;
 }
 
@@ -253,26 +237,15 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* value = getValueForKey(pKey);
 
     double ret = defaultValue;
 
     if (value)
     {
-        ret = utils::atof(value);
+        ret = utils::atof(value->c_str());
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -283,27 +256,9 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* value = getValueForKey(pKey);
 
-    string ret = defaultValue;
-
-    if (value)
-    {
-        ret = string(value);
-    }
-
-    if (doc) delete doc;
-
-    return ret;
+    return value ? *value : defaultValue;
 }
 
 Data UserDefault::getDataForKey(const char* pKey)
@@ -313,23 +268,14 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
-    }
+    const std::string* encodedData = getValueForKey(pKey);
     
     Data ret;
     
     if (encodedData)
     {
         unsigned char * decodedData = nullptr;
-        int decodedDataLen = base64Decode((unsigned char*)encodedData, (unsigned int)strlen(encodedData), &decodedData);
+        int decodedDataLen = base64Decode((const unsigned char*)encodedData->c_str(), (unsigned int)encodedData->size(), &decodedData);
         
         if (decodedData) {
             ret.fastSet(decodedData, decodedDataLen);
@@ -340,8 +286,6 @@ Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
         ret = defaultValue;
     }
     
-    if (doc) delete doc;
-    
     return ret;    
 }
 
@@ -405,7 +349,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    setValueForKey(pKey, value);
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -419,10 +363,11 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
     
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
         
-    setValueForKey(pKey, encodedData);
-    
     if (encodedData)
+    {
+        setValueForKey(pKey, encodedData);
         free(encodedData);
+    }
 }
 
 UserDefault* UserDefault::getInstance()
@@ -431,13 +376,6 @@ UserDefault* UserDefault::getInstance()
     {
         initXMLFilePath();
 
-        // only create xml file one time
-        // the file exists after the program exit
-        if ((!isXMLFileExist()) && (!createXMLFile()))
-        {
-            return nullptr;
-        }
-
         _userDefault = new (std::nothrow) UserDefault();
     }
 
@@ -472,77 +410,340 @@ void UserDefault::initXMLFilePath()
     }    
 }
 
-// create new xml file
-bool UserDefault::createXMLFile()
+const string& UserDefault::getXMLFilePath()
 {
-    bool bRet = false;  
-    tinyxml2::XMLDocument *pDoc = new (std::nothrow) tinyxml2::XMLDocument(); 
-    if (nullptr==pDoc)  
-    {  
-        return false;  
-    }  
-    tinyxml2::XMLDeclaration *pDeclaration = pDoc->NewDeclaration(nullptr);  
-    if (nullptr==pDeclaration)  
+    return _filePath;
+}
+
+void UserDefault::flush()
+{
+    loadStore();
+    writeJournal(true);
+}
+
+void UserDefault::deleteValueForKey(const char* key)
+{
+    // check the params
+    if (!key)
     {
-        delete pDoc;
-        return false;  
-    }  
-    pDoc->LinkEndChild(pDeclaration); 
-    tinyxml2::XMLElement *pRootEle = pDoc->NewElement(USERDEFAULT_ROOT_NAME);  
-    if (nullptr==pRootEle)  
+        CCLOG("the key is invalid");
+        return;
+    }
+
+    loadStore();
+
+    // if the value doesn't exist, don't need to delete
+    if (_values.erase(key) > 0)
+    {
+        appendRecord(RECORD_DELETE, key, "");
+    }
+}
+
+const std::string* UserDefault::getValueForKey(const char* key)
+{
+    if (!key)
     {
-        delete pDoc;
-        return false;  
-    }  
-    pDoc->LinkEndChild(pRootEle);  
-    bRet = tinyxml2::XML_SUCCESS == pDoc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(_filePath).c_str());
+        return nullptr;
+    }
 
-    delete pDoc;
+    loadStore();
 
-    return bRet;
+    auto iter = _values.find(key);
+    return iter != _values.end() ? &iter->second : nullptr;
 }
 
-const string& UserDefault::getXMLFilePath()
+void UserDefault::setValueForKey(const char* key, const std::string& value)
 {
-    return _filePath;
+    loadStore();
+
+    auto iter = _values.find(key);
+    if (iter != _values.end())
+    {
+        // saving the same value again is common, don't grow the journal for it
+        if (iter->second == value)
+        {
+            return;
+        }
+        iter->second = value;
+    }
+    else
+    {
+        _values.emplace(key, value);
+    }
+
+    appendRecord(RECORD_SET, key, value);
 }
 
-void UserDefault::flush()
+void UserDefault::appendRecord(unsigned char op, const std::string& key, const std::string& value)
 {
+    appendRecordTo(_pendingRecords, op, key, value);
+
+    if (_pendingRecords.size() >= MAX_PENDING_SIZE && _journalFile)
+    {
+        writeJournal(false);
+        return;
+    }
+
+    // write behind: all the changes made in this frame go to the journal with one write
+    if (!_isJournalWriteScheduled)
+    {
+        _isJournalWriteScheduled = true;
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([](){
+            if (_userDefault)
+            {
+                _userDefault->_isJournalWriteScheduled = false;
+                _userDefault->writeJournal(false);
+            }
+        });
+    }
 }
 
-void UserDefault::deleteValueForKey(const char* key)
+void UserDefault::loadStore()
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
+    if (_isStoreLoaded)
+    {
+        return;
+    }
+    _isStoreLoaded = true;
 
-    // check the params
-    if (!key)
+    initXMLFilePath();
+
+    bool needsCompaction = false;
+    if (!loadRecords(getSiblingPath(_filePath, STORE_FILE_NAME), true) && isXMLFileExist())
+    {
+        migrateXMLFile();
+        needsCompaction = true;
+    }
+
+    std::string journalPath = getSiblingPath(_filePath, JOURNAL_FILE_NAME);
+    bool journalExists = FileUtils::getInstance()->isFileExist(journalPath);
+    if (journalExists && !loadRecords(journalPath, false))
+    {
+        // appending behind a torn record would hide the new records, rewrite the journal first
+        needsCompaction = true;
+    }
+
+    if (!needsCompaction || !compact())
+    {
+        openJournal(!journalExists);
+    }
+}
+
+bool UserDefault::loadRecords(const std::string& path, bool isStore)
+{
+    Data data = FileUtils::getInstance()->getDataFromFile(path);
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    const unsigned char* bytes = data.getBytes();
+    ssize_t size = data.getSize();
+    if (size < (ssize_t)HEADER_SIZE
+        || memcmp(bytes, isStore ? STORE_MAGIC : JOURNAL_MAGIC, 4) != 0
+        || readUInt32(bytes + 4) != FORMAT_VERSION)
+    {
+        CCLOG("UserDefault: ignoring invalid file %s", path.c_str());
+        return false;
+    }
+
+    // a store is only used once it is known to be complete
+    std::unordered_map<std::string, std::string> storeValues;
+    auto& values = isStore ? storeValues : _values;
+
+    size_t offset = HEADER_SIZE;
+    bool isEnded = false;
+    while ((size_t)size - offset >= RECORD_OVERHEAD)
+    {
+        const unsigned char* record = bytes + offset;
+        size_t available = (size_t)size - offset - RECORD_OVERHEAD;
+        uint32_t keyLength = readUInt32(record + 1);
+        uint32_t valueLength = readUInt32(record + 5);
+        if (keyLength > available || valueLength > available - keyLength)
+        {
+            break;
+        }
+
+        size_t recordSize = 9 + keyLength + valueLength;
+        uLong crc = crc32(0L, record, static_cast<uInt>(recordSize));
+        if (readUInt32(record + recordSize) != static_cast<uint32_t>(crc))
+        {
+            break;
+        }
+
+        std::string key(reinterpret_cast<const char*>(record + 9), keyLength);
+        offset += recordSize + 4;
+
+        if (record[0] == RECORD_SET)
+        {
+            values[key].assign(reinterpret_cast<const char*>(record + 9 + keyLength), valueLength);
+        }
+        else if (record[0] == RECORD_DELETE)
+        {
+            values.erase(key);
+        }
+        else
+        {
+            isEnded = (record[0] == RECORD_END);
+            break;
+        }
+    }
+
+    if (isStore)
+    {
+        if (!isEnded)
+        {
+            CCLOG("UserDefault: ignoring incomplete file %s", path.c_str());
+            return false;
+        }
+        _values.swap(storeValues);
+        _storeSize = (size_t)size;
+        return true;
+    }
+
+    _journalSize = (size_t)size;
+    if (offset != (size_t)size)
+    {
+        CCLOG("UserDefault: dropped %d bytes at the end of %s", (int)((size_t)size - offset), path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void UserDefault::migrateXMLFile()
+{
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(_filePath);
+    if (xmlBuffer.empty())
     {
-        CCLOG("the key is invalid");
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
+    tinyxml2::XMLDocument doc;
+    doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
 
-    // if node not exist, don't need to delete
-    if (!node)
+    tinyxml2::XMLElement* rootNode = doc.RootElement();
+    if (nullptr == rootNode)
     {
-        CC_SAFE_DELETE(doc);
         return;
     }
 
-    // save file and free doc
-    if (doc)
+    for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+    {
+        // elements without text read back as the default value, keep it that way
+        if (node->FirstChild() && node->FirstChild()->Value())
+        {
+            // the first element of a key is the one that was read
+            _values.emplace(node->Value(), node->FirstChild()->Value());
+        }
+    }
+
+    CCLOG("UserDefault: migrated %d values from %s", (int)_values.size(), _filePath.c_str());
+}
+
+bool UserDefault::openJournal(bool truncate)
+{
+    if (_journalFile)
+    {
+        fclose(_journalFile);
+    }
+
+    std::string journalPath = getSiblingPath(_filePath, JOURNAL_FILE_NAME);
+    _journalFile = fopen(FileUtils::getInstance()->getSuitableFOpen(journalPath).c_str(), truncate ? "wb" : "ab");
+    if (!_journalFile)
+    {
+        CCLOG("UserDefault: can not open %s", journalPath.c_str());
+        return false;
+    }
+
+    if (truncate)
+    {
+        std::string header;
+        appendHeader(header, JOURNAL_MAGIC);
+        if (fwrite(header.data(), 1, header.size(), _journalFile) != header.size() || !syncFile(_journalFile))
+        {
+            CCLOG("UserDefault: can not write %s", journalPath.c_str());
+            fclose(_journalFile);
+            _journalFile = nullptr;
+            return false;
+        }
+        _journalSize = header.size();
+    }
+    return true;
+}
+
+void UserDefault::writeJournal(bool sync)
+{
+    if (!_isStoreLoaded)
+    {
+        return;
+    }
+
+    if (!_pendingRecords.empty())
+    {
+        if (!_journalFile
+            || fwrite(_pendingRecords.data(), 1, _pendingRecords.size(), _journalFile) != _pendingRecords.size()
+            || fflush(_journalFile) != 0)
+        {
+            // the journal may end with a torn record now, write everything to the store instead
+            if (_journalFile)
+            {
+                fclose(_journalFile);
+                _journalFile = nullptr;
+            }
+            compact();
+            return;
+        }
+
+        _journalSize += _pendingRecords.size();
+        _pendingRecords.clear();
+    }
+
+    if (sync && _journalFile)
+    {
+        syncFile(_journalFile);
+    }
+
+    if (_journalSize > MIN_COMPACTION_SIZE && _journalSize > _storeSize)
+    {
+        compact();
+    }
+}
+
+bool UserDefault::compact()
+{
+    std::string buffer;
+    appendHeader(buffer, STORE_MAGIC);
+    for (const auto& iter : _values)
+    {
+        appendRecordTo(buffer, RECORD_SET, iter.first, iter.second);
+    }
+    appendRecordTo(buffer, RECORD_END, "", "");
+
+    std::string storePath = getSiblingPath(_filePath, STORE_FILE_NAME);
+    std::string tempPath = storePath + ".tmp";
+
+    FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(tempPath).c_str(), "wb");
+    if (!fp)
+    {
+        CCLOG("UserDefault: can not open %s", tempPath.c_str());
+        return false;
+    }
+
+    bool written = fwrite(buffer.data(), 1, buffer.size(), fp) == buffer.size() && syncFile(fp);
+    fclose(fp);
+
+    if (!written || !replaceFile(tempPath, storePath))
     {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        CCLOG("UserDefault: can not write %s", storePath.c_str());
+        remove(FileUtils::getInstance()->getSuitableFOpen(tempPath).c_str());
+        return false;
     }
+    _storeSize = buffer.size();
 
-    flush();
+    // everything in the journal and the pending records is in the store now
+    _pendingRecords.clear();
+    openJournal(true);
+    return true;
 }
 
 NS_CC_END
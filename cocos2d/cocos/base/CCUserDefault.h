@@ -28,6 +28,8 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 #include <string>
+#include <cstdio>
+#include <unordered_map>
 #include "base/CCData.h"
 
 /**
@@ -45,8 +47,12 @@ NS_CC_BEGIN
  * It supports the following base types:
  * bool, int, float, double, string
  *
- * @warning: On windows, linux, use XML to store data, which means there are some limitations of
- * the key string, for example, `/` is not valid.
+ * On windows and linux values are kept in memory, so reads are a hash lookup. Every change is
+ * appended to a journal file (UserDefault.journal in the writable path) on the next frame, and the
+ * journal is compacted into a snapshot file (UserDefault.store) once it grows larger than the
+ * snapshot. The snapshot is replaced with an atomic rename, so an interrupted write never loses
+ * values that were already flushed. A UserDefault.xml file written by earlier versions is migrated
+ * the first time the store is loaded.
  */
 class CC_DLL UserDefault
 {
@@ -202,6 +208,9 @@ public:
     virtual void setDataForKey(const char* key, const Data& value);
     /**
      * You should invoke this function to save values set by setXXXForKey().
+     * On windows and linux, changes are written behind on the next frame; flush() writes them right
+     * away and waits until they reach the disk. Call it before the application may be killed, for
+     * example in AppDelegate::applicationDidEnterBackground().
      * @js NA
      */
     virtual void flush();
@@ -235,7 +244,8 @@ public:
     */
     static void setDelegate(UserDefault *delegate);
 
-    /** All supported platforms other iOS & Android use xml file to save values. This function is return the file path of the xml path.
+    /** All supported platforms other iOS & Android used xml file to save values. This function is return the file path of the xml path.
+     * On windows and linux the file is only read to migrate its values the first time the store is loaded.
      * @js NA
      */
     static const std::string& getXMLFilePath();
@@ -253,10 +263,28 @@ private:
     
     static bool createXMLFile();
     static void initXMLFilePath();
+
+    void loadStore();
+    bool loadRecords(const std::string& path, bool isStore);
+    void migrateXMLFile();
+    const std::string* getValueForKey(const char* key);
+    void setValueForKey(const char* key, const std::string& value);
+    void appendRecord(unsigned char op, const std::string& key, const std::string& value);
+    bool openJournal(bool truncate);
+    void writeJournal(bool sync);
+    bool compact();
     
     static UserDefault* _userDefault;
     static std::string _filePath;
     static bool _isFilePathInitialized;
+
+    std::unordered_map<std::string, std::string> _values;
+    std::string _pendingRecords;
+    FILE* _journalFile = nullptr;
+    size_t _journalSize = 0;
+    size_t _storeSize = 0;
+    bool _isStoreLoaded = false;
+    bool _isJournalWriteScheduled = false;
 };
 
 
@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCWorkerPool.h"
+#include "base/CCAutoreleasePool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+NS_CC_BEGIN
+
+namespace
+{
+    struct ParallelForState
+    {
+        std::atomic<size_t> nextRange{0};
+        std::atomic<size_t> finishedRanges{0};
+        size_t rangeCount = 0;
+        size_t count = 0;
+        size_t grain = 1;
+        const std::function<void(size_t, size_t)>* body = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        // Runs ranges until none is left, body is only used while a claimed range is unfinished
+        void run()
+        {
+            size_t range;
+            while ((range = nextRange.fetch_add(1)) < rangeCount)
+            {
+                size_t begin = range * grain;
+                (*body)(begin, std::min(begin + grain, count));
+                if (finishedRanges.fetch_add(1) + 1 == rangeCount)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+}
+
+WorkerPool* WorkerPool::s_sharedWorkerPool = nullptr;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if (s_sharedWorkerPool == nullptr)
+    {
+        // Leave one hardware thread to the cocos thread, but always have a worker for enqueue()
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        s_sharedWorkerPool = new (std::nothrow) WorkerPool(std::max(2u, hardwareThreads) - 1);
+    }
+    return s_sharedWorkerPool;
+}
+
+void WorkerPool::destroyInstance()
+{
+    delete s_sharedWorkerPool;
+    s_sharedWorkerPool = nullptr;
+}
+
+WorkerPool::WorkerPool(unsigned int workerCount)
+: _stop(false)
+{
+    _workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_jobs.empty())
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+        PoolManager::clearThreadPool();
+    }
+}
+
+void WorkerPool::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _condition.notify_one();
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max<size_t>(grain, 1);
+    size_t rangeCount = (count + grain - 1) / grain;
+    if (rangeCount == 1 || _workers.empty())
+    {
+        for (size_t begin = 0; begin < count; begin += grain)
+        {
+            body(begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    // Helpers may start after every range is done, they keep the state alive but won't touch body
+    auto state = std::make_shared<ParallelForState>();
+    state->rangeCount = rangeCount;
+    state->count = count;
+    state->grain = grain;
+    state->body = &body;
+
+    size_t helperCount = std::min<size_t>(_workers.size(), rangeCount - 1);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < helperCount; ++i)
+        {
+            _jobs.push_back([state] { state->run(); });
+        }
+    }
+    if (helperCount == 1)
+    {
+        _condition.notify_one();
+    }
+    else
+    {
+        _condition.notify_all();
+    }
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state] { return state->finishedRanges.load() == state->rangeCount; });
+}
+
+NS_CC_END
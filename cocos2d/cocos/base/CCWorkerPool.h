@@ -0,0 +1,107 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_WORKER_POOL_H__
+#define __CC_WORKER_POOL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * @class WorkerPool
+ * @brief A pool of worker threads, one per spare hardware thread, for CPU bound engine work.
+ *
+ * Unlike AsyncTaskPool, which runs long blocking IO tasks on a thread per task type,
+ * WorkerPool is meant for short jobs that are split across all cores and waited for,
+ * such as parallelFor over large arrays. parallelFor may be nested, the calling thread
+ * always works on the chunks itself, so it never waits on a queued job.
+ * @js NA
+ */
+class CC_DLL WorkerPool
+{
+public:
+    /** Returns the shared worker pool, starting its threads on first use. */
+    static WorkerPool* getInstance();
+
+    /** Stops the worker threads after they finish the queued jobs. */
+    static void destroyInstance();
+
+    /** Number of worker threads, the threads calling parallelFor are not included. */
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(_workers.size()); }
+
+    /**
+     * Calls body(begin, end) for consecutive ranges covering [0, count), at most grain items each.
+     * Ranges run concurrently on the workers and the calling thread, the call returns once all are done.
+     *
+     * @param count Number of items.
+     * @param grain Maximum number of items per range, 0 is treated as 1.
+     * @param body Function processing a range, must be safe to call concurrently.
+     */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+    /**
+     * Runs a job on a worker thread, without waiting for it.
+     *
+     * @param job The job to run.
+     */
+    void enqueue(std::function<void()> job);
+
+CC_CONSTRUCTOR_ACCESS:
+    explicit WorkerPool(unsigned int workerCount);
+    ~WorkerPool();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+    static WorkerPool* s_sharedWorkerPool;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+NS_CC_END
+
+// end of base group
+/// @}
+
+#endif // __CC_WORKER_POOL_H__
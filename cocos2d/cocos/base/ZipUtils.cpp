@@ -38,11 +38,14 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <set>
+#include <algorithm>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
+#include "base/CCWorkerPool.h"
 #include "platform/CCFileUtils.h"
 #include <map>
+#include <mutex>
 
 // minizip 1.2.0 is same with other platforms
 #define unzGoToFirstFile64(A,B,C,D) unzGoToFirstFile2(A,B,C,D, NULL, 0, NULL, 0)
@@ -144,13 +147,35 @@ inline unsigned int ZipUtils::checksumPvr(const unsigned int *data, ssize_t len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
+// Gzip streams end with the inflated size modulo 2^32, use it instead of guessing
+static ssize_t gzipInflatedSize(const unsigned char *in, ssize_t inLength)
+{
+    if (inLength < 18 || in[0] != 0x1F || in[1] != 0x8B)
+        return 0;
+
+    const unsigned char* trailer = in + inLength - 4;
+    return static_cast<ssize_t>(trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (static_cast<unsigned int>(trailer[3]) << 24));
+}
+
 int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint)
 {
     /* ret value */
     int err = Z_OK;
     
     ssize_t bufferSize = outLengthHint;
+    ssize_t gzipSize = gzipInflatedSize(in, inLength);
+    if (gzipSize > 0)
+    {
+        // one more byte, so the end of the stream is reached without growing the buffer
+        bufferSize = gzipSize + 1;
+    }
+    else if (bufferSize <= 0)
+    {
+        bufferSize = 256 * 1024;
+    }
     *out = (unsigned char*)malloc(bufferSize);
+    if (! *out)
+        return Z_MEM_ERROR;
     
     z_stream d_stream; /* decompression stream */
     d_stream.zalloc = (alloc_func)0;
@@ -184,31 +209,120 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
                 inflateEnd(&d_stream);
                 return err;
         }
+
+        if (err == Z_BUF_ERROR && d_stream.avail_in == 0)
+        {
+            // truncated stream, growing the buffer won't help
+            inflateEnd(&d_stream);
+            return Z_DATA_ERROR;
+        }
         
         // not enough memory ?
         if (err != Z_STREAM_END)
         {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
+            unsigned char* grown = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
             
             /* not enough memory, ouch */
-            if (! *out )
+            if (! grown )
             {
                 CCLOG("cocos2d: ZipUtils: realloc failed");
                 inflateEnd(&d_stream);
                 return Z_MEM_ERROR;
             }
+            *out = grown;
             
             d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = static_cast<unsigned int>(bufferSize);
+            d_stream.avail_out = static_cast<unsigned int>(bufferSize * (BUFFER_INC_FACTOR - 1));
             bufferSize *= BUFFER_INC_FACTOR;
         }
     }
     
     *outLength = bufferSize - d_stream.avail_out;
     err = inflateEnd(&d_stream);
+
+    // give back what a too large hint or the last growth left unused
+    if (*outLength > 0 && *outLength < bufferSize)
+    {
+        unsigned char* shrunk = (unsigned char*)realloc(*out, *outLength);
+        if (shrunk)
+            *out = shrunk;
+    }
     return err;
 }
 
+int ZipUtils::inflateMemoryInChunks(const unsigned char *in, ssize_t inLength, unsigned char *chunk, ssize_t chunkSize,
+                                    const std::function<bool(const unsigned char *data, ssize_t length)>& consumer)
+{
+    CCASSERT(chunk && chunkSize > 0, "Invalid chunk!");
+
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
+
+    d_stream.next_in  = const_cast<Bytef*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+
+    int err = inflateInit2(&d_stream, 15 + 32);
+    if (err != Z_OK)
+        return err;
+
+    do
+    {
+        d_stream.next_out = chunk;
+        d_stream.avail_out = static_cast<unsigned int>(chunkSize);
+
+        err = inflate(&d_stream, Z_NO_FLUSH);
+        if (err == Z_NEED_DICT)
+            err = Z_DATA_ERROR;
+        if (err != Z_OK && err != Z_STREAM_END)
+            break;
+
+        ssize_t decoded = chunkSize - d_stream.avail_out;
+        if (err == Z_OK && decoded == 0)
+        {
+            // no progress with room left in the chunk, the input is truncated
+            err = Z_DATA_ERROR;
+            break;
+        }
+        if (decoded > 0 && !consumer(chunk, decoded))
+        {
+            err = Z_OK;
+            break;
+        }
+    } while (err != Z_STREAM_END);
+
+    inflateEnd(&d_stream);
+    return err == Z_STREAM_END ? Z_OK : err;
+}
+
+ssize_t ZipUtils::inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength)
+{
+    z_stream d_stream; /* decompression stream */
+    d_stream.zalloc = (alloc_func)0;
+    d_stream.zfree = (free_func)0;
+    d_stream.opaque = (voidpf)0;
+
+    d_stream.next_in  = const_cast<Bytef*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+    d_stream.next_out = out;
+    d_stream.avail_out = static_cast<unsigned int>(outLength);
+
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+        return -1;
+
+    int err = inflate(&d_stream, Z_FINISH);
+    ssize_t inflated = outLength - d_stream.avail_out;
+    inflateEnd(&d_stream);
+
+    if (err != Z_STREAM_END)
+    {
+        CCLOG("cocos2d: ZipUtils: %s", err == Z_BUF_ERROR && d_stream.avail_out == 0 ? "buffer too small" : "Incorrect zlib compressed data!");
+        return -1;
+    }
+    return inflated;
+}
+
 ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint)
 {
     ssize_t outLength = 0;
@@ -510,12 +624,110 @@ struct ZipEntryInfo
 class ZipFilePrivate
 {
 public:
+    // An archive handle for one read at a time, minizip handles keep the current file and position
+    struct ReadHandle
+    {
+        unzFile file = nullptr;
+        std::unique_ptr<ourmemory_s> memfs;
+    };
+
     unzFile zipFile;
     std::unique_ptr<ourmemory_s> memfs;
     
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
+
+    // where more handles are opened from, the zip file path or the buffer
+    std::string zipFilePath;
+    const void* buffer = nullptr;
+    uLong bufferSize = 0;
+
+    // handles of finished reads, so concurrent readers don't share the position of zipFile
+    std::mutex handlesMutex;
+    std::vector<ReadHandle> freeHandles;
+
+    ~ZipFilePrivate()
+    {
+        for (auto& handle : freeHandles)
+        {
+            unzClose(handle.file);
+        }
+    }
+
+    ReadHandle acquireHandle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (!freeHandles.empty())
+            {
+                ReadHandle handle = std::move(freeHandles.back());
+                freeHandles.pop_back();
+                return handle;
+            }
+        }
+
+        ReadHandle handle;
+        if (buffer)
+        {
+            handle.memfs.reset(new(std::nothrow) ourmemory_t{ (char*)const_cast<void*>(buffer), static_cast<uint32_t>(bufferSize), 0, 0, 0 });
+            if (handle.memfs)
+            {
+                zlib_filefunc_def memory_file = { 0 };
+                fill_memory_filefunc(&memory_file, handle.memfs.get());
+                handle.file = unzOpen2(nullptr, &memory_file);
+            }
+        }
+        else if (!zipFilePath.empty())
+        {
+            handle.file = unzOpen(zipFilePath.c_str());
+        }
+        return handle;
+    }
+
+    void releaseHandle(ReadHandle&& handle)
+    {
+        if (!handle.file)
+            return;
+
+        std::lock_guard<std::mutex> lock(handlesMutex);
+        freeHandles.push_back(std::move(handle));
+    }
+
+    // Opens the file in handle, the caller closes it with unzCloseCurrentFile
+    bool openFile(const ReadHandle& handle, const std::string& fileName, uLong* size) const
+    {
+        if (!handle.file || fileName.empty())
+            return false;
+
+        FileListContainer::const_iterator it = fileList.find(fileName);
+        if (it == fileList.end())
+            return false;
+
+        ZipEntryInfo fileInfo = it->second;
+        if (unzGoToFilePos(handle.file, &fileInfo.pos) != UNZ_OK || unzOpenCurrentFile(handle.file) != UNZ_OK)
+            return false;
+
+        *size = fileInfo.uncompressed_size;
+        return true;
+    }
+
+    bool readFile(const std::string& fileName, ResizableBuffer* buffer)
+    {
+        ReadHandle handle = acquireHandle();
+        uLong size = 0;
+        bool res = false;
+        if (openFile(handle, fileName, &size))
+        {
+            buffer->resize(size);
+            int nSize = unzReadCurrentFile(handle.file, buffer->buffer(), static_cast<unsigned int>(size));
+            CCASSERT(nSize == 0 || nSize == (int)size, "the file size is wrong");
+            unzCloseCurrentFile(handle.file);
+            res = nSize == (int)size;
+        }
+        releaseHandle(std::move(handle));
+        return res;
+    }
 };
 
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
@@ -538,7 +750,8 @@ ZipFile::ZipFile()
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
+    _data->zipFilePath = FileUtils::getInstance()->getSuitableFOpen(zipFile);
+    _data->zipFile = unzOpen(_data->zipFilePath.c_str());
     setFilter(filter);
 }
 
@@ -646,69 +859,76 @@ std::vector<std::string> ZipFile::listFiles(const std::string &pathname) const
 
 unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 {
-    unsigned char * buffer = nullptr;
     if (size)
         *size = 0;
 
-    do
+    Data data;
+    ResizableBufferAdapter<Data> buffer(&data);
+    if (!getFileData(fileName, &buffer))
+        return nullptr;
+
+    ssize_t dataSize = 0;
+    unsigned char* bytes = data.takeBuffer(&dataSize);
+    if (size)
     {
-        CC_BREAK_IF(!_data->zipFile);
-        CC_BREAK_IF(fileName.empty());
-        
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
-        
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        
-        if (size)
-        {
-            *size = fileInfo.uncompressed_size;
-        }
-        unzCloseCurrentFile(_data->zipFile);
-    } while (0);
-    
-    return buffer;
+        *size = dataSize;
+    }
+    return bytes;
 }
 
 bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
 {
+    return _data->readFile(fileName, buffer);
+}
+
+bool ZipFile::readFileInChunks(const std::string &fileName, unsigned char *chunk, ssize_t chunkSize,
+                               const std::function<bool(const unsigned char *data, ssize_t length)>& consumer)
+{
+    CCASSERT(chunk && chunkSize > 0, "Invalid chunk!");
+
+    ZipFilePrivate::ReadHandle handle = _data->acquireHandle();
+    uLong size = 0;
     bool res = false;
-    do
+    if (_data->openFile(handle, fileName, &size))
     {
-        CC_BREAK_IF(!_data->zipFile);
-        CC_BREAK_IF(fileName.empty());
-        
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
-        
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer->resize(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer->buffer(), static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        unzCloseCurrentFile(_data->zipFile);
-        res = true;
-    } while (0);
-    
+        uLong remaining = size;
+        while (remaining > 0)
+        {
+            int nSize = unzReadCurrentFile(handle.file, chunk, static_cast<unsigned int>(std::min(static_cast<uLong>(chunkSize), remaining)));
+            if (nSize <= 0)
+                break;
+
+            remaining -= nSize;
+            if (!consumer(chunk, nSize))
+            {
+                remaining = 0;
+                break;
+            }
+        }
+        unzCloseCurrentFile(handle.file);
+        res = remaining == 0;
+    }
+    _data->releaseHandle(std::move(handle));
     return res;
 }
 
+std::vector<Data> ZipFile::getFilesData(const std::vector<std::string> &fileNames)
+{
+    std::vector<Data> files(fileNames.size());
+    // entries are independent, each worker inflates its own with a handle of the pool
+    WorkerPool::getInstance()->parallelFor(fileNames.size(), 1, [this, &fileNames, &files](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            ResizableBufferAdapter<Data> buffer(&files[i]);
+            if (!_data->readFile(fileNames[i], &buffer))
+            {
+                files[i].clear();
+            }
+        }
+    });
+    return files;
+}
+
 std::string ZipFile::getFirstFilename()
 {
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
@@ -752,6 +972,8 @@ bool ZipFile::initWithBuffer(const void *buffer, uLong size)
     _data->zipFile = unzOpen2(nullptr, &memory_file);
     if (!_data->zipFile) return false;
     _data->memfs = std::move(memfs);
+    _data->buffer = buffer;
+    _data->bufferSize = size;
 
     setFilter(emptyFilename);
     return true;
@@ -30,7 +30,9 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCFileUtils.h"
+#include <functional>
 #include <string>
+#include <vector>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtils-android.h"
@@ -90,6 +92,26 @@ typedef struct unz_file_info_s unz_file_info;
         */
         static ssize_t inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint);
 
+        /**
+        * Inflates either zlib or gzip deflated memory in fixed size chunks, without allocating the output.
+        * The consumer is called each time the chunk is full and once at the end of the stream.
+        *
+        * @param chunk Caller provided buffer receiving the inflated bytes, reused for every chunk.
+        * @param consumer Receives the inflated bytes of a chunk, returns false to stop inflating.
+        * @return Z_OK if the whole stream was inflated or the consumer stopped, a zlib error code otherwise.
+        * @since v4.0
+        */
+        static int inflateMemoryInChunks(const unsigned char *in, ssize_t inLength, unsigned char *chunk, ssize_t chunkSize,
+                                         const std::function<bool(const unsigned char *data, ssize_t length)>& consumer);
+
+        /**
+        * Inflates either zlib or gzip deflated memory into a caller provided buffer, when the inflated size is known.
+        *
+        * @return The inflated length, -1 if the data is corrupted or doesn't fit in the buffer.
+        * @since v4.0
+        */
+        static ssize_t inflateMemoryToBuffer(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength);
+
         /** 
          * Inflates a GZip file into memory.
          *
@@ -216,6 +238,9 @@ typedef struct unz_file_info_s unz_file_info;
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existence.
     *
+    * getFileData, readFileInChunks and getFilesData may be called from several threads at once,
+    * each read uses its own archive handle. The other methods must not run concurrently with them.
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -283,6 +308,27 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Reads a file of the zip file in fixed size chunks, without allocating a buffer for the whole file.
+        *
+        * @param fileName File name
+        * @param chunk Caller provided buffer receiving the file data, reused for every chunk.
+        * @param consumer Receives the data of a chunk, returns false to stop reading.
+        * @return True if the whole file was read or the consumer stopped.
+        * @since v4.0
+        */
+        bool readFileInChunks(const std::string &fileName, unsigned char *chunk, ssize_t chunkSize,
+                              const std::function<bool(const unsigned char *data, ssize_t length)>& consumer);
+
+        /**
+        * Reads several files of the zip file, decompressing them in parallel on the WorkerPool.
+        *
+        * @param fileNames Files to read.
+        * @return The data of the files, in the order of fileNames. The data of a file that can't be read is null.
+        * @since v4.0
+        */
+        std::vector<Data> getFilesData(const std::vector<std::string> &fileNames);
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
@@ -45,6 +45,28 @@ THE SOFTWARE.
 #define CC_ENABLE_STACKABLE_ACTIONS 1
 #endif
 
+/** @def CC_ENABLE_ACTION_POOL
+ * If enabled, Action objects and all their subclasses are allocated from free lists kept per object size
+ * instead of the system allocator. Short lived actions like CallFunc, FadeIn or Sequence then reuse the memory
+ * of finished ones. Pool statistics are printed by the "actionpool" console command.
+ * Enabled by default.
+ * @since v4.0
+ */
+#ifndef CC_ENABLE_ACTION_POOL
+#define CC_ENABLE_ACTION_POOL 1
+#endif
+
+/** @def CC_ENABLE_ATOMIC_REFERENCE_COUNT
+ * If enabled, Ref::retain() and Ref::release() update the reference count atomically, so objects created on
+ * worker threads (AsyncTaskPool, WorkerPool, the texture loader) can be retained and handed over to the cocos
+ * thread without bouncing their creation through Scheduler::performFunctionInCocosThread().
+ * Every retain/release then costs an atomic operation. Disabled by default.
+ * @since v4.0
+ */
+#ifndef CC_ENABLE_ATOMIC_REFERENCE_COUNT
+#define CC_ENABLE_ATOMIC_REFERENCE_COUNT 0
+#endif
+
 /** @def CC_ENABLE_GL_STATE_CACHE
  * If enabled, cocos2d will maintain an OpenGL state cache internally to avoid unnecessary switches.
  * In order to use them, you have to use the following functions, instead of the GL ones:
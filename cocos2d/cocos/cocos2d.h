@@ -67,6 +67,7 @@ THE SOFTWARE.
 
 // EventDispatcher
 #include "base/CCEventAcceleration.h"
+#include "base/CCEventChannel.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventFocus.h"
@@ -105,11 +106,13 @@ THE SOFTWARE.
 #include "2d/CCActionInstant.h"
 #include "2d/CCActionInterval.h"
 #include "2d/CCActionManager.h"
+#include "2d/CCActionPool.h"
 #include "2d/CCActionPageTurn3D.h"
 #include "2d/CCActionProgressTimer.h"
 #include "2d/CCActionTiledGrid.h"
 #include "2d/CCActionTween.h"
 #include "2d/CCTweenFunction.h"
+#include "2d/CCTweenSystem.h"
 
 // 2d nodes
 #include "2d/CCAtlasNode.h"
@@ -176,6 +179,8 @@ THE SOFTWARE.
 #include "platform/CCDevice.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCImage.h"
+#include "platform/CCMappedFile.h"
+#include "platform/CCFileArchive.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCSAXParser.h"
@@ -212,6 +217,8 @@ THE SOFTWARE.
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
     #include "platform/linux/CCApplication-linux.h"
     #include "platform/desktop/CCGLViewImpl-desktop.h"
+    #include "platform/desktop/CCGLViewNull-desktop.h"
+    #include "renderer/backend/null/DeviceNull.h"
     #include "platform/linux/CCGL-linux.h"
     #include "platform/linux/CCStdC-linux.h"
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
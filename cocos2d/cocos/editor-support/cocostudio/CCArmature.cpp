@@ -89,6 +89,8 @@ Armature::Armature()
     , _armatureTransformDirty(true)
     , _animation(nullptr)
 {
+    // the transform marks the armature dirty for its bones
+    setParallelTransformSafe(false);
 }
 
 
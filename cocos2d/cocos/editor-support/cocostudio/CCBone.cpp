@@ -79,6 +79,9 @@ Bone::Bone()
 
     _armatureParentBone = nullptr;
     _dataVersion = 0;
+
+    // bones share their world transforms along the chain of their armature
+    setParallelTransformSafe(false);
 }
 
 
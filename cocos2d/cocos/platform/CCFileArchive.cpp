@@ -0,0 +1,223 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "platform/CCFileArchive.h"
+
+#include <string.h>
+
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+
+#include <zlib.h>
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char ARCHIVE_MAGIC[4] = { 'C', 'C', 'P', 'K' };
+    const uint32_t ARCHIVE_VERSION = 1;
+
+    struct ArchiveHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t bucketBits;
+        uint64_t bucketsOffset;
+        uint64_t entriesOffset;
+        uint64_t namesOffset;
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 40, "the archive header is 40 bytes");
+    static_assert(sizeof(FileArchive::Entry) == 40, "an archive entry is 40 bytes");
+}
+
+std::shared_ptr<FileArchive> FileArchive::create(const std::string& path, MappedFile&& file)
+{
+    std::shared_ptr<FileArchive> archive(new (std::nothrow) FileArchive(path, std::move(file)));
+    if (archive && archive->init())
+    {
+        return archive;
+    }
+    return nullptr;
+}
+
+uint64_t FileArchive::hashName(const char* name, size_t length)
+{
+    // 64 bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+FileArchive::FileArchive(const std::string& path, MappedFile&& file)
+: _path(path)
+, _file(std::move(file))
+, _buckets(nullptr)
+, _entries(nullptr)
+, _names(nullptr)
+, _entryCount(0)
+, _bucketBits(0)
+{
+}
+
+bool FileArchive::init()
+{
+    const unsigned char* bytes = _file.getBytes();
+    uint64_t fileSize = static_cast<uint64_t>(_file.getSize());
+    if (_file.isNull() || fileSize < sizeof(ArchiveHeader))
+    {
+        return false;
+    }
+
+    ArchiveHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != ARCHIVE_VERSION)
+    {
+        CCLOG("cocos2d: FileArchive: %s isn't a version %u archive", _path.c_str(), ARCHIVE_VERSION);
+        return false;
+    }
+
+    uint64_t bucketCount = (1ULL << header.bucketBits) + 1;
+    uint64_t entriesSize = static_cast<uint64_t>(header.entryCount) * sizeof(Entry);
+    if (header.bucketBits > 24
+        || header.bucketsOffset % alignof(uint32_t) != 0 || header.bucketsOffset + bucketCount * sizeof(uint32_t) > fileSize
+        || header.entriesOffset % alignof(Entry) != 0 || header.entriesOffset + entriesSize > fileSize
+        || header.namesOffset > fileSize)
+    {
+        CCLOG("cocos2d: FileArchive: %s has a corrupted table of contents", _path.c_str());
+        return false;
+    }
+
+    _buckets = reinterpret_cast<const uint32_t*>(bytes + header.bucketsOffset);
+    _entries = reinterpret_cast<const Entry*>(bytes + header.entriesOffset);
+    _names = reinterpret_cast<const char*>(bytes + header.namesOffset);
+    _entryCount = header.entryCount;
+    _bucketBits = header.bucketBits;
+
+    // validate once, so lookups and reads don't need to
+    if (_buckets[bucketCount - 1] != _entryCount)
+    {
+        CCLOG("cocos2d: FileArchive: %s has a corrupted table of contents", _path.c_str());
+        return false;
+    }
+    uint64_t namesSize = fileSize - header.namesOffset;
+    for (uint64_t bucket = 0; bucket + 1 < bucketCount; ++bucket)
+    {
+        if (_buckets[bucket] > _buckets[bucket + 1])
+        {
+            CCLOG("cocos2d: FileArchive: %s has a corrupted table of contents", _path.c_str());
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        const Entry& entry = _entries[i];
+        if (entry.offset > fileSize || entry.storedSize > fileSize - entry.offset
+            || static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > namesSize
+            || (static_cast<Compression>(entry.compression) == Compression::STORE && entry.size != entry.storedSize))
+        {
+            CCLOG("cocos2d: FileArchive: %s has a corrupted entry %u", _path.c_str(), i);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const FileArchive::Entry* FileArchive::findEntry(const std::string& name) const
+{
+    uint64_t hash = hashName(name.data(), name.size());
+    uint64_t bucket = _bucketBits > 0 ? hash >> (64 - _bucketBits) : 0;
+
+    for (uint32_t i = _buckets[bucket], end = _buckets[bucket + 1]; i < end; ++i)
+    {
+        const Entry& entry = _entries[i];
+        if (entry.hash > hash)
+        {
+            break;
+        }
+        if (entry.hash == hash && entry.nameLength == name.size()
+            && memcmp(_names + entry.nameOffset, name.data(), name.size()) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+std::string FileArchive::getEntryName(const Entry* entry) const
+{
+    return std::string(_names + entry->nameOffset, entry->nameLength);
+}
+
+const unsigned char* FileArchive::getStoredBytes(const Entry* entry) const
+{
+    if (static_cast<Compression>(entry->compression) != Compression::STORE)
+    {
+        return nullptr;
+    }
+    return _file.getBytes() + entry->offset;
+}
+
+bool FileArchive::read(const Entry* entry, ResizableBuffer* buffer) const
+{
+    const unsigned char* storedBytes = _file.getBytes() + entry->offset;
+
+    switch (static_cast<Compression>(entry->compression))
+    {
+        case Compression::STORE:
+            buffer->resize(static_cast<size_t>(entry->size));
+            if (entry->size > 0)
+            {
+                memcpy(buffer->buffer(), storedBytes, static_cast<size_t>(entry->size));
+            }
+            return true;
+
+        case Compression::DEFLATE:
+        {
+            buffer->resize(static_cast<size_t>(entry->size));
+            uLongf size = static_cast<uLongf>(entry->size);
+            int result = uncompress(static_cast<Bytef*>(buffer->buffer()), &size, storedBytes, static_cast<uLong>(entry->storedSize));
+            if (result != Z_OK || size != entry->size)
+            {
+                CCLOG("cocos2d: FileArchive: failed to inflate %s from %s", getEntryName(entry).c_str(), _path.c_str());
+                buffer->resize(0);
+                return false;
+            }
+            return true;
+        }
+
+        default:
+            CCLOG("cocos2d: FileArchive: unsupported compression %u of %s in %s", entry->compression, getEntryName(entry).c_str(), _path.c_str());
+            return false;
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_FILE_ARCHIVE_H__
+#define __CC_FILE_ARCHIVE_H__
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCMappedFile.h"
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * @class FileArchive
+ * @brief A packed asset archive, mounted with FileUtils::mountArchive.
+ *
+ * The archive is written by tools/asset-packer/pack_assets.py. Its table of contents is used in place from the
+ * mapped file, so mounting costs one mapping and looking a file up costs no system call. All numbers are little endian.
+ *
+ * - Header, 40 bytes: magic "CCPK", uint32 version (1), uint32 entry count, uint32 bucket bits,
+ *   uint64 offset of the buckets, uint64 offset of the entries, uint64 offset of the names.
+ * - Buckets: (1 << bucket bits) + 1 uint32 entry indices. Bucket b holds the entries [buckets[b], buckets[b + 1])
+ *   whose hash has b as its top bucket bits.
+ * - Entries: 40 bytes each, 8 byte aligned and sorted by hash, see Entry.
+ * - Names: the UTF-8 paths of the entries, relative to the resource root with '/' separators, not terminated.
+ *
+ * The hash is the 64 bit FNV-1a hash of the name. Entry data is aligned as requested by the packer,
+ * so stored GPU texture formats can be uploaded straight from getStoredBytes().
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL FileArchive
+{
+public:
+    /** How the data of an entry is stored. */
+    enum class Compression : uint8_t
+    {
+        STORE = 0,
+        /** zlib stream. */
+        DEFLATE = 1,
+        /** Reserved, LZ4 isn't bundled with the engine and such entries can't be read. */
+        LZ4 = 2
+    };
+
+    /** An entry of the table of contents, as laid out in the file. */
+    struct Entry
+    {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t storedSize;
+        uint64_t size;
+        uint32_t nameOffset;
+        uint16_t nameLength;
+        uint8_t compression;
+        uint8_t alignmentLog2;
+    };
+
+    /**
+     * Opens an archive from its contents.
+     *
+     * @param path The full path of the archive, used as the prefix of the full paths of its entries.
+     * @param file The mapped archive.
+     * @return The archive, nullptr if the file isn't a valid archive.
+     */
+    static std::shared_ptr<FileArchive> create(const std::string& path, MappedFile&& file);
+
+    /** Hashes an entry name the way the packer does. */
+    static uint64_t hashName(const char* name, size_t length);
+
+    /** Gets the full path of the archive. */
+    const std::string& getPath() const { return _path; }
+
+    /** Gets the number of entries. */
+    uint32_t getEntryCount() const { return _entryCount; }
+
+    /**
+     * Finds an entry, without any system call.
+     *
+     * @param name The path of the file relative to the resource root, with '/' separators.
+     * @return The entry, nullptr if the archive doesn't contain the file.
+     */
+    const Entry* findEntry(const std::string& name) const;
+
+    /** Gets the name of an entry. */
+    std::string getEntryName(const Entry* entry) const;
+
+    /**
+     * Gets the entry.size bytes of a stored entry without copying them, valid as long as the archive.
+     *
+     * @return The data, nullptr if the entry is compressed.
+     */
+    const unsigned char* getStoredBytes(const Entry* entry) const;
+
+    /**
+     * Reads and, if needed, decompresses the data of an entry.
+     *
+     * @return False if the data is corrupted or uses an unsupported compression.
+     */
+    bool read(const Entry* entry, ResizableBuffer* buffer) const;
+
+private:
+    FileArchive(const std::string& path, MappedFile&& file);
+    bool init();
+
+    std::string _path;
+    MappedFile _file;
+    const uint32_t* _buckets;
+    const Entry* _entries;
+    const char* _names;
+    uint32_t _entryCount;
+    uint32_t _bucketBits;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(FileArchive);
+};
+
+NS_CC_END
+
+// end of platform group
+/// @}
+
+#endif // __CC_FILE_ARCHIVE_H__
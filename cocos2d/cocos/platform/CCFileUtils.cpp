@@ -553,6 +553,63 @@ void FileUtils::setDelegate(FileUtils *delegate)
     s_sharedFileUtils = delegate;
 }
 
+FileUtils::PathCache::Shard& FileUtils::PathCache::getShard(const std::string& key) const
+{
+    return _shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+bool FileUtils::PathCache::find(const std::string& key, std::string* value) const
+{
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.entries.find(key);
+    if (iter == shard.entries.end())
+        return false;
+
+    *value = *iter->second;
+    return true;
+}
+
+void FileUtils::PathCache::insert(const std::string& key, const std::string& value)
+{
+    const std::string* path;
+    {
+        std::lock_guard<std::mutex> lock(_pathsMutex);
+        path = &*_paths.insert(value).first;
+    }
+
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.emplace(key, path);
+}
+
+void FileUtils::PathCache::clear()
+{
+    // drop the entries first, no reader can reach an interned path once they are gone
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(_pathsMutex);
+    _paths.clear();
+}
+
+std::unordered_map<std::string, std::string> FileUtils::PathCache::snapshot() const
+{
+    std::unordered_map<std::string, std::string> ret;
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.entries)
+        {
+            ret.emplace(entry.first, *entry.second);
+        }
+    }
+    return ret;
+}
+
 FileUtils::FileUtils()
     : _writablePath("")
 {
@@ -659,6 +716,28 @@ void FileUtils::getDataFromFile(const std::string& filename, std::function<void(
     }, std::move(callback));
 }
 
+MappedFile FileUtils::mapFile(const std::string& filename) const
+{
+    MappedFile file;
+    if (filename.empty())
+        return file;
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return file;
+
+    if (!file.map(getSuitableFOpen(fullPath)))
+    {
+        // not a plain file on disk, or mmap isn't available
+        Data data;
+        if (getContents(fullPath, &data) == Status::OK)
+        {
+            file.adopt(std::move(data));
+        }
+    }
+    return file;
+}
+
 FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableBuffer* buffer) const
 {
     if (filename.empty())
@@ -670,6 +749,10 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    Status archiveStatus;
+    if (fs->getContentsFromArchive(fullPath, buffer, &archiveStatus))
+        return archiveStatus;
+
     std::string suitableFullPath = fs->getSuitableFOpen(fullPath);
 
     struct stat statBuf;
@@ -699,6 +782,93 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     return Status::OK;
 }
 
+bool FileUtils::mountArchive(const std::string& filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return false;
+
+    auto archive = FileArchive::create(fullPath, mapFile(fullPath));
+    if (!archive)
+    {
+        CCLOG("cocos2d: FileUtils: can't mount archive %s", fullPath.c_str());
+        return false;
+    }
+
+    DECLARE_GUARD;
+    auto archives = std::make_shared<ArchiveList>();
+    if (_mountedArchives)
+    {
+        for (const auto& mounted : *_mountedArchives)
+        {
+            if (mounted->getPath() != fullPath)
+                archives->push_back(mounted);
+        }
+    }
+    archives->push_back(std::move(archive));
+    std::atomic_store(&_mountedArchives, std::shared_ptr<const ArchiveList>(std::move(archives)));
+    // paths resolved before the mount may be shadowed by the archive
+    purgeCachedEntries();
+    return true;
+}
+
+void FileUtils::unmountArchive(const std::string& filename)
+{
+    std::string fullPath = fullPathForFilename(filename);
+
+    DECLARE_GUARD;
+    if (!_mountedArchives)
+        return;
+
+    auto archives = std::make_shared<ArchiveList>();
+    for (const auto& mounted : *_mountedArchives)
+    {
+        if (mounted->getPath() != fullPath)
+            archives->push_back(mounted);
+    }
+    if (archives->size() != _mountedArchives->size())
+    {
+        // readers holding the archive keep it alive until they are done
+        std::atomic_store(&_mountedArchives, std::shared_ptr<const ArchiveList>(std::move(archives)));
+        purgeCachedEntries();
+    }
+}
+
+const FileArchive::Entry* FileUtils::findArchiveEntry(const std::string& fullPath, std::shared_ptr<FileArchive>* archive) const
+{
+    auto archives = std::atomic_load(&_mountedArchives);
+    if (!archives)
+        return nullptr;
+
+    for (auto it = archives->rbegin(); it != archives->rend(); ++it)
+    {
+        const std::string& archivePath = (*it)->getPath();
+        if (fullPath.size() > archivePath.size() + 1 && fullPath[archivePath.size()] == '/'
+            && fullPath.compare(0, archivePath.size(), archivePath) == 0)
+        {
+            auto entry = (*it)->findEntry(fullPath.substr(archivePath.size() + 1));
+            if (entry)
+            {
+                *archive = *it;
+                return entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool FileUtils::getContentsFromArchive(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const
+{
+    std::shared_ptr<FileArchive> archive;
+    auto entry = findArchiveEntry(fullPath, &archive);
+    if (!entry)
+        return false;
+
+    // the archive is mapped and already validated, no need to hold the lock while inflating
+    *status = archive->read(entry, buffer) ? Status::OK : Status::ReadFailed;
+    return true;
+}
+
 unsigned char* FileUtils::getFileDataFromZip(const std::string& zipFilePath, const std::string& filename, ssize_t *size) const
 {
     unsigned char * buffer = nullptr;
@@ -804,9 +974,6 @@ std::string FileUtils::getPathForDirectory(const std::string &dir, const std::st
 
 std::string FileUtils::fullPathForFilename(const std::string &filename) const
 {
-    
-    DECLARE_GUARD;
-
     if (filename.empty())
     {
         return "";
@@ -817,17 +984,36 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return filename;
     }
 
-    // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if(cacheIter != _fullPathCache.end())
+    std::string fullpath;
+
+    // Already Cached ? Checked before taking the mutex, so that loading threads don't serialize on hits.
+    if (_fullPathCache.find(filename, &fullpath))
     {
-        return cacheIter->second;
+        return fullpath;
     }
 
+    DECLARE_GUARD;
+
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
-    std::string fullpath;
+    // Mounted archives shadow the search paths, the last mounted one first.
+    if (_mountedArchives)
+    {
+        for (auto it = _mountedArchives->rbegin(); it != _mountedArchives->rend(); ++it)
+        {
+            for (const auto& resolutionIt : _searchResolutionsOrderArray)
+            {
+                std::string entryName = resolutionIt + newFilename;
+                if ((*it)->findEntry(entryName))
+                {
+                    fullpath = (*it)->getPath() + '/' + entryName;
+                    _fullPathCache.insert(filename, fullpath);
+                    return fullpath;
+                }
+            }
+        }
+    }
 
     for (const auto& searchIt : _searchPathArray)
     {
@@ -838,7 +1024,7 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
             if (!fullpath.empty())
             {
                 // Using the filename passed in as key.
-                _fullPathCache.emplace(filename, fullpath);
+                _fullPathCache.insert(filename, fullpath);
                 return fullpath;
             }
 
@@ -856,8 +1042,6 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
 
 std::string FileUtils::fullPathForDirectory(const std::string &dir) const
 {
-    DECLARE_GUARD;
-
     if (dir.empty())
     {
         return "";
@@ -868,14 +1052,17 @@ std::string FileUtils::fullPathForDirectory(const std::string &dir) const
         return dir;
     }
 
+    std::string fullpath;
+
     // Already Cached ?
-    auto cacheIter = _fullPathCacheDir.find(dir);
-    if(cacheIter != _fullPathCacheDir.end())
+    if (_fullPathCacheDir.find(dir, &fullpath))
     {
-        return cacheIter->second;
+        return fullpath;
     }
+
+    DECLARE_GUARD;
+
     std::string longdir = dir;
-    std::string fullpath;
 
     if(longdir[longdir.length() - 1] != '/')
     {
@@ -892,7 +1079,7 @@ std::string FileUtils::fullPathForDirectory(const std::string &dir) const
             if (!fullpath.empty() && isDirectoryExistInternal(fullpath))
             {
                 // Using the filename passed in as key.
-                _fullPathCacheDir.emplace(dir, fullpath);
+                _fullPathCacheDir.insert(dir, fullpath);
                 return fullpath;
             }
 
@@ -1119,6 +1306,9 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::shared_ptr<FileArchive> archive;
+        if (findArchiveEntry(filename, &archive))
+            return true;
         return isFileExistInternal(filename);
     }
     else
@@ -1466,6 +1656,11 @@ long FileUtils::getFileSize(const std::string &filepath) const
             return 0;
     }
 
+    std::shared_ptr<FileArchive> archive;
+    auto entry = findArchiveEntry(fullpath, &archive);
+    if (entry)
+        return static_cast<long>(entry->size);
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
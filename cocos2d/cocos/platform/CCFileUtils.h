@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <type_traits>
 #include <mutex>
 
@@ -36,6 +38,8 @@ THE SOFTWARE.
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCMappedFile.h"
+#include "platform/CCFileArchive.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/CCScheduler.h"
 #include "base/CCDirector.h"
@@ -189,6 +193,37 @@ public:
      */
     virtual void getDataFromFile(const std::string& filename, std::function<void(Data)> callback) const;
 
+    /**
+     *  Maps a file into memory, without copying it into a buffer.
+     *  Use it instead of getDataFromFile for large files that are parsed once, like images and plists.
+     *  Falls back to a buffered read of the file if it can't be mapped.
+     *
+     *  @param filename filepath for the data to be mapped. Can be relative or absolute path
+     *  @return The mapped file, null if the file can't be read.
+     *  @since v4.0
+     */
+    virtual MappedFile mapFile(const std::string& filename) const;
+
+    /**
+     *  Mounts a packed asset archive, built by tools/asset-packer/pack_assets.py.
+     *  Files of the archive are found by fullPathForFilename before the search paths, in every resolution directory,
+     *  and read with getContents like files on disk. Their full path is the archive path followed by their name.
+     *  The archive mounted last is searched first.
+     *
+     *  @param filename The archive, relative or absolute path.
+     *  @return True if the archive was mounted.
+     *  @since v4.0
+     */
+    bool mountArchive(const std::string& filename);
+
+    /**
+     *  Unmounts an archive mounted with mountArchive.
+     *
+     *  @param filename The archive, as passed to mountArchive.
+     *  @since v4.0
+     */
+    void unmountArchive(const std::string& filename);
+
     enum class Status
     {
         OK = 0,
@@ -828,7 +863,7 @@ public:
     virtual void listFilesRecursivelyAsync(const std::string& dirPath, std::function<void(std::vector<std::string>)> callback) const;
 
     /** Returns the full path cache. */
-    const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache; }
+    const std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache.snapshot(); }
 
     /**
      *  Gets the new filename from the filename lookup dictionary.
@@ -840,6 +875,40 @@ public:
     virtual std::string getNewFilename(const std::string &filename) const;
 
 protected:
+    /**
+     *  A path cache that is safe to read from any thread.
+     *  Lookups only lock one of several shards for the time of a string copy, so loading threads resolving
+     *  paths don't contend with each other or with the search path walk, which keeps the FileUtils mutex.
+     *  Full paths are interned, keys resolving to the same file share one string.
+     *  @since v4.0
+     */
+    class CC_DLL PathCache
+    {
+    public:
+        /** Looks a key up, false if it isn't cached. */
+        bool find(const std::string& key, std::string* value) const;
+        void insert(const std::string& key, const std::string& value);
+        void clear();
+        std::unordered_map<std::string, std::string> snapshot() const;
+
+    private:
+        static const size_t SHARD_COUNT = 16;
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, const std::string*> entries;
+        };
+
+        Shard& getShard(const std::string& key) const;
+
+        mutable Shard _shards[SHARD_COUNT];
+        std::mutex _pathsMutex;
+        std::unordered_set<std::string> _paths;
+    };
+
+    typedef std::vector<std::shared_ptr<FileArchive>> ArchiveList;
+
     /**
      *  The default constructor.
      */
@@ -901,6 +970,25 @@ protected:
      */
     virtual std::string fullPathForDirectory(const std::string &dirname) const;
 
+    /**
+     *  Finds the archive entry of a full path returned by fullPathForFilename.
+     *
+     *  @param fullPath The full path.
+     *  @param archive Receives the archive holding the entry, keep it while using the entry.
+     *  @return The entry, nullptr if the path isn't in a mounted archive.
+     *  @since v4.0
+     */
+    const FileArchive::Entry* findArchiveEntry(const std::string& fullPath, std::shared_ptr<FileArchive>* archive) const;
+
+    /**
+     *  Reads a file of a mounted archive, called by the platforms' getContents before touching the file system.
+     *
+     *  @param status Receives the result if the path is in a mounted archive.
+     *  @return False if the path isn't in a mounted archive.
+     *  @since v4.0
+     */
+    bool getContentsFromArchive(const std::string& fullPath, ResizableBuffer* buffer, Status* status) const;
+
     /**
     * mutex used to protect fields. 
     */
@@ -946,13 +1034,19 @@ protected:
      *  The full path cache for normal files. When a file is found, it will be added into this cache.
      *  This variable is used for improving the performance of file search.
      */
-    mutable std::unordered_map<std::string, std::string> _fullPathCache;
+    mutable PathCache _fullPathCache;
 
     /**
      *  The full path cache for directories. When a diretory is found, it will be added into this cache.
      *  This variable is used for improving the performance of file search.
      */
-    mutable std::unordered_map<std::string, std::string> _fullPathCacheDir;
+    mutable PathCache _fullPathCacheDir;
+
+    /**
+     *  The mounted archives, the last one has the highest priority.
+     *  The list is immutable once published, mounting swaps in a new one, so readers load it without the mutex.
+     */
+    std::shared_ptr<const ArchiveList> _mountedArchives;
 
     /**
      * Writable path.
@@ -106,6 +106,7 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "renderer/CCTextureUtils.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtils-android.h"
 #endif
@@ -508,11 +509,12 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // decode straight from the mapped file, the image data is copied or unpacked anyway
+    MappedFile file = FileUtils::getInstance()->mapFile(_filePath);
 
-    if (!data.isNull())
+    if (!file.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(file.getBytes(), file.getSize());
     }
 
     return ret;
@@ -523,11 +525,12 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    // decode straight from the mapped file, the image data is copied or unpacked anyway
+    MappedFile file = FileUtils::getInstance()->mapFile(fullpath);
 
-    if (!data.isNull())
+    if (!file.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(file.getBytes(), file.getSize());
     }
 
     return ret;
@@ -2157,12 +2160,7 @@ void Image::premultiplyAlpha()
 #else
     CCASSERT(_pixelFormat == backend::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    backend::PixelFormatUtils::premultiplyAlphaRGBA8888(_data, (size_t)_width * _height * 4, _data);
     
     _hasPremultipliedAlpha = true;
 #endif
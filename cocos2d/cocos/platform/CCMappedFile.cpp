@@ -0,0 +1,140 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "platform/CCMappedFile.h"
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#define CC_MAPPED_FILE_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CC_MAPPED_FILE_USE_MMAP 0
+#endif
+
+NS_CC_BEGIN
+
+MappedFile::MappedFile()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+{
+}
+
+MappedFile::MappedFile(MappedFile&& other)
+: _bytes(other._bytes)
+, _size(other._size)
+, _mapped(other._mapped)
+, _data(std::move(other._data))
+{
+    other._bytes = nullptr;
+    other._size = 0;
+    other._mapped = false;
+}
+
+MappedFile::~MappedFile()
+{
+    clear();
+}
+
+MappedFile& MappedFile::operator= (MappedFile&& other)
+{
+    if (this != &other)
+    {
+        clear();
+        _bytes = other._bytes;
+        _size = other._size;
+        _mapped = other._mapped;
+        _data = std::move(other._data);
+
+        other._bytes = nullptr;
+        other._size = 0;
+        other._mapped = false;
+    }
+    return *this;
+}
+
+bool MappedFile::map(const std::string& fullPath)
+{
+    clear();
+
+#if CC_MAPPED_FILE_USE_MMAP
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) == -1 || !S_ISREG(statBuf.st_mode) || statBuf.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // private and writable: parsers working in place get copy-on-write pages, the file is never written
+    void* address = mmap(nullptr, static_cast<size_t>(statBuf.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        return false;
+    }
+
+    _bytes = static_cast<unsigned char*>(address);
+    _size = static_cast<ssize_t>(statBuf.st_size);
+    _mapped = true;
+    return true;
+#else
+    CC_UNUSED_PARAM(fullPath);
+    return false;
+#endif
+}
+
+void MappedFile::adopt(Data&& data)
+{
+    clear();
+
+    _data = std::move(data);
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+}
+
+void MappedFile::clear()
+{
+#if CC_MAPPED_FILE_USE_MMAP
+    if (_mapped)
+    {
+        munmap(_bytes, static_cast<size_t>(_size));
+    }
+#endif
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+NS_CC_END
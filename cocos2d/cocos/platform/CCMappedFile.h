@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_MAPPED_FILE_H__
+#define __CC_MAPPED_FILE_H__
+
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/**
+ * @class MappedFile
+ * @brief The contents of a file, mapped into memory instead of being read into a buffer.
+ *
+ * Decoders can parse a MappedFile in place, so large files don't need a second, heap allocated copy.
+ * The mapping is private and copy-on-write: the bytes may be modified, the file on disk never is,
+ * and only the touched pages take memory of their own. The bytes stay valid until the MappedFile is
+ * destroyed or cleared.
+ *
+ * Where a file can't be mapped, e.g. on Windows or for files inside the Android APK, the MappedFile holds
+ * a buffered read of the file instead, with the same interface.
+ *
+ * @see FileUtils::mapFile
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(MappedFile&& other);
+    ~MappedFile();
+
+    MappedFile& operator= (MappedFile&& other);
+
+    /**
+     * Maps a file into memory.
+     *
+     * @param fullPath The full path of the file, as passed to fopen.
+     * @return False if the file can't be mapped, the MappedFile is left empty then.
+     */
+    bool map(const std::string& fullPath);
+
+    /**
+     * Takes over a buffered read of a file, for the files that can't be mapped.
+     *
+     * @param data The contents of the file.
+     */
+    void adopt(Data&& data);
+
+    /** Unmaps the file, or releases the buffered contents. */
+    void clear();
+
+    /** Gets the address of the contents, valid as long as this MappedFile. */
+    unsigned char* getBytes() const { return _bytes; }
+
+    /** Gets the size of the contents. */
+    ssize_t getSize() const { return _size; }
+
+    /** Checks whether the MappedFile is empty. */
+    bool isNull() const { return _bytes == nullptr || _size == 0; }
+
+    /** Checks whether the contents are mapped, false for a buffered read. */
+    bool isMapped() const { return _mapped; }
+
+private:
+    unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+    Data _data;
+
+    CC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+NS_CC_END
+
+// end of platform group
+/// @}
+
+#endif // __CC_MAPPED_FILE_H__
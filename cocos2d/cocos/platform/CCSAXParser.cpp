@@ -90,10 +90,11 @@ bool SAXParser::parse(const char* xmlData, size_t dataLength)
 bool SAXParser::parse(const std::string& filename)
 {
     bool ret = false;
-    Data data = FileUtils::getInstance()->getDataFromFile(filename);
-    if (!data.isNull())
+    // the mapping is copy-on-write, so the in place parse only copies the pages it modifies
+    MappedFile file = FileUtils::getInstance()->mapFile(filename);
+    if (!file.isNull())
     {
-        ret = parseIntrusive((char*)data.getBytes(), data.getSize());
+        ret = parseIntrusive((char*)file.getBytes(), file.getSize());
     }
 
     return ret;
@@ -348,6 +348,10 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    FileUtils::Status archiveStatus;
+    if (getContentsFromArchive(fullPath, buffer, &archiveStatus))
+        return archiveStatus;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -0,0 +1,67 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/desktop/CCGLViewNull-desktop.h"
+
+NS_CC_BEGIN
+
+GLViewNull* GLViewNull::createWithRect(const std::string& viewName, Rect rect, unsigned int maxFrames)
+{
+    auto ret = new (std::nothrow) GLViewNull;
+    if(ret && ret->initWithRect(viewName, rect, maxFrames)) {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool GLViewNull::initWithRect(const std::string& viewName, Rect rect, unsigned int maxFrames)
+{
+    setViewName(viewName);
+    setFrameSize(rect.size.width, rect.size.height);
+    _maxFrames = maxFrames;
+    return true;
+}
+
+void GLViewNull::end()
+{
+    _shouldClose = true;
+    // Release self. Otherwise, GLViewNull could not be freed.
+    release();
+}
+
+void GLViewNull::swapBuffers()
+{
+    ++_frameCount;
+    if (_maxFrames > 0 && _frameCount >= _maxFrames)
+        _shouldClose = true;
+}
+
+bool GLViewNull::windowShouldClose()
+{
+    return _shouldClose;
+}
+
+NS_CC_END
@@ -0,0 +1,78 @@
+/****************************************************************************
+Copyright (c) 2017-2018 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include "base/CCRef.h"
+#include "platform/CCCommon.h"
+#include "platform/CCGLView.h"
+
+NS_CC_BEGIN
+
+/**
+ * A view without window or GL context, used together with backend::DeviceNull
+ * to run the engine headless for benchmarks and tests.
+ */
+class CC_DLL GLViewNull : public GLView
+{
+public:
+    /**
+     * @param viewName The view name.
+     * @param rect The frame size reported to the engine.
+     * @param maxFrames Close the view after this many frames, 0 means run until Director::end().
+     */
+    static GLViewNull* createWithRect(const std::string& viewName, Rect rect, unsigned int maxFrames = 0);
+
+    virtual void end() override;
+    virtual bool isOpenGLReady() override { return true; }
+    virtual void swapBuffers() override;
+    virtual void setIMEKeyboardState(bool open) override {}
+    virtual bool windowShouldClose() override;
+
+    /** Number of frames presented so far. */
+    unsigned int getFrameCount() const { return _frameCount; }
+
+    /** Set the number of frames after which windowShouldClose() returns true, 0 disables the limit. */
+    void setMaxFrames(unsigned int maxFrames) { _maxFrames = maxFrames; }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    virtual HWND getWin32Window() override { return nullptr; }
+#endif
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    virtual id getCocoaWindow() override { return nullptr; }
+    virtual id getNSGLContext() override { return nullptr; }
+#endif
+
+protected:
+    GLViewNull() = default;
+
+    bool initWithRect(const std::string& viewName, Rect rect, unsigned int maxFrames);
+
+    unsigned int _frameCount = 0;
+    unsigned int _maxFrames = 0;
+    bool _shouldClose = false;
+};
+
+NS_CC_END
@@ -176,6 +176,10 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    FileUtils::Status archiveStatus;
+    if (getContentsFromArchive(fullPath, buffer, &archiveStatus))
+        return archiveStatus;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -272,6 +276,11 @@ void FileUtilsWin32::listFilesRecursively(const std::string& dirPath, std::vecto
 
 long FileUtilsWin32::getFileSize(const std::string &filepath) const
 {
+    std::shared_ptr<FileArchive> archive;
+    auto entry = findArchiveEntry(filepath, &archive);
+    if (entry)
+        return static_cast<long>(entry->size);
+
     struct _stat tmp;
     if (_stat(filepath.c_str(), &tmp) == 0)
     {
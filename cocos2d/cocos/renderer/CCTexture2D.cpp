@@ -466,6 +466,67 @@ bool Texture2D::initWithImage(Image *image, backend::PixelFormat format)
     }
 }
 
+bool Texture2D::initWithImageStorage(Image *image, backend::PixelFormat format)
+{
+    if (image == nullptr || image->isCompressed() || image->getNumberOfMipmaps() > 1)
+    {
+        return false;
+    }
+
+    // RGBA8888 is the only format every backend uploads without converting it
+    backend::PixelFormat imagePixelFormat = image->getPixelFormat();
+    backend::PixelFormat renderFormat = ((PixelFormat::NONE == format) || (PixelFormat::AUTO == format)) ? imagePixelFormat : format;
+    if (imagePixelFormat != PixelFormat::RGBA8888 || renderFormat != imagePixelFormat)
+    {
+        return false;
+    }
+
+    if (!initWithStorage(imagePixelFormat, image->getWidth(), image->getHeight()))
+    {
+        return false;
+    }
+
+    _filePath = image->getFilePath();
+    _hasPremultipliedAlpha = image->hasPremultipliedAlpha();
+
+    return true;
+}
+
+bool Texture2D::initWithStorage(backend::PixelFormat pixelFormat, int pixelsWide, int pixelsHigh)
+{
+    CCASSERT(pixelFormat != backend::PixelFormat::NONE && pixelFormat != backend::PixelFormat::AUTO, "PixelFormat should be set");
+
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (pixelsWide <= 0 || pixelsHigh <= 0 || pixelsWide > maxTextureSize || pixelsHigh > maxTextureSize)
+    {
+        return false;
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    VolatileTextureMgr::findVolotileTexture(this);
+#endif
+
+    backend::TextureDescriptor textureDescriptor;
+    textureDescriptor.width = pixelsWide;
+    textureDescriptor.height = pixelsHigh;
+    textureDescriptor.textureFormat = pixelFormat;
+    textureDescriptor.samplerDescriptor.magFilter = (_antialiasEnabled) ? backend::SamplerFilter::LINEAR : backend::SamplerFilter::NEAREST;
+    textureDescriptor.samplerDescriptor.minFilter = (_antialiasEnabled) ? backend::SamplerFilter::LINEAR : backend::SamplerFilter::NEAREST;
+    _texture->updateTextureDescriptor(textureDescriptor);
+
+    _contentSize = Size((float)pixelsWide, (float)pixelsHigh);
+    _pixelsWide = pixelsWide;
+    _pixelsHigh = pixelsHigh;
+    _pixelFormat = pixelFormat;
+    _maxS = 1;
+    _maxT = 1;
+
+    _hasPremultipliedAlpha = false;
+    _hasMipmaps = false;
+
+    return true;
+}
+
 // implementation Texture2D (Text)
 bool Texture2D::initWithString(const char *text, const std::string& fontName, float fontSize, const Size& dimensions/* = Size(0, 0)*/, TextHAlignment hAlignment/* =  TextHAlignment::CENTER */, TextVAlignment vAlignment/* =  TextVAlignment::TOP */, bool enableWrap /* = false */, int overflow /* = 0 */)
 {
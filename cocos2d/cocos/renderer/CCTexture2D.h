@@ -210,6 +210,29 @@ public:
     **/
     bool initWithImage(Image * image, backend::PixelFormat format);
 
+    /**
+    Initializes a texture with the size and pixel format of an image, without uploading its pixels.
+    The rows are uploaded afterwards with updateWithData(), so a large image can be streamed over several frames.
+    Only uncompressed RGBA8888 images without mipmaps that need no format conversion are supported.
+    @param image An UIImage object.
+    @param format Texture pixel formats, as for initWithImage.
+    @return False if the image can't be streamed, the texture is left uninitialized then.
+    @since v4.0
+    */
+    bool initWithImageStorage(Image * image, backend::PixelFormat format);
+
+    /**
+    Initializes an uncompressed texture of the given size without uploading any pixel.
+    The texels are undefined until they are written with updateWithData().
+    The texture can be initialized again with another size, its former content is lost then.
+    @param pixelFormat The texture pixelFormat, it must not be compressed.
+    @param pixelsWide The texture width.
+    @param pixelsHigh The texture height.
+    @return False if the size exceeds the maximum texture size.
+    @since v4.0
+    */
+    bool initWithStorage(backend::PixelFormat pixelFormat, int pixelsWide, int pixelsHigh);
+
     /** Initializes a texture from a string with dimensions, alignment, font name and font size. 
      
      @param text A null terminated string.
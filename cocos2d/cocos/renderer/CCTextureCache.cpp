@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "renderer/CCTextureCache.h"
 
 #include <errno.h>
+#include <algorithm>
+#include <chrono>
 #include <stack>
 #include <cctype>
 #include <list>
@@ -64,10 +66,19 @@ std::string TextureCache::getETC1AlphaFileSuffix()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncThreadCount(1)
+, _uploadBytesPerFrame(0)
+, _uploadSecondsPerFrame(0)
+, _lastFrameUploadBytes(0)
+, _lastFrameUploadTime(0)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _memoryBudget(0)
 {
+    // Decoding is CPU bound, leave one core to the main thread and cap the decoded images waiting for upload
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > 2)
+        _asyncThreadCount = std::min(hardwareThreads - 1, 4u);
 }
 
 TextureCache::~TextureCache()
@@ -77,7 +88,7 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    waitForQuit();
 }
 
 std::string TextureCache::getDescription() const
@@ -88,66 +99,61 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct
-    ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
-      : filename(fn), callback(f),callbackKey( key ),
+    AsyncStruct(const std::string& fn, AsyncPriority p)
+      : filename(fn),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        priority(p),
+        loadSuccess(false),
+        cancelled(false),
+        texture(nullptr),
+        uploadedRows(0),
+        uploaded(false)
     {}
 
+    ~AsyncStruct()
+    {
+        CC_SAFE_RELEASE(texture);
+    }
+
+    struct Callback
+    {
+        std::function<void(Texture2D*)> callback;
+        std::string callbackKey;
+    };
+
     std::string filename;
-    std::function<void(Texture2D*)> callback;
-    std::string callbackKey;
+    std::vector<Callback> callbacks;
     Image image;
     Image imageAlpha;
     backend::PixelFormat pixelFormat;
+    AsyncPriority priority;
     bool loadSuccess;
+    // set on the GL thread once every bound callback was unbound, the decoded image is then dropped
+    bool cancelled;
+    // GL thread only: the texture being uploaded, and the rows already streamed into it
+    Texture2D* texture;
+    int uploadedRows;
+    bool uploaded;
 };
 
-/**
- The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
-
- the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
-
- the object's life time:
- - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
-
- Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
-
- How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
- - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
-
- Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
-
- Call unbindImageAsync(path) to prevent the call to the callback when the
- texture is loaded.
- */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
 {
     addImageAsync( path, callback, path );
 }
 
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, AsyncPriority::VISIBLE);
+}
+
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _requestQueue or _prefetchQueue  (GL thread)
+ - get AsyncStruct from _requestQueue, or from _prefetchQueue when _requestQueue is empty, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
+ - on schedule callback, move AsyncStruct from _responseQueue to _uploadQueue, convert images to textures within the upload budget, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
+ - _requestQueue, _prefetchQueue: locked by _requestMutex
  - _responseQueue: locked by _responseMutex
  
  the object's life time:
@@ -156,12 +162,14 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - several load threads decode concurrently, so _responseQueue is in completion order, not in request order.
+ - _uploadQueue keeps the VISIBLE requests ahead of the PREFETCH ones, large images may stay at its front for
+ several frames while their rows are streamed.
  
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is in flight already, the callback is appended to that request, so the image is decoded once
+ and the callbacks are invoked in request order.
  
  Does process all response in addImageAsyncCallback consume more time?
  - Convert image to texture faster than load image from disk, so this isn't a
@@ -170,9 +178,10 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
  unbind the callback independently as needed whilst a call to
- unbindImageAsync(path) would be ambiguous.
+ unbindImageAsync(path) would be ambiguous. A request whose callbacks were all
+ unbound is removed from the request queues, or discarded when its response arrives.
  */
-void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, AsyncPriority priority)
 {
     Texture2D *texture = nullptr;
 
@@ -184,9 +193,34 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        ++_statistics.hits;
+        touchTexture(fullpath);
         if (callback) callback(texture);
         return;
     }
+    ++_statistics.misses;
+
+    // attach to the request in flight for the same file
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        if (asyncStruct->filename != fullpath)
+            continue;
+
+        asyncStruct->callbacks.push_back({ callback, callbackKey });
+        asyncStruct->cancelled = false;
+        if (priority == AsyncPriority::VISIBLE && asyncStruct->priority == AsyncPriority::PREFETCH)
+        {
+            asyncStruct->priority = AsyncPriority::VISIBLE;
+            std::unique_lock<std::mutex> ul(_requestMutex);
+            auto queued = std::find(_prefetchQueue.begin(), _prefetchQueue.end(), asyncStruct);
+            if (queued != _prefetchQueue.end())
+            {
+                _prefetchQueue.erase(queued);
+                _requestQueue.push_back(asyncStruct);
+            }
+        }
+        return;
+    }
 
     // check if file exists
     if (fullpath.empty() || !FileUtils::getInstance()->isFileExist(fullpath)) {
@@ -195,11 +229,10 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     }
 
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
         _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
+        startLoadingThreads();
     }
 
     if (0 == _asyncRefCount)
@@ -210,16 +243,37 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, priority);
+    data->callbacks.push_back({ callback, callbackKey });
     
     // add async struct into queue
     _asyncStructQueue.push_back(data);
     std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.push_back(data);
+    if (priority == AsyncPriority::VISIBLE)
+        _requestQueue.push_back(data);
+    else
+        _prefetchQueue.push_back(data);
     _sleepCondition.notify_one();
 }
 
+void TextureCache::setAsyncThreadCount(unsigned int count)
+{
+    _asyncThreadCount = std::max(count, 1u);
+
+    if (!_loadingThreads.empty())
+    {
+        startLoadingThreads();
+    }
+}
+
+void TextureCache::startLoadingThreads()
+{
+    while (_loadingThreads.size() < _asyncThreadCount)
+    {
+        _loadingThreads.emplace_back(&TextureCache::loadImage, this);
+    }
+}
+
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
 {
     if (_asyncStructQueue.empty())
@@ -229,11 +283,17 @@ void TextureCache::unbindImageAsync(const std::string& callbackKey)
 
     for (auto& asyncStruct : _asyncStructQueue)
     {
-        if (asyncStruct->callbackKey == callbackKey)
+        auto& callbacks = asyncStruct->callbacks;
+        auto unbound = std::remove_if(callbacks.begin(), callbacks.end(), [&callbackKey](const AsyncStruct::Callback& callback) {
+            return callback.callbackKey == callbackKey;
+        });
+        if (unbound != callbacks.end())
         {
-            asyncStruct->callback = nullptr;
+            callbacks.erase(unbound, callbacks.end());
+            asyncStruct->cancelled = callbacks.empty();
         }
     }
+    cancelUnboundImageAsync();
 }
 
 void TextureCache::unbindAllImageAsync()
@@ -245,35 +305,70 @@ void TextureCache::unbindAllImageAsync()
     }
     for (auto& asyncStruct : _asyncStructQueue)
     {
-        asyncStruct->callback = nullptr;
+        asyncStruct->callbacks.clear();
+        asyncStruct->cancelled = true;
+    }
+    cancelUnboundImageAsync();
+}
+
+void TextureCache::cancelUnboundImageAsync()
+{
+    std::vector<AsyncStruct*> dropped;
+    {
+        std::unique_lock<std::mutex> ul(_requestMutex);
+        auto dropCancelled = [&dropped](std::deque<AsyncStruct*>& queue) {
+            auto kept = std::remove_if(queue.begin(), queue.end(), [&dropped](AsyncStruct* asyncStruct) {
+                if (!asyncStruct->cancelled)
+                    return false;
+                dropped.push_back(asyncStruct);
+                return true;
+            });
+            queue.erase(kept, queue.end());
+        };
+        dropCancelled(_requestQueue);
+        dropCancelled(_prefetchQueue);
+    }
+
+    // decoded requests waiting for upload, the ones being decoded are discarded in addImageAsyncCallBack
+    auto kept = std::remove_if(_uploadQueue.begin(), _uploadQueue.end(), [&dropped](AsyncStruct* asyncStruct) {
+        if (!asyncStruct->cancelled)
+            return false;
+        dropped.push_back(asyncStruct);
+        return true;
+    });
+    _uploadQueue.erase(kept, _uploadQueue.end());
+
+    for (auto& asyncStruct : dropped)
+    {
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+        delete asyncStruct;
+        --_asyncRefCount;
+    }
+
+    if (!dropped.empty() && 0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
     }
 }
 
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
+    while (true)
     {
-        std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
         {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
-        }
-
-        if (nullptr == asyncStruct) {
-            if (_needQuit) {
+            std::unique_lock<std::mutex> ul(_requestMutex);
+            _sleepCondition.wait(ul, [this] { return _needQuit || !_requestQueue.empty() || !_prefetchQueue.empty(); });
+            if (_needQuit)
+            {
                 break;
             }
-            _sleepCondition.wait(ul);
-            continue;
+
+            // pop an AsyncStruct from request queue, prefetch requests wait for the visible ones
+            auto& queue = _requestQueue.empty() ? _prefetchQueue : _requestQueue;
+            asyncStruct = queue.front();
+            queue.pop_front();
         }
-        ul.unlock();
 
         // load image
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
@@ -292,90 +387,192 @@ void TextureCache::loadImage()
     }
 }
 
+void TextureCache::setUploadBudget(size_t bytesPerFrame, float secondsPerFrame)
+{
+    _uploadBytesPerFrame = bytesPerFrame;
+    _uploadSecondsPerFrame = std::max(secondsPerFrame, 0.0f);
+}
+
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
-    Texture2D *texture = nullptr;
-    AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    std::deque<AsyncStruct*> responses;
+    _responseMutex.lock();
+    responses.swap(_responseQueue);
+    _responseMutex.unlock();
+
+    for (auto& asyncStruct : responses)
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if (_responseQueue.empty())
+        if (asyncStruct->cancelled)
+        {
+            _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+            delete asyncStruct;
+            --_asyncRefCount;
+        }
+        else if (asyncStruct->priority == AsyncPriority::VISIBLE)
         {
-            asyncStruct = nullptr;
+            // behind the VISIBLE requests already waiting, ahead of the PREFETCH ones
+            auto firstPrefetch = std::find_if(_uploadQueue.begin(), _uploadQueue.end(), [](AsyncStruct* queued) {
+                return queued->priority == AsyncPriority::PREFETCH;
+            });
+            _uploadQueue.insert(firstPrefetch, asyncStruct);
         }
         else
         {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
+            _uploadQueue.push_back(asyncStruct);
+        }
+    }
 
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
+    size_t uploadedBytes = 0;
+    float uploadTime = 0;
+    while (!_uploadQueue.empty())
+    {
+        bool budgetSpent = (_uploadBytesPerFrame > 0 && uploadedBytes >= _uploadBytesPerFrame)
+                        || (_uploadSecondsPerFrame > 0 && uploadTime >= _uploadSecondsPerFrame);
+        if (budgetSpent && uploadedBytes > 0)
+        {
+            break;
         }
-        _responseMutex.unlock();
 
-        if (nullptr == asyncStruct) {
+        AsyncStruct* asyncStruct = _uploadQueue.front();
+        size_t byteBudget = 0;
+        if (_uploadBytesPerFrame > 0)
+        {
+            byteBudget = _uploadBytesPerFrame > uploadedBytes ? _uploadBytesPerFrame - uploadedBytes : 1;
+        }
+
+        auto uploadStart = std::chrono::steady_clock::now();
+        bool uploaded = uploadAsyncStruct(asyncStruct, byteBudget, uploadedBytes);
+        uploadTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - uploadStart).count();
+        if (!uploaded)
+        {
+            // rows left to stream next frame
             break;
         }
 
+        _uploadQueue.pop_front();
+        finishAsyncStruct(asyncStruct);
+    }
+
+    _lastFrameUploadBytes = uploadedBytes;
+    _lastFrameUploadTime = uploadTime;
+
+    if (0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
+}
+
+bool TextureCache::uploadAsyncStruct(AsyncStruct* asyncStruct, size_t byteBudget, size_t& uploadedBytes)
+{
+    if (asyncStruct->uploaded)
+    {
+        return true;
+    }
+
+    Image* image = &(asyncStruct->image);
+    if (asyncStruct->texture == nullptr)
+    {
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
         if (it != _textures.end())
         {
-            texture = it->second;
+            asyncStruct->texture = it->second;
+            asyncStruct->texture->retain();
+            asyncStruct->uploaded = true;
+            return true;
         }
-        else
+
+        if (!asyncStruct->loadSuccess)
         {
-            // convert image to texture
-            if (asyncStruct->loadSuccess)
-            {
-                Image* image = &(asyncStruct->image);
-                // generate texture in render thread
-                texture = new (std::nothrow) Texture2D();
+            CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
+            asyncStruct->uploaded = true;
+            return true;
+        }
 
-                texture->initWithImage(image, asyncStruct->pixelFormat);
-                //parse 9-patch info
-                this->parseNinePatchImage(image, texture, asyncStruct->filename);
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
-#endif
-                // cache the texture. retain it, since it is added in the map
-                _textures.emplace(asyncStruct->filename, texture);
-                texture->retain();
-
-                texture->autorelease();
-                // ETC1 ALPHA supports.
-                if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC) {
-                    auto alphaTexture = new(std::nothrow) Texture2D();
-                    if(alphaTexture != nullptr && alphaTexture->initWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat)) {
-                        texture->setAlphaTexture(alphaTexture);
-                    }
-                    CC_SAFE_RELEASE(alphaTexture);
+        // generate texture in render thread
+        Texture2D* texture = new (std::nothrow) Texture2D();
+        asyncStruct->texture = texture;
+
+        if (byteBudget == 0 || static_cast<size_t>(image->getDataLen()) <= byteBudget
+            || !texture->initWithImageStorage(image, asyncStruct->pixelFormat))
+        {
+            // convert image to texture in one upload
+            texture->initWithImage(image, asyncStruct->pixelFormat);
+            uploadedBytes += image->getDataLen();
+
+            // ETC1 ALPHA supports.
+            if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC) {
+                auto alphaTexture = new(std::nothrow) Texture2D();
+                if(alphaTexture != nullptr && alphaTexture->initWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat)) {
+                    texture->setAlphaTexture(alphaTexture);
                 }
+                CC_SAFE_RELEASE(alphaTexture);
             }
-            else {
-                texture = nullptr;
-                CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
-            }
+            asyncStruct->uploadedRows = image->getHeight();
         }
+    }
 
-        // call callback function
-        if (asyncStruct->callback)
+    // stream the next band of rows
+    int height = image->getHeight();
+    if (asyncStruct->uploadedRows < height)
+    {
+        size_t bytesPerRow = static_cast<size_t>(image->getDataLen()) / height;
+        int rows = height - asyncStruct->uploadedRows;
+        if (byteBudget > 0)
         {
-            (asyncStruct->callback)(texture);
+            rows = static_cast<int>(std::min<size_t>(rows, std::max<size_t>(byteBudget / bytesPerRow, 1)));
         }
 
-        // release the asyncStruct
-        delete asyncStruct;
-        --_asyncRefCount;
+        asyncStruct->texture->updateWithData(image->getData() + asyncStruct->uploadedRows * bytesPerRow, 0, asyncStruct->uploadedRows, image->getWidth(), rows);
+        asyncStruct->uploadedRows += rows;
+        uploadedBytes += rows * bytesPerRow;
+        if (asyncStruct->uploadedRows < height)
+        {
+            return false;
+        }
     }
 
-    if (0 == _asyncRefCount)
+    Texture2D* texture = asyncStruct->texture;
+    //parse 9-patch info
+    this->parseNinePatchImage(image, texture, asyncStruct->filename);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // cache the texture file name
+    VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+#endif
+    // cache the texture. retain it, since it is added in the map
+    _textures.emplace(asyncStruct->filename, texture);
+    texture->retain();
+    touchTexture(asyncStruct->filename);
+    evictToBudget();
+
+    asyncStruct->uploaded = true;
+    return true;
+}
+
+void TextureCache::finishAsyncStruct(AsyncStruct* asyncStruct)
+{
+    _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
+    // keep the texture alive through the callbacks, even if one of them removes it from the cache
+    Texture2D* texture = asyncStruct->texture;
+    if (texture != nullptr)
     {
-        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+        texture->retain();
+        texture->autorelease();
     }
+
+    // call callback functions, in request order
+    for (auto& callback : asyncStruct->callbacks)
+    {
+        if (callback.callback)
+        {
+            callback.callback(texture);
+        }
+    }
+
+    // release the asyncStruct
+    delete asyncStruct;
+    --_asyncRefCount;
 }
 
 Texture2D * TextureCache::addImage(const std::string &path)
@@ -393,7 +590,30 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if (it != _textures.end())
+    {
         texture = it->second;
+        ++_statistics.hits;
+        touchTexture(fullpath);
+    }
+    else
+    {
+        ++_statistics.misses;
+    }
+
+    if (!texture)
+    {
+        // needed this frame, upload it now if addImageAsync decoded it already, its callbacks still run on the next tick
+        for (auto& asyncStruct : _uploadQueue)
+        {
+            if (asyncStruct->filename == fullpath)
+            {
+                size_t uploadedBytes = 0;
+                uploadAsyncStruct(asyncStruct, 0, uploadedBytes);
+                texture = asyncStruct->texture;
+                break;
+            }
+        }
+    }
 
     if (!texture)
     {
@@ -434,6 +654,9 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                touchTexture(fullpath);
+                evictToBudget();
             }
             else
             {
@@ -472,8 +695,11 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            ++_statistics.hits;
+            touchTexture(key);
             break;
         }
+        ++_statistics.misses;
 
         texture = new (std::nothrow) Texture2D();
 
@@ -482,6 +708,8 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             if (texture->initWithImage(image))
             {
                 _textures.emplace(key, texture);
+                touchTexture(key);
+                evictToBudget();
             }
             else
             {
@@ -615,7 +843,12 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if (it != _textures.end())
+    {
+        ++_statistics.hits;
+        touchTexture(key);
         return it->second;
+    }
+    ++_statistics.misses;
     return nullptr;
 }
 
@@ -634,12 +867,17 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // notify sub threads to quit
     std::unique_lock<std::mutex> ul(_requestMutex);
     _needQuit = true;
-    _sleepCondition.notify_one();
+    _sleepCondition.notify_all();
     ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    for (auto& loadingThread : _loadingThreads)
+    {
+        if (loadingThread.joinable())
+            loadingThread.join();
+    }
+    _loadingThreads.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -648,7 +886,7 @@ std::string TextureCache::getCachedTextureInfo() const
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
 
     for (auto& texture : _textures) {
 
@@ -657,18 +895,21 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = texture.second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        // Each texture takes up its mipmap chain, compressed formats are counted by blocks.
+        auto bytes = getTextureMemoryBytes(tex);
         totalBytes += bytes;
         count++;
-        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%p %lu x %lu @ %ld bpp => %lu KB\n",
+
+        auto lastUse = _lastUseFrames.find(texture.first);
+        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%p %lu x %lu @ %ld bpp => %lu KB, last used at frame %ld\n",
             texture.first.c_str(),
             (long)tex->getReferenceCount(),
             tex->getBackendTexture(),
             (long)tex->getPixelsWide(),
             (long)tex->getPixelsHigh(),
             (long)bpp,
-            (long)bytes / 1024);
+            (long)bytes / 1024,
+            lastUse != _lastUseFrames.end() ? (long)lastUse->second : -1L);
 
         buffer += buftmp;
     }
@@ -676,9 +917,167 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    unsigned int lookups = _statistics.hits + _statistics.misses;
+    snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache budget: %lu KB, hits: %u, misses: %u (%.1f%% hit rate), evictions: %u for %lu KB\n",
+        (long)_memoryBudget / 1024,
+        _statistics.hits,
+        _statistics.misses,
+        lookups > 0 ? 100.0f * _statistics.hits / lookups : 0.0f,
+        _statistics.evictions,
+        (long)_statistics.evictedBytes / 1024);
+    buffer += buftmp;
+
     return buffer;
 }
 
+static size_t getMipmapLevelBytes(backend::PixelFormat format, const Texture2D::PixelFormatInfo& info, size_t width, size_t height)
+{
+    switch (format)
+    {
+        // PVRTC levels are padded to 8x8 pixels at 4 bpp, 16x8 pixels at 2 bpp
+        case backend::PixelFormat::PVRTC4:
+        case backend::PixelFormat::PVRTC4A:
+            return std::max<size_t>(width, 8) * std::max<size_t>(height, 8) * info.bpp / 8;
+        case backend::PixelFormat::PVRTC2:
+        case backend::PixelFormat::PVRTC2A:
+            return std::max<size_t>(width, 16) * std::max<size_t>(height, 8) * info.bpp / 8;
+        default:
+            break;
+    }
+
+    if (info.compressed)
+    {
+        // ETC, S3TC and ATITC store 4x4 pixel blocks
+        return ((width + 3) / 4) * ((height + 3) / 4) * 16 * info.bpp / 8;
+    }
+    return (width * height * info.bpp + 7) / 8;
+}
+
+size_t TextureCache::getTextureMemoryBytes(const Texture2D* texture)
+{
+    if (texture == nullptr)
+    {
+        return 0;
+    }
+
+    const auto& infoMap = Texture2D::getPixelFormatInfoMap();
+    auto info = infoMap.find(texture->getPixelFormat());
+    if (info == infoMap.end())
+    {
+        return 0;
+    }
+
+    size_t width = std::max(texture->getPixelsWide(), 0);
+    size_t height = std::max(texture->getPixelsHigh(), 0);
+    bool hasMipmaps = texture->getBackendTexture() != nullptr && texture->getBackendTexture()->hasMipmaps();
+
+    size_t bytes = getMipmapLevelBytes(info->first, info->second, width, height);
+    while (hasMipmaps && (width > 1 || height > 1))
+    {
+        width = std::max<size_t>(width >> 1, 1);
+        height = std::max<size_t>(height >> 1, 1);
+        bytes += getMipmapLevelBytes(info->first, info->second, width, height);
+    }
+
+    // ETC1 ALPHA supports.
+    bytes += getTextureMemoryBytes(texture->getAlphaTexture());
+    return bytes;
+}
+
+size_t TextureCache::getResidentBytes() const
+{
+    size_t bytes = 0;
+    for (auto& texture : _textures)
+    {
+        bytes += getTextureMemoryBytes(texture.second);
+    }
+    return bytes;
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    evictToBudget();
+}
+
+void TextureCache::touchTexture(const std::string& key) const
+{
+    _lastUseFrames[key] = Director::getInstance()->getTotalFrames();
+}
+
+void TextureCache::evictToBudget()
+{
+    if (_memoryBudget > 0)
+    {
+        evictUnusedTextures(_memoryBudget);
+    }
+}
+
+size_t TextureCache::evictUnusedTextures(size_t targetBytes)
+{
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+
+    struct Candidate
+    {
+        unsigned int lastUse;
+        size_t bytes;
+        std::unordered_map<std::string, Texture2D*>::iterator texture;
+    };
+    std::vector<Candidate> candidates;
+
+    size_t residentBytes = 0;
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        size_t bytes = getTextureMemoryBytes(it->second);
+        residentBytes += bytes;
+
+        auto& lastUse = _lastUseFrames.emplace(it->first, frame).first->second;
+        if (it->second->getReferenceCount() > 1)
+        {
+            // held outside the cache, so in use
+            lastUse = frame;
+        }
+        else if (lastUse != frame)
+        {
+            candidates.push_back({ lastUse, bytes, it });
+        }
+    }
+
+    size_t releasedBytes = 0;
+    if (residentBytes > targetBytes)
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.lastUse < b.lastUse;
+        });
+
+        for (auto& candidate : candidates)
+        {
+            if (residentBytes - releasedBytes <= targetBytes)
+            {
+                break;
+            }
+
+            CCLOG("cocos2d: TextureCache: evicting texture: %s", candidate.texture->first.c_str());
+            candidate.texture->second->release();
+            _textures.erase(candidate.texture);
+            releasedBytes += candidate.bytes;
+            ++_statistics.evictions;
+        }
+        _statistics.evictedBytes += releasedBytes;
+    }
+
+    // forget the textures removed from the cache, by eviction or by the remove functions
+    for (auto it = _lastUseFrames.begin(); it != _lastUseFrames.end(); /* nothing */)
+    {
+        if (_textures.find(it->first) == _textures.end())
+            it = _lastUseFrames.erase(it);
+        else
+            ++it;
+    }
+
+    return releasedBytes;
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
@@ -67,6 +68,38 @@ public:
     static void setETC1AlphaFileSuffix(const std::string& suffix);
     static std::string getETC1AlphaFileSuffix();
 
+    /** Scheduling class of an asynchronous image load.
+     * @since v4.0
+     */
+    enum class AsyncPriority
+    {
+        /** Needed on screen now, decoded before any queued PREFETCH request. */
+        VISIBLE,
+        /** Preloaded for later, decoded when no VISIBLE request is waiting. */
+        PREFETCH
+    };
+
+    /** Counters of the texture lookups and automatic evictions.
+     * @since v4.0
+     */
+    struct CacheStatistics
+    {
+        /** Lookups that found the texture in the cache. */
+        unsigned int hits = 0;
+        /** Lookups that had to load the texture. */
+        unsigned int misses = 0;
+        /** Textures evicted to stay within the memory budget. */
+        unsigned int evictions = 0;
+        /** Bytes released by those evictions. */
+        size_t evictedBytes = 0;
+    };
+
+    /** Returns the memory used by a texture, its mipmap chain and its ETC1 alpha texture.
+     * Compressed formats are counted by blocks, so small mipmap levels are not underestimated.
+     * @since v4.0
+     */
+    static size_t getTextureMemoryBytes(const Texture2D* texture);
+
 public:
     /**
      * @js ctor
@@ -99,6 +132,12 @@ public:
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
     * Supported image extensions: .png, .jpg
+    *
+    * Callback ordering:
+    * - Callbacks always run on the main thread. They run inside this call only when the texture is cached already or the file doesn't exist.
+    * - Requests for the same file share one decode, and their callbacks run in request order.
+    * - Requests for different files are decoded concurrently, and their callbacks run in decode completion order.
+    *   A VISIBLE request starts before every queued PREFETCH request, and there are no other ordering guarantees.
      @param filepath The file path.
      @param callback A callback function would be invoked after the image is loaded.
      @since v0.8
@@ -107,19 +146,70 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Same as addImageAsync(path, callback, callbackKey), decoded with the given priority.
+     * Requesting a file that is still queued as PREFETCH with VISIBLE priority moves it ahead.
+     * @since v4.0
+     */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, AsyncPriority priority);
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
+     * When no callback is left bound to a request, the request is cancelled. A request that is still queued is dropped
+     * without being decoded. A request that is being decoded is discarded without creating a texture.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
     virtual void unbindImageAsync(const std::string &filename);
     
-    /** Unbind all bound image asynchronous load callbacks.
+    /** Unbind all bound image asynchronous load callbacks, cancelling the requests they were bound to.
      * @since v3.1
      */
     virtual void unbindAllImageAsync();
 
+    /** Sets the number of threads decoding images for addImageAsync.
+     * Defaults to one thread per spare core, at most 4. Raising the count starts the missing threads right away if
+     * loading has started, lowering it takes effect the next time loading starts after waitForQuit().
+     * @since v4.0
+     */
+    void setAsyncThreadCount(unsigned int count);
+
+    /** Returns the number of threads decoding images for addImageAsync.
+     * @since v4.0
+     */
+    unsigned int getAsyncThreadCount() const { return _asyncThreadCount; }
+
+    /** Sets how much texture data addImageAsync may upload per frame.
+     * Decoded images wait in an upload queue, VISIBLE requests ahead of PREFETCH ones, and are uploaded until either
+     * budget is spent. At least one upload runs per frame. An uncompressed RGBA8888 image larger than the byte budget
+     * is streamed in bands of rows over several frames, and its callbacks run once the last band is uploaded.
+     * Both budgets are 0, unlimited, by default.
+     * @param bytesPerFrame Maximum number of bytes uploaded per frame, 0 for no limit.
+     * @param secondsPerFrame Maximum time spent uploading per frame, 0 for no limit.
+     * @since v4.0
+     */
+    void setUploadBudget(size_t bytesPerFrame, float secondsPerFrame);
+
+    /** Returns the byte budget set by setUploadBudget().
+     * @since v4.0
+     */
+    size_t getUploadBytesPerFrame() const { return _uploadBytesPerFrame; }
+
+    /** Returns the time budget set by setUploadBudget(), in seconds.
+     * @since v4.0
+     */
+    float getUploadSecondsPerFrame() const { return _uploadSecondsPerFrame; }
+
+    /** Returns the number of bytes addImageAsync uploaded during the last frame it ran.
+     * @since v4.0
+     */
+    size_t getLastFrameUploadBytes() const { return _lastFrameUploadBytes; }
+
+    /** Returns the time addImageAsync spent uploading during the last frame it ran, in seconds.
+     * @since v4.0
+     */
+    float getLastFrameUploadTime() const { return _lastFrameUploadTime; }
+
     /** Returns a Texture2D object given an Image.
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image.
@@ -174,6 +264,42 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** Sets the memory budget of the cache, in bytes. 0, the default, disables it.
+    * While the cached textures use more memory than the budget, the textures held only by the cache are released,
+    * least recently used first. It is checked whenever a texture is added. Textures looked up during the current frame
+    * are never evicted, so the texture returned by addImage() stays valid until the caller retains it.
+    * @since v4.0
+    */
+    void setMemoryBudget(size_t bytes);
+
+    /** Returns the memory budget set by setMemoryBudget().
+    * @since v4.0
+    */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Returns the memory used by all cached textures, see getTextureMemoryBytes().
+    * @since v4.0
+    */
+    size_t getResidentBytes() const;
+
+    /** Releases the textures held only by the cache, least recently used first, until the cache uses at most targetBytes.
+    * Call it with 0 from the OS low memory warning to drop every texture that wasn't used during the current frame.
+    * @param targetBytes The memory the cache may keep.
+    * @return The number of bytes released.
+    * @since v4.0
+    */
+    size_t evictUnusedTextures(size_t targetBytes);
+
+    /** Returns the lookup and eviction counters.
+    * @since v4.0
+    */
+    const CacheStatistics& getStatistics() const { return _statistics; }
+
+    /** Resets the lookup and eviction counters.
+    * @since v4.0
+    */
+    void resetStatistics() { _statistics = CacheStatistics(); }
+
     //Wait for texture cache to quit before destroy instance.
     /**Called by director, please do not called outside.*/
     void waitForQuit();
@@ -201,16 +327,31 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void startLoadingThreads();
+    void cancelUnboundImageAsync();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    void touchTexture(const std::string& key) const;
+    void evictToBudget();
 public:
 protected:
     struct AsyncStruct;
+
+    bool uploadAsyncStruct(AsyncStruct* asyncStruct, size_t byteBudget, size_t& uploadedBytes);
+    void finishAsyncStruct(AsyncStruct* asyncStruct);
     
-    std::thread* _loadingThread;
+    std::vector<std::thread> _loadingThreads;
+    unsigned int _asyncThreadCount;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
+    std::deque<AsyncStruct*> _prefetchQueue;
     std::deque<AsyncStruct*> _responseQueue;
+    std::deque<AsyncStruct*> _uploadQueue;
+
+    size_t _uploadBytesPerFrame;
+    float _uploadSecondsPerFrame;
+    size_t _lastFrameUploadBytes;
+    float _lastFrameUploadTime;
 
     std::mutex _requestMutex;
     std::mutex _responseMutex;
@@ -223,6 +364,11 @@ protected:
 
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    // last frame each cached texture was looked up or seen in use, by key
+    mutable std::unordered_map<std::string, unsigned int> _lastUseFrames;
+    mutable CacheStatistics _statistics;
+    size_t _memoryBudget;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -24,11 +24,71 @@
  
 #include "CCTextureUtils.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INCLUDE_SSE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define INCLUDE_NEON
+#include <arm_neon.h>
+#endif
 
 NS_CC_BEGIN
 
 namespace backend { namespace PixelFormatUtils {
     
+    //////////////////////////////////////////////////////////////////////////
+    //simd kernels
+
+    typedef size_t (*PixelKernel)(const unsigned char* data, size_t pixels, unsigned char* outData);
+
+    // the vectorized converters usable on this CPU, nullptr for those that aren't vectorized
+    struct PixelKernels
+    {
+        PixelKernel rgba8888ToRGB888 = nullptr;
+        PixelKernel rgba8888ToRGBA4444 = nullptr;
+        PixelKernel rgba8888ToRGB565 = nullptr;
+        PixelKernel rgba8888ToRGB5A1 = nullptr;
+        PixelKernel rgba8888ToA8 = nullptr;
+        PixelKernel rgb888ToRGBA8888 = nullptr;
+        PixelKernel bgra8888ToRGBA8888 = nullptr;
+        PixelKernel premultiplyAlpha = nullptr;
+    };
+
+#ifdef INCLUDE_SSE
+#include "renderer/CCTextureUtilsSSE.inl"
+#endif
+
+#ifdef INCLUDE_NEON
+#include "renderer/CCTextureUtilsNeon.inl"
+#endif
+
+    static PixelKernels selectPixelKernels()
+    {
+        PixelKernels kernels;
+#if defined(INCLUDE_SSE)
+        selectPixelKernelsSSE(kernels);
+#elif defined(INCLUDE_NEON)
+        selectPixelKernelsNeon(kernels);
+#endif
+        return kernels;
+    }
+
+    static const PixelKernels& getPixelKernels()
+    {
+        static const PixelKernels kernels = selectPixelKernels();
+        return kernels;
+    }
+
+    // converts the leading pixels the kernel can handle, returns how many of them it converted
+    static inline size_t runPixelKernel(PixelKernel kernel, const unsigned char* data, size_t pixels, unsigned char* outData)
+    {
+        return kernel ? kernel(data, pixels, outData) : 0;
+    }
+    
     //////////////////////////////////////////////////////////////////////////
     //convertor function
     
@@ -264,7 +324,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
     void convertRGB888ToRGBA8888(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+        size_t done = runPixelKernel(getPixelKernels().rgb888ToRGBA8888, data, dataLen / 3, outData);
+        outData += done * 4;
+        for (ssize_t i = done * 3, l = dataLen - 2; i < l; i += 3)
         {
             *outData++ = data[i];         //R
             *outData++ = data[i + 1];     //G
@@ -276,7 +338,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
     void convertRGBA8888ToRGB888(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+        size_t done = runPixelKernel(getPixelKernels().rgba8888ToRGB888, data, dataLen / 4, outData);
+        outData += done * 3;
+        for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
         {
             *outData++ = data[i];         //R
             *outData++ = data[i + 1];     //G
@@ -299,8 +363,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
     void convertRGBA8888ToRGB565(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        unsigned short* out16 = (unsigned short*)outData;
-        for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+        size_t done = runPixelKernel(getPixelKernels().rgba8888ToRGB565, data, dataLen / 4, outData);
+        unsigned short* out16 = (unsigned short*)outData + done;
+        for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
         {
             *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -338,7 +403,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
     void convertRGBA8888ToA8(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+        size_t done = runPixelKernel(getPixelKernels().rgba8888ToA8, data, dataLen / 4, outData);
+        outData += done;
+        for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
         {
             *outData++ = data[i + 3]; //A
         }
@@ -381,8 +448,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
     void convertRGBA8888ToRGBA4444(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        unsigned short* out16 = (unsigned short*)outData;
-        for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+        size_t done = runPixelKernel(getPixelKernels().rgba8888ToRGBA4444, data, dataLen / 4, outData);
+        unsigned short* out16 = (unsigned short*)outData + done;
+        for (ssize_t i = done * 4, l = dataLen - 3; i < l; i += 4)
         {
             *out16++ = (data[i] & 0x00F0) << 8    //R
             | (data[i + 1] & 0x00F0) << 4         //G
@@ -444,8 +512,9 @@ namespace backend { namespace PixelFormatUtils {
     // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGG GGBBBBBA
     void convertRGBA8888ToRGB5A1(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
-        unsigned short* out16 = (unsigned short*)outData;
-        for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+        size_t done = runPixelKernel(getPixelKernels().rgba8888ToRGB5A1, data, dataLen / 4, outData);
+        unsigned short* out16 = (unsigned short*)outData + done;
+        for (ssize_t i = done * 4, l = dataLen - 2; i < l; i += 4)
         {
             *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -576,7 +645,9 @@ namespace backend { namespace PixelFormatUtils {
     void convertBGRA8888ToRGBA8888(const unsigned char* data, size_t dataLen, unsigned char* outData)
     {
         const size_t pixelCounts = dataLen / 4;
-        for (size_t i = 0; i < pixelCounts; i++)
+        size_t done = runPixelKernel(getPixelKernels().bgra8888ToRGBA8888, data, pixelCounts, outData);
+        outData += done * 4;
+        for (size_t i = done; i < pixelCounts; i++)
         {
             *outData++ = data[i*4 + 2];
             *outData++ = data[i*4 + 1];
@@ -585,6 +656,23 @@ namespace backend { namespace PixelFormatUtils {
         }
     }
     
+    // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> (R*(A+1))>>8 (G*(A+1))>>8 (B*(A+1))>>8 A, same as CC_RGB_PREMULTIPLY_ALPHA
+    void premultiplyAlphaRGBA8888(const unsigned char* data, size_t dataLen, unsigned char* outData)
+    {
+        const size_t pixelCounts = dataLen / 4;
+        size_t done = runPixelKernel(getPixelKernels().premultiplyAlpha, data, pixelCounts, outData);
+        for (size_t i = done; i < pixelCounts; i++)
+        {
+            const unsigned char* p = data + i * 4;
+            unsigned a = p[3] + 1;
+            unsigned char* out = outData + i * 4;
+            out[0] = (unsigned char)((p[0] * a) >> 8);
+            out[1] = (unsigned char)((p[1] * a) >> 8);
+            out[2] = (unsigned char)((p[2] * a) >> 8);
+            out[3] = p[3];
+        }
+    }
+    
     // converter function end
     //////////////////////////////////////////////////////////////////////////
     
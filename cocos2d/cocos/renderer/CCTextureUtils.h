@@ -94,6 +94,12 @@ namespace backend {
         
         //BGRA8888 to XXX
         void convertBGRA8888ToRGBA8888(const unsigned char* data, size_t dataLen, unsigned char* outData);
+
+        /**
+        Premultiply the color channels of RGBA8888 pixels by their alpha, like CC_RGB_PREMULTIPLY_ALPHA.
+        outData may be data to premultiply in place.
+        */
+        void premultiplyAlphaRGBA8888(const unsigned char* data, size_t dataLen, unsigned char* outData);
     };
 }
 NS_CC_END
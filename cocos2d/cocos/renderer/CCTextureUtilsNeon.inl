@@ -0,0 +1,172 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// NEON kernels, used whenever the engine is built with NEON. They work on 16 pixels at a time with
+// the structure loads deinterleaving the channels, and are bit exact with the scalar code.
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+static size_t convertRGBA8888ToRGBA4444Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const uint8x16_t mask = vdupq_n_u8(0xF0);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vandq_u8(p.val[2], mask), vshrq_n_u8(p.val[3], 4));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], mask), vshrq_n_u8(p.val[1], 4));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+static size_t convertRGBA8888ToRGB565Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const uint8x16_t maskR = vdupq_n_u8(0xF8);
+    const uint8x16_t maskG = vdupq_n_u8(0xE0);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), maskG), vshrq_n_u8(p.val[2], 3));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], maskR), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+static size_t convertRGBA8888ToRGB5A1Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const uint8x16_t maskR = vdupq_n_u8(0xF8);
+    const uint8x16_t maskG = vdupq_n_u8(0xC0);
+    const uint8x16_t maskB = vdupq_n_u8(0x3E);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), maskG), vandq_u8(vshrq_n_u8(p.val[2], 2), maskB)),
+                              vshrq_n_u8(p.val[3], 7));
+        out.val[1] = vorrq_u8(vandq_u8(p.val[0], maskR), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8(outData + i * 2, out);
+    }
+    return i;
+}
+
+static size_t convertRGBA8888ToA8Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        vst1q_u8(outData + i, p.val[3]);
+    }
+    return i;
+}
+
+static size_t convertRGBA8888ToRGB888Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16x3_t out;
+        out.val[0] = p.val[0];
+        out.val[1] = p.val[1];
+        out.val[2] = p.val[2];
+        vst3q_u8(outData + i * 3, out);
+    }
+    return i;
+}
+
+static size_t convertRGB888ToRGBA8888Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x3_t p = vld3q_u8(data + i * 3);
+        uint8x16x4_t out;
+        out.val[0] = p.val[0];
+        out.val[1] = p.val[1];
+        out.val[2] = p.val[2];
+        out.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(outData + i * 4, out);
+    }
+    return i;
+}
+
+static size_t convertBGRA8888ToRGBA8888Neon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint8x16_t b = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = b;
+        vst4q_u8(outData + i * 4, p);
+    }
+    return i;
+}
+
+// c * (a + 1) >> 8, widened to 16 bits because a + 1 doesn't fit in 8
+static inline uint8x16_t premultiplyNeon(uint8x16_t c, uint16x8_t alphaLo, uint16x8_t alphaHi)
+{
+    uint8x8_t lo = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_low_u8(c)), alphaLo), 8);
+    uint8x8_t hi = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_high_u8(c)), alphaHi), 8);
+    return vcombine_u8(lo, hi);
+}
+
+static size_t premultiplyAlphaNeon(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const uint16x8_t one = vdupq_n_u16(1);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(data + i * 4);
+        uint16x8_t alphaLo = vaddw_u8(one, vget_low_u8(p.val[3]));
+        uint16x8_t alphaHi = vaddw_u8(one, vget_high_u8(p.val[3]));
+        p.val[0] = premultiplyNeon(p.val[0], alphaLo, alphaHi);
+        p.val[1] = premultiplyNeon(p.val[1], alphaLo, alphaHi);
+        p.val[2] = premultiplyNeon(p.val[2], alphaLo, alphaHi);
+        vst4q_u8(outData + i * 4, p);
+    }
+    return i;
+}
+
+static void selectPixelKernelsNeon(PixelKernels& kernels)
+{
+    kernels.rgba8888ToRGBA4444 = convertRGBA8888ToRGBA4444Neon;
+    kernels.rgba8888ToRGB565 = convertRGBA8888ToRGB565Neon;
+    kernels.rgba8888ToRGB5A1 = convertRGBA8888ToRGB5A1Neon;
+    kernels.rgba8888ToA8 = convertRGBA8888ToA8Neon;
+    kernels.rgba8888ToRGB888 = convertRGBA8888ToRGB888Neon;
+    kernels.rgb888ToRGBA8888 = convertRGB888ToRGBA8888Neon;
+    kernels.bgra8888ToRGBA8888 = convertBGRA8888ToRGBA8888Neon;
+    kernels.premultiplyAlpha = premultiplyAlphaNeon;
+}
@@ -0,0 +1,374 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+// SSE2 kernels are always used when the engine is built for SSE2, the SSSE3 and AVX2 ones only after
+// checking the CPU at runtime. Every kernel handles whole blocks of pixels and returns how many pixels
+// it converted, the callers convert the rest with the scalar code. The results are bit exact with it.
+
+#if defined(_MSC_VER)
+#define CC_TARGET_SSSE3
+#define CC_TARGET_AVX2
+#else
+#define CC_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define CC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+static bool isSSSE3Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+static bool isAVX2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    // the OS must save the ymm registers too
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2
+
+// the 16 bits results are in 32 bits lanes, sign extend them so that the signed saturating pack keeps them
+static inline __m128i packPixels16SSE2(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
+static inline __m128i toRGBA4444SSE2(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8),
+                                     _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4)),
+                        _mm_or_si128(_mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF00000)), 16),
+                                     _mm_srli_epi32(p, 28)));
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
+static inline __m128i toRGB565SSE2(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8),
+                                     _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5)),
+                        _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 19));
+}
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGBBBBBA
+static inline __m128i toRGB5A1SSE2(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8),
+                                     _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5)),
+                        _mm_or_si128(_mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 18),
+                                     _mm_srli_epi32(p, 31)));
+}
+
+static size_t convertRGBA8888ToRGBA4444SSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packPixels16SSE2(toRGBA4444SSE2(lo), toRGBA4444SSE2(hi)));
+    }
+    return i;
+}
+
+static size_t convertRGBA8888ToRGB565SSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packPixels16SSE2(toRGB565SSE2(lo), toRGB565SSE2(hi)));
+    }
+    return i;
+}
+
+static size_t convertRGBA8888ToRGB5A1SSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16));
+        _mm_storeu_si128((__m128i*)(outData + i * 2), packPixels16SSE2(toRGB5A1SSE2(lo), toRGB5A1SSE2(hi)));
+    }
+    return i;
+}
+
+static size_t convertRGBA8888ToA8SSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4)), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 32)), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 48)), 24);
+        __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128((__m128i*)(outData + i), a);
+    }
+    return i;
+}
+
+static size_t convertBGRA8888ToRGBA8888SSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i ga = _mm_set1_epi32((int)0xFF00FF00);
+    const __m128i low = _mm_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), low);
+        __m128i b = _mm_slli_epi32(_mm_and_si128(p, low), 16);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_or_si128(_mm_and_si128(p, ga), _mm_or_si128(r, b)));
+    }
+    return i;
+}
+
+// c * (a + 1) >> 8 on the color channels of two pixels widened to 16 bits, alpha is kept
+static inline __m128i premultiply16SSE2(__m128i c, __m128i one, __m128i alphaMask)
+{
+    __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i m = _mm_srli_epi16(_mm_mullo_epi16(c, _mm_add_epi16(a, one)), 8);
+    return _mm_or_si128(_mm_andnot_si128(alphaMask, m), _mm_and_si128(alphaMask, c));
+}
+
+static size_t premultiplyAlphaSSE2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i lo = premultiply16SSE2(_mm_unpacklo_epi8(p, zero), one, alphaMask);
+        __m128i hi = premultiply16SSE2(_mm_unpackhi_epi8(p, zero), one, alphaMask);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SSSE3
+
+CC_TARGET_SSSE3
+static size_t convertRGBA8888ToRGB888SSSE3(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        // four pixels become 12 bytes, stitch four of them into three stores
+        __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4)), shuffle);
+        __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)), shuffle);
+        __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 32)), shuffle);
+        __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 48)), shuffle);
+        unsigned char* out = outData + i * 3;
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+        _mm_storeu_si128((__m128i*)(out + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+    }
+    return i;
+}
+
+CC_TARGET_SSSE3
+static size_t convertRGB888ToRGBA8888SSSE3(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(data + i * 3));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(data + i * 3 + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(data + i * 3 + 32));
+        unsigned char* out = outData + i * 4;
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(_mm_shuffle_epi8(v0, shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(out + 32), _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), shuffle), alpha));
+        _mm_storeu_si128((__m128i*)(out + 48), _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(v2, 4), shuffle), alpha));
+    }
+    return i;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AVX2
+
+// like packPixels16SSE2, the pack works per 128 bits lane so the quarters are put back in order
+CC_TARGET_AVX2
+static inline __m256i packPixels16AVX2(__m256i lo, __m256i hi)
+{
+    lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);
+    hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+CC_TARGET_AVX2
+static inline __m256i toRGBA4444AVX2(__m256i p)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF0)), 8),
+                                           _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF000)), 4)),
+                           _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF00000)), 16),
+                                           _mm256_srli_epi32(p, 28)));
+}
+
+CC_TARGET_AVX2
+static inline __m256i toRGB565AVX2(__m256i p)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8),
+                                           _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xFC00)), 5)),
+                           _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF80000)), 19));
+}
+
+CC_TARGET_AVX2
+static inline __m256i toRGB5A1AVX2(__m256i p)
+{
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF8)), 8),
+                                           _mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF800)), 5)),
+                           _mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(p, _mm256_set1_epi32(0xF80000)), 18),
+                                           _mm256_srli_epi32(p, 31)));
+}
+
+CC_TARGET_AVX2
+static size_t convertRGBA8888ToRGBA4444AVX2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m256i lo = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(data + i * 4 + 32));
+        _mm256_storeu_si256((__m256i*)(outData + i * 2), packPixels16AVX2(toRGBA4444AVX2(lo), toRGBA4444AVX2(hi)));
+    }
+    return i;
+}
+
+CC_TARGET_AVX2
+static size_t convertRGBA8888ToRGB565AVX2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m256i lo = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(data + i * 4 + 32));
+        _mm256_storeu_si256((__m256i*)(outData + i * 2), packPixels16AVX2(toRGB565AVX2(lo), toRGB565AVX2(hi)));
+    }
+    return i;
+}
+
+CC_TARGET_AVX2
+static size_t convertRGBA8888ToRGB5A1AVX2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m256i lo = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i hi = _mm256_loadu_si256((const __m256i*)(data + i * 4 + 32));
+        _mm256_storeu_si256((__m256i*)(outData + i * 2), packPixels16AVX2(toRGB5A1AVX2(lo), toRGB5A1AVX2(hi)));
+    }
+    return i;
+}
+
+CC_TARGET_AVX2
+static size_t convertBGRA8888ToRGBA8888AVX2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                             2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m256i p = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        _mm256_storeu_si256((__m256i*)(outData + i * 4), _mm256_shuffle_epi8(p, shuffle));
+    }
+    return i;
+}
+
+CC_TARGET_AVX2
+static inline __m256i premultiply16AVX2(__m256i c, __m256i one, __m256i alphaMask)
+{
+    __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i m = _mm256_srli_epi16(_mm256_mullo_epi16(c, _mm256_add_epi16(a, one)), 8);
+    return _mm256_blendv_epi8(m, c, alphaMask);
+}
+
+CC_TARGET_AVX2
+static size_t premultiplyAlphaAVX2(const unsigned char* data, size_t pixels, unsigned char* outData)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i alphaMask = _mm256_set1_epi64x((long long)0xFFFF000000000000ULL);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8)
+    {
+        // unpack and pack both work per 128 bits lane, so the pixels come back in order
+        __m256i p = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i lo = premultiply16AVX2(_mm256_unpacklo_epi8(p, zero), one, alphaMask);
+        __m256i hi = premultiply16AVX2(_mm256_unpackhi_epi8(p, zero), one, alphaMask);
+        _mm256_storeu_si256((__m256i*)(outData + i * 4), _mm256_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+static void selectPixelKernelsSSE(PixelKernels& kernels)
+{
+    kernels.rgba8888ToRGBA4444 = convertRGBA8888ToRGBA4444SSE2;
+    kernels.rgba8888ToRGB565 = convertRGBA8888ToRGB565SSE2;
+    kernels.rgba8888ToRGB5A1 = convertRGBA8888ToRGB5A1SSE2;
+    kernels.rgba8888ToA8 = convertRGBA8888ToA8SSE2;
+    kernels.bgra8888ToRGBA8888 = convertBGRA8888ToRGBA8888SSE2;
+    kernels.premultiplyAlpha = premultiplyAlphaSSE2;
+
+    if (isSSSE3Supported())
+    {
+        kernels.rgba8888ToRGB888 = convertRGBA8888ToRGB888SSSE3;
+        kernels.rgb888ToRGBA8888 = convertRGB888ToRGBA8888SSSE3;
+    }
+
+    if (isAVX2Supported())
+    {
+        kernels.rgba8888ToRGBA4444 = convertRGBA8888ToRGBA4444AVX2;
+        kernels.rgba8888ToRGB565 = convertRGBA8888ToRGB565AVX2;
+        kernels.rgba8888ToRGB5A1 = convertRGBA8888ToRGB5A1AVX2;
+        kernels.bgra8888ToRGBA8888 = convertBGRA8888ToRGBA8888AVX2;
+        kernels.premultiplyAlpha = premultiplyAlphaAVX2;
+    }
+}
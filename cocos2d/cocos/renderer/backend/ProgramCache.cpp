@@ -96,40 +96,11 @@ ProgramCache::~ProgramCache()
 
 bool ProgramCache::init()
 {
-    addProgram(ProgramType::POSITION_TEXTURE_COLOR);
-    addProgram(ProgramType::ETC1);
-    addProgram(ProgramType::LABEL_DISTANCE_NORMAL);
-    addProgram(ProgramType::LABEL_NORMAL);
-    addProgram(ProgramType::LABLE_OUTLINE);
-    addProgram(ProgramType::LABLE_DISTANCEFIELD_GLOW);
-    addProgram(ProgramType::POSITION_COLOR_LENGTH_TEXTURE);
-    addProgram(ProgramType::POSITION_COLOR_TEXTURE_AS_POINTSIZE);
-    addProgram(ProgramType::POSITION_COLOR);
-    addProgram(ProgramType::POSITION);
-    addProgram(ProgramType::LAYER_RADIA_GRADIENT);
-    addProgram(ProgramType::POSITION_TEXTURE);
-    addProgram(ProgramType::POSITION_TEXTURE_COLOR_ALPHA_TEST);
-    addProgram(ProgramType::POSITION_UCOLOR);
-    addProgram(ProgramType::ETC1_GRAY);
-    addProgram(ProgramType::GRAY_SCALE);
-    addProgram(ProgramType::LINE_COLOR_3D);
-    addProgram(ProgramType::CAMERA_CLEAR);
-    addProgram(ProgramType::SKYBOX_3D);
-    addProgram(ProgramType::SKINPOSITION_TEXTURE_3D);
-    addProgram(ProgramType::SKINPOSITION_NORMAL_TEXTURE_3D);
-    addProgram(ProgramType::POSITION_NORMAL_TEXTURE_3D);
-    addProgram(ProgramType::POSITION_TEXTURE_3D);
-    addProgram(ProgramType::POSITION_3D);
-    addProgram(ProgramType::POSITION_NORMAL_3D);
-    addProgram(ProgramType::POSITION_BUMPEDNORMAL_TEXTURE_3D);
-    addProgram(ProgramType::SKINPOSITION_BUMPEDNORMAL_TEXTURE_3D);
-    addProgram(ProgramType::TERRAIN_3D);
-    addProgram(ProgramType::PARTICLE_TEXTURE_3D);
-    addProgram(ProgramType::PARTICLE_COLOR_3D);
+    // Built-in programs are created on first use, see getBuiltinProgram().
     return true;
 }
 
-void ProgramCache::addProgram(ProgramType type)
+backend::Program* ProgramCache::addProgram(ProgramType type)
 {
     Program* program = nullptr;
     switch (type) {
@@ -244,18 +215,22 @@ void ProgramCache::addProgram(ProgramType type)
             CCASSERT(false, "Not built-in program type.");
             break;
     }
+    if (!program)
+        return nullptr;
+
     program->setProgramType(type);
     ProgramCache::_cachedPrograms.emplace(type, program);
+    return program;
 }
 
-backend::Program* ProgramCache::getBuiltinProgram(ProgramType type) const
+backend::Program* ProgramCache::getBuiltinProgram(ProgramType type)
 {
     const auto& iter = ProgramCache::_cachedPrograms.find(type);
     if (ProgramCache::_cachedPrograms.end() != iter)
     {
         return iter->second;
     }
-    return nullptr;
+    return addProgram(type);
 }
 
 void ProgramCache::removeProgram(backend::Program* program)
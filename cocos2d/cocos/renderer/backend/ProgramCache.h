@@ -50,8 +50,8 @@ public:
     /** purges the cache. It releases the retained instance. */
     static void destroyInstance();
     
-    /// get built-in program
-    backend::Program* getBuiltinProgram(ProgramType type) const;
+    /// get built-in program, it is created on first use
+    backend::Program* getBuiltinProgram(ProgramType type);
     
     /**
      * Remove a program object from cache.
@@ -74,12 +74,12 @@ protected:
     virtual ~ProgramCache();
     
     /**
-     * Pre-load programs into cache.
+     * Initialize the cache, built-in programs are created lazily.
      */
     bool init();
 
     /// Add built-in program
-    void addProgram(ProgramType type);
+    backend::Program* addProgram(ProgramType type);
     
     static std::unordered_map<backend::ProgramType, backend::Program*> _cachedPrograms; ///< The cached program object.
     static ProgramCache *_sharedProgramCache; ///< A shared instance of the program cache.
@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#include "CommandBufferNull.h"
+#include "DeviceNull.h"
+#include "../Buffer.h"
+#include "../RenderPipeline.h"
+#include "base/ccMacros.h"
+
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+CommandBufferNull::CommandBufferNull(DeviceNull* device)
+: _device(device)
+{
+}
+
+CommandBufferNull::~CommandBufferNull()
+{
+    cleanResources();
+    CC_SAFE_RELEASE(_renderPipeline);
+}
+
+void CommandBufferNull::beginFrame()
+{
+}
+
+void CommandBufferNull::beginRenderPass(const RenderPassDescriptor& descriptor)
+{
+    ++_device->getCurrentFrameStats().renderPasses;
+}
+
+void CommandBufferNull::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    CC_SAFE_RETAIN(renderPipeline);
+    CC_SAFE_RELEASE(_renderPipeline);
+    _renderPipeline = renderPipeline;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    if (_viewPort.x == x && _viewPort.y == y && _viewPort.w == w && _viewPort.h == h)
+        return;
+
+    _viewPort.x = x;
+    _viewPort.y = y;
+    _viewPort.w = w;
+    _viewPort.h = h;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setCullMode(CullMode mode)
+{
+    if (_cullMode == mode)
+        return;
+
+    _cullMode = mode;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setWinding(Winding winding)
+{
+    if (_winding == winding)
+        return;
+
+    _winding = winding;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setVertexBuffer(Buffer* buffer)
+{
+    if (buffer == nullptr || _vertexBuffer == buffer)
+        return;
+
+    buffer->retain();
+    CC_SAFE_RELEASE(_vertexBuffer);
+    _vertexBuffer = buffer;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setProgramState(ProgramState* programState)
+{
+    CC_SAFE_RETAIN(programState);
+    CC_SAFE_RELEASE(_programState);
+    _programState = programState;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setIndexBuffer(Buffer* buffer)
+{
+    if (buffer == nullptr || _indexBuffer == buffer)
+        return;
+
+    buffer->retain();
+    CC_SAFE_RELEASE(_indexBuffer);
+    _indexBuffer = buffer;
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::drawArrays(PrimitiveType primitiveType, std::size_t start,  std::size_t count)
+{
+    auto& stats = _device->getCurrentFrameStats();
+    ++stats.drawCalls;
+    stats.drawnElements += count;
+    cleanResources();
+}
+
+void CommandBufferNull::drawElements(PrimitiveType primitiveType, IndexFormat indexType, std::size_t count, std::size_t offset)
+{
+    auto& stats = _device->getCurrentFrameStats();
+    ++stats.drawCalls;
+    stats.drawnElements += count;
+    cleanResources();
+}
+
+void CommandBufferNull::endRenderPass()
+{
+}
+
+void CommandBufferNull::endFrame()
+{
+    _device->commitFrame();
+}
+
+void CommandBufferNull::setLineWidth(float lineWidth)
+{
+    if (lineWidth > 0.0f)
+        ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setScissorRect(bool isEnabled, float x, float y, float width, float height)
+{
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    ++_device->getCurrentFrameStats().stateChanges;
+}
+
+void CommandBufferNull::captureScreen(std::function<void(const unsigned char*, int, int)> callback)
+{
+    std::vector<unsigned char> buffer(_viewPort.w * _viewPort.h * 4, 0);
+    callback(buffer.data(), _viewPort.w, _viewPort.h);
+}
+
+void CommandBufferNull::cleanResources()
+{
+    CC_SAFE_RELEASE_NULL(_indexBuffer);
+    CC_SAFE_RELEASE_NULL(_programState);
+    CC_SAFE_RELEASE_NULL(_vertexBuffer);
+}
+
+CC_BACKEND_END
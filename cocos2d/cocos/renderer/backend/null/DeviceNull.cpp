@@ -0,0 +1,154 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#include "DeviceNull.h"
+#include "RenderPipelineNull.h"
+#include "BufferNull.h"
+#include "ShaderModuleNull.h"
+#include "CommandBufferNull.h"
+#include "TextureNull.h"
+#include "DepthStencilStateNull.h"
+#include "ProgramNull.h"
+#include "DeviceInfoNull.h"
+
+#include <cstdlib>
+#include <cstring>
+
+CC_BACKEND_BEGIN
+
+bool DeviceNull::_requested = false;
+
+RenderStatsNull& RenderStatsNull::operator +=(const RenderStatsNull& rhs)
+{
+    frames += rhs.frames;
+    renderPasses += rhs.renderPasses;
+    drawCalls += rhs.drawCalls;
+    drawnElements += rhs.drawnElements;
+    stateChanges += rhs.stateChanges;
+    bufferBytesUploaded += rhs.bufferBytesUploaded;
+    textureBytesUploaded += rhs.textureBytesUploaded;
+    buffersCreated += rhs.buffersCreated;
+    texturesCreated += rhs.texturesCreated;
+    programsCreated += rhs.programsCreated;
+    return *this;
+}
+
+bool DeviceNull::isRequested()
+{
+    if (_requested)
+        return true;
+
+    const char* backend = getenv("CC_RENDER_BACKEND");
+    return backend && strcmp(backend, "null") == 0;
+}
+
+void DeviceNull::setRequested(bool requested)
+{
+    _requested = requested;
+}
+
+DeviceNull::DeviceNull()
+{
+    _deviceInfo = new (std::nothrow) DeviceInfoNull();
+    if(!_deviceInfo || _deviceInfo->init() == false)
+    {
+        delete _deviceInfo;
+        _deviceInfo = nullptr;
+    }
+}
+
+DeviceNull::~DeviceNull()
+{
+    ProgramCache::destroyInstance();
+    delete _deviceInfo;
+    _deviceInfo = nullptr;
+}
+
+void DeviceNull::resetStats()
+{
+    _currentFrameStats.reset();
+    _lastFrameStats.reset();
+    _totalStats.reset();
+}
+
+void DeviceNull::commitFrame()
+{
+    _currentFrameStats.frames = 1;
+    _totalStats += _currentFrameStats;
+    _lastFrameStats = _currentFrameStats;
+    _currentFrameStats.reset();
+}
+
+CommandBuffer* DeviceNull::newCommandBuffer()
+{
+    return new (std::nothrow) CommandBufferNull(this);
+}
+
+Buffer* DeviceNull::newBuffer(std::size_t size, BufferType type, BufferUsage usage)
+{
+    ++_currentFrameStats.buffersCreated;
+    return new (std::nothrow) BufferNull(this, size, type, usage);
+}
+
+TextureBackend* DeviceNull::newTexture(const TextureDescriptor& descriptor)
+{
+    switch (descriptor.textureType)
+    {
+    case TextureType::TEXTURE_2D:
+        ++_currentFrameStats.texturesCreated;
+        return new (std::nothrow) Texture2DNull(this, descriptor);
+    case TextureType::TEXTURE_CUBE:
+        ++_currentFrameStats.texturesCreated;
+        return new (std::nothrow) TextureCubeNull(this, descriptor);
+    default:
+        return nullptr;
+    }
+}
+
+ShaderModule* DeviceNull::newShaderModule(ShaderStage stage, const std::string& source)
+{
+    return new (std::nothrow) ShaderModuleNull(stage, source);
+}
+
+DepthStencilState* DeviceNull::createDepthStencilState(const DepthStencilDescriptor& descriptor)
+{
+    auto ret = new (std::nothrow) DepthStencilStateNull(descriptor);
+    if (ret)
+        ret->autorelease();
+
+    return ret;
+}
+
+RenderPipeline* DeviceNull::newRenderPipeline()
+{
+    return new (std::nothrow) RenderPipelineNull();
+}
+
+Program* DeviceNull::newProgram(const std::string& vertexShader, const std::string& fragmentShader)
+{
+    ++_currentFrameStats.programsCreated;
+    return new (std::nothrow) ProgramNull(vertexShader, fragmentShader);
+}
+
+CC_BACKEND_END
@@ -0,0 +1,130 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#pragma once
+
+#include "../Device.h"
+
+#include <cstdint>
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * Counters recorded by the null backend instead of issuing GPU work.
+ */
+struct RenderStatsNull
+{
+    uint64_t frames = 0;                ///< Number of endFrame() calls.
+    uint64_t renderPasses = 0;          ///< Number of beginRenderPass() calls.
+    uint64_t drawCalls = 0;             ///< drawArrays() + drawElements() calls.
+    uint64_t drawnElements = 0;         ///< Vertices or indices submitted by draw calls.
+    uint64_t stateChanges = 0;          ///< Pipeline, program state, buffer, viewport, scissor, cull, winding and depth stencil changes.
+    uint64_t bufferBytesUploaded = 0;   ///< Bytes passed to Buffer::updateData/updateSubData.
+    uint64_t textureBytesUploaded = 0;  ///< Bytes passed to texture update functions.
+    uint64_t buffersCreated = 0;        ///< Buffer objects created.
+    uint64_t texturesCreated = 0;       ///< Texture objects created.
+    uint64_t programsCreated = 0;       ///< Program objects created.
+
+    void reset() { *this = RenderStatsNull(); }
+    RenderStatsNull& operator +=(const RenderStatsNull& rhs);
+};
+
+/**
+ * A device which creates resources that do no GPU work but record what would have been submitted.
+ * Used to measure CPU-side frame cost deterministically without a GL context.
+ */
+class DeviceNull : public Device
+{
+public:
+    DeviceNull();
+    ~DeviceNull();
+
+    /**
+     * Whether the null backend should be used instead of the platform backend.
+     * True if `setRequested(true)` was called or the environment variable `CC_RENDER_BACKEND` is "null".
+     * Must be decided before the first call to Device::getInstance().
+     */
+    static bool isRequested();
+
+    /**
+     * Select the null backend at startup.
+     * @param requested Specifies whether the null backend should be created by Device::getInstance().
+     */
+    static void setRequested(bool requested);
+
+    virtual CommandBuffer* newCommandBuffer() override;
+
+    virtual Buffer* newBuffer(std::size_t size, BufferType type, BufferUsage usage) override;
+
+    virtual TextureBackend* newTexture(const TextureDescriptor& descriptor) override;
+
+    virtual DepthStencilState* createDepthStencilState(const DepthStencilDescriptor& descriptor) override;
+
+    virtual RenderPipeline* newRenderPipeline() override;
+
+    virtual void setFrameBufferOnly(bool frameBufferOnly) override {}
+
+    virtual Program* newProgram(const std::string& vertexShader, const std::string& fragmentShader) override;
+
+    /**
+     * Get counters of the frame being recorded.
+     * @return Counters accumulated since the last endFrame().
+     */
+    inline RenderStatsNull& getCurrentFrameStats() { return _currentFrameStats; }
+
+    /**
+     * Get counters of the last completed frame.
+     * @return Counters recorded between the last two endFrame() calls.
+     */
+    inline const RenderStatsNull& getLastFrameStats() const { return _lastFrameStats; }
+
+    /**
+     * Get counters accumulated since the device was created or resetStats() was called.
+     * @return Accumulated counters, not including the frame being recorded.
+     */
+    inline const RenderStatsNull& getTotalStats() const { return _totalStats; }
+
+    /// Reset all counters.
+    void resetStats();
+
+    /// Close the frame being recorded, called by CommandBufferNull::endFrame().
+    void commitFrame();
+
+protected:
+    virtual ShaderModule* newShaderModule(ShaderStage stage, const std::string& source) override;
+
+private:
+    RenderStatsNull _currentFrameStats;
+    RenderStatsNull _lastFrameStats;
+    RenderStatsNull _totalStats;
+
+    static bool _requested;
+};
+//end of _null group
+/// @}
+CC_BACKEND_END
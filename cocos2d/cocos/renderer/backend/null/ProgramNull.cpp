@@ -0,0 +1,253 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#include "ProgramNull.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    /// Size in bytes of a GLSL type, 0 for samplers, matching UtilsGL::getGLDataTypeSize().
+    unsigned int getTypeSize(const std::string& type)
+    {
+        static const std::unordered_map<std::string, unsigned int> sizes = {
+            {"bool", 1}, {"int", 4}, {"uint", 4}, {"float", 4},
+            {"bvec2", 2}, {"bvec3", 1}, {"bvec4", 4},
+            {"vec2", 8}, {"ivec2", 8},
+            {"vec3", 12}, {"ivec3", 12},
+            {"vec4", 16}, {"ivec4", 16}, {"mat2", 16},
+            {"mat3", 36},
+            {"mat4", 64},
+        };
+        auto iter = sizes.find(type);
+        return iter == sizes.end() ? 0 : iter->second;
+    }
+
+    bool isQualifier(const std::string& token)
+    {
+        return token == "lowp" || token == "mediump" || token == "highp" ||
+               token == "const" || token == "in" || token == "flat";
+    }
+
+    int getAttributeIndex(const std::string& name)
+    {
+        if (name == ATTRIBUTE_NAME_POSITION) return Attribute::POSITION;
+        if (name == ATTRIBUTE_NAME_COLOR) return Attribute::COLOR;
+        if (name == ATTRIBUTE_NAME_TEXCOORD) return Attribute::TEXCOORD;
+        if (name == ATTRIBUTE_NAME_TEXCOORD1) return Attribute::TEXCOORD1;
+        if (name == ATTRIBUTE_NAME_TEXCOORD2) return Attribute::TEXCOORD2;
+        if (name == ATTRIBUTE_NAME_TEXCOORD3) return Attribute::TEXCOORD3;
+        return -1;
+    }
+}
+
+ProgramNull::ProgramNull(const std::string& vertexShader, const std::string& fragmentShader)
+: Program(vertexShader, fragmentShader)
+{
+    parseDeclarations(_vertexShader);
+    parseDeclarations(_fragmentShader);
+    computeLocations();
+}
+
+void ProgramNull::parseDeclarations(const std::string& source)
+{
+    // Split on whitespace and punctuation, keeping ';' ',' '[' ']' as tokens.
+    std::vector<std::string> tokens;
+    std::string current;
+    for (auto c : source)
+    {
+        if (isalnum(static_cast<unsigned char>(c)) || c == '_')
+        {
+            current += c;
+            continue;
+        }
+        if (!current.empty())
+        {
+            tokens.push_back(current);
+            current.clear();
+        }
+        if (c == ';' || c == ',' || c == '[' || c == ']' || c == '{' || c == '(')
+            tokens.push_back(std::string(1, c));
+    }
+    if (!current.empty())
+        tokens.push_back(current);
+
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        bool isUniform = tokens[i] == "uniform";
+        bool isAttribute = tokens[i] == "attribute";
+        if (!isUniform && !isAttribute)
+            continue;
+
+        std::size_t j = i + 1;
+        while (j < tokens.size() && isQualifier(tokens[j]))
+            ++j;
+        if (j >= tokens.size())
+            break;
+
+        const std::string type = tokens[j++];
+        while (j < tokens.size() && tokens[j] != ";" && tokens[j] != "{" && tokens[j] != "(")
+        {
+            if (tokens[j] == ",")
+            {
+                ++j;
+                continue;
+            }
+
+            const std::string name = tokens[j++];
+            int count = 1;
+            bool isArray = false;
+            if (j + 2 < tokens.size() && tokens[j] == "[" && tokens[j + 2] == "]")
+            {
+                count = std::max(1, atoi(tokens[j + 1].c_str()));
+                isArray = true;
+                j += 3;
+            }
+
+            if (isUniform && _activeUniformInfos.find(name) == _activeUniformInfos.end())
+            {
+                UniformInfo uniform;
+                uniform.count = count;
+                uniform.isArray = isArray;
+                uniform.location = _maxLocation++;
+                uniform.size = getTypeSize(type);
+                uniform.bufferOffset = (uniform.size == 0) ? 0 : _totalBufferSize;
+                _activeUniformInfos[name] = uniform;
+                _totalBufferSize += uniform.size * uniform.count;
+            }
+            else if (isAttribute && _activeAttributes.find(name) == _activeAttributes.end())
+            {
+                AttributeBindInfo info;
+                info.attributeName = name;
+                info.location = static_cast<int>(_activeAttributes.size());
+                info.size = getTypeSize(type) * count;
+                _activeAttributes[name] = info;
+            }
+        }
+        i = j;
+    }
+}
+
+void ProgramNull::computeLocations()
+{
+    std::fill(_builtinAttributeLocation, _builtinAttributeLocation + ATTRIBUTE_MAX, -1);
+    for (const auto& attribute : _activeAttributes)
+    {
+        auto index = getAttributeIndex(attribute.first);
+        if (index >= 0)
+            _builtinAttributeLocation[index] = attribute.second.location;
+    }
+
+    const std::pair<Uniform, const char*> builtinUniforms[] = {
+        {Uniform::MVP_MATRIX, UNIFORM_NAME_MVP_MATRIX},
+        {Uniform::TEXTURE, UNIFORM_NAME_TEXTURE},
+        {Uniform::TEXTURE1, UNIFORM_NAME_TEXTURE1},
+        {Uniform::TEXTURE2, UNIFORM_NAME_TEXTURE2},
+        {Uniform::TEXTURE3, UNIFORM_NAME_TEXTURE3},
+        {Uniform::TEXT_COLOR, UNIFORM_NAME_TEXT_COLOR},
+        {Uniform::EFFECT_TYPE, UNIFORM_NAME_EFFECT_TYPE},
+        {Uniform::EFFECT_COLOR, UNIFORM_NAME_EFFECT_COLOR},
+    };
+    for (const auto& uniform : builtinUniforms)
+        _builtinUniformLocation[uniform.first] = getUniformLocation(uniform.second);
+}
+
+UniformLocation ProgramNull::getUniformLocation(const std::string& uniform) const
+{
+    UniformLocation uniformLocation;
+    auto iter = _activeUniformInfos.find(uniform);
+    if (iter != _activeUniformInfos.end())
+    {
+        uniformLocation.location[0] = iter->second.location;
+        uniformLocation.location[1] = iter->second.bufferOffset;
+    }
+    return uniformLocation;
+}
+
+UniformLocation ProgramNull::getUniformLocation(backend::Uniform name) const
+{
+    return _builtinUniformLocation[name];
+}
+
+int ProgramNull::getAttributeLocation(const std::string& name) const
+{
+    auto iter = _activeAttributes.find(name);
+    return iter == _activeAttributes.end() ? -1 : iter->second.location;
+}
+
+int ProgramNull::getAttributeLocation(backend::Attribute name) const
+{
+    return _builtinAttributeLocation[name];
+}
+
+int ProgramNull::getMaxVertexLocation() const
+{
+    return _maxLocation;
+}
+
+int ProgramNull::getMaxFragmentLocation() const
+{
+    return _maxLocation;
+}
+
+const std::unordered_map<std::string, AttributeBindInfo> ProgramNull::getActiveAttributes() const
+{
+    return _activeAttributes;
+}
+
+std::size_t ProgramNull::getUniformBufferSize(ShaderStage stage) const
+{
+    return _totalBufferSize;
+}
+
+const UniformInfo& ProgramNull::getActiveUniformInfo(ShaderStage stage, int location) const
+{
+    for (const auto& uniform : _activeUniformInfos)
+    {
+        if (uniform.second.location == location)
+            return uniform.second;
+    }
+    return _emptyUniformInfo;
+}
+
+const std::unordered_map<std::string, UniformInfo>& ProgramNull::getAllActiveUniformInfo(ShaderStage stage) const
+{
+    return _activeUniformInfos;
+}
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+const std::unordered_map<std::string, int> ProgramNull::getAllUniformsLocation() const
+{
+    std::unordered_map<std::string, int> locations;
+    for (const auto& uniform : _activeUniformInfos)
+        locations[uniform.first] = uniform.second.location;
+    return locations;
+}
+#endif
+
+CC_BACKEND_END
@@ -0,0 +1,94 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#pragma once
+
+#include "../Program.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A program which is never linked.
+ * Uniforms and attributes are reflected from the GLSL declarations so that ProgramState can lay out its uniform buffers as usual.
+ */
+class ProgramNull : public Program
+{
+public:
+    /**
+     * @param vertexShader Specifes the vertex shader source.
+     * @param fragmentShader Specifes the fragment shader source.
+     */
+    ProgramNull(const std::string& vertexShader, const std::string& fragmentShader);
+
+    virtual UniformLocation getUniformLocation(const std::string& uniform) const override;
+
+    virtual UniformLocation getUniformLocation(backend::Uniform name) const override;
+
+    virtual int getAttributeLocation(const std::string& name) const override;
+
+    virtual int getAttributeLocation(backend::Attribute name) const override;
+
+    virtual int getMaxVertexLocation() const override;
+
+    virtual int getMaxFragmentLocation() const override;
+
+    virtual const std::unordered_map<std::string, AttributeBindInfo> getActiveAttributes() const override;
+
+    virtual std::size_t getUniformBufferSize(ShaderStage stage) const override;
+
+    virtual const UniformInfo& getActiveUniformInfo(ShaderStage stage, int location) const override;
+
+    virtual const std::unordered_map<std::string, UniformInfo>& getAllActiveUniformInfo(ShaderStage stage) const override;
+
+protected:
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    virtual int getMappedLocation(int location) const override { return location; }
+    virtual int getOriginalLocation(int location) const override { return location; }
+    virtual const std::unordered_map<std::string, int> getAllUniformsLocation() const override;
+#endif
+
+private:
+    void parseDeclarations(const std::string& source);
+    void computeLocations();
+
+    std::unordered_map<std::string, AttributeBindInfo> _activeAttributes;
+    std::unordered_map<std::string, UniformInfo> _activeUniformInfos;
+    UniformInfo _emptyUniformInfo;
+    std::size_t _totalBufferSize = 0;
+    int _maxLocation = 0;
+
+    int _builtinAttributeLocation[ATTRIBUTE_MAX];
+    UniformLocation _builtinUniformLocation[UNIFORM_MAX];
+};
+//end of _null group
+/// @}
+CC_BACKEND_END
@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#pragma once
+
+#include "../Texture.h"
+
+CC_BACKEND_BEGIN
+
+class DeviceNull;
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A 2D texture without storage, only records uploaded bytes.
+ */
+class Texture2DNull : public backend::Texture2DBackend
+{
+public:
+    /**
+     * @param device Specifies the device which records statistics.
+     * @param descriptor Specifies the texture description.
+     */
+    Texture2DNull(DeviceNull* device, const TextureDescriptor& descriptor);
+
+    virtual void updateData(uint8_t* data, std::size_t width , std::size_t height, std::size_t level) override;
+
+    virtual void updateCompressedData(uint8_t* data, std::size_t width , std::size_t height, std::size_t dataLen, std::size_t level) override;
+
+    virtual void updateSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t level, uint8_t* data) override;
+
+    virtual void updateCompressedSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t dataLen, std::size_t level, uint8_t* data) override;
+
+    virtual void updateSamplerDescriptor(const SamplerDescriptor &sampler) override {}
+
+    /**
+     * Returns zero-filled pixels, since nothing is ever rendered.
+     */
+    virtual void getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback) override;
+
+    virtual void generateMipmaps() override;
+
+private:
+    DeviceNull* _device = nullptr;
+};
+
+/**
+ * A cube texture without storage, only records uploaded bytes.
+ */
+class TextureCubeNull : public backend::TextureCubemapBackend
+{
+public:
+    /**
+     * @param device Specifies the device which records statistics.
+     * @param descriptor Specifies the texture description.
+     */
+    TextureCubeNull(DeviceNull* device, const TextureDescriptor& descriptor);
+
+    virtual void updateSamplerDescriptor(const SamplerDescriptor &sampler) override {}
+
+    virtual void updateFaceData(TextureCubeFace side, void *data) override;
+
+    virtual void getBytes(std::size_t x, std::size_t y, std::size_t width, std::size_t height, bool flipImage, std::function<void(const unsigned char*, std::size_t, std::size_t)> callback) override;
+
+    virtual void generateMipmaps() override;
+
+private:
+    DeviceNull* _device = nullptr;
+};
+
+//end of _null group
+/// @}
+CC_BACKEND_END
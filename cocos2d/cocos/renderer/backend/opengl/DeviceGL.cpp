@@ -31,13 +31,25 @@
 #include "DepthStencilStateGL.h"
 #include "ProgramGL.h"
 #include "DeviceInfoGL.h"
+#include "ProgramBinaryCacheGL.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#include "../null/DeviceNull.h"
+#endif
 
 CC_BACKEND_BEGIN
 
 Device* Device::getInstance()
 {
     if (!_instance)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        if (DeviceNull::isRequested())
+            _instance = new (std::nothrow) DeviceNull();
+        else
+#endif
         _instance = new (std::nothrow) DeviceGL();
+    }
     
     return _instance;
 }
@@ -55,6 +67,7 @@ DeviceGL::DeviceGL()
 DeviceGL::~DeviceGL()
 {
     ProgramCache::destroyInstance();
+    ProgramBinaryCacheGL::destroyInstance();
     delete _deviceInfo;
     _deviceInfo = nullptr;
 }
@@ -0,0 +1,267 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#include "ProgramBinaryCacheGL.h"
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+#include "xxhash.h"
+
+#include <chrono>
+#include <cstring>
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+#include <EGL/egl.h>
+#endif
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    const uint32_t BINARY_MAGIC = 0x42504343; // "CCPB"
+    const uint32_t BINARY_VERSION = 1;
+
+    struct BinaryHeader
+    {
+        uint32_t magic = BINARY_MAGIC;
+        uint32_t version = BINARY_VERSION;
+        uint32_t driverHash = 0;
+        uint32_t sourceHash = 0;
+        uint32_t format = 0;
+        uint32_t length = 0;
+    };
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    PFNGLGETPROGRAMBINARYOESPROC getProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYOESPROC programBinary = nullptr;
+    const GLenum NUM_PROGRAM_BINARY_FORMATS = GL_NUM_PROGRAM_BINARY_FORMATS_OES;
+    const GLenum PROGRAM_BINARY_LENGTH = GL_PROGRAM_BINARY_LENGTH_OES;
+
+    bool loadEntryPoints()
+    {
+        const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+        if (!extensions || !strstr(extensions, "GL_OES_get_program_binary"))
+            return false;
+
+        getProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+        programBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+        return getProgramBinary && programBinary;
+    }
+#else
+    const GLenum NUM_PROGRAM_BINARY_FORMATS = GL_NUM_PROGRAM_BINARY_FORMATS;
+    const GLenum PROGRAM_BINARY_LENGTH = GL_PROGRAM_BINARY_LENGTH;
+
+    void getProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+    {
+        glGetProgramBinary(program, bufSize, length, binaryFormat, binary);
+    }
+
+    void programBinary(GLuint program, GLenum binaryFormat, const void* binary, GLint length)
+    {
+        glProgramBinary(program, binaryFormat, binary, length);
+    }
+
+    bool loadEntryPoints()
+    {
+        return glGetProgramBinary != nullptr && glProgramBinary != nullptr;
+    }
+#endif
+
+    uint32_t hashString(const char* str, uint32_t seed)
+    {
+        return str ? XXH32(str, (int)strlen(str), seed) : seed;
+    }
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+ProgramBinaryCacheGL* ProgramBinaryCacheGL::_sharedCache = nullptr;
+
+ProgramBinaryCacheGL* ProgramBinaryCacheGL::getInstance()
+{
+    if (!_sharedCache)
+        _sharedCache = new (std::nothrow) ProgramBinaryCacheGL();
+
+    return _sharedCache;
+}
+
+void ProgramBinaryCacheGL::destroyInstance()
+{
+    CC_SAFE_DELETE(_sharedCache);
+}
+
+ProgramBinaryCacheGL::ProgramBinaryCacheGL()
+{
+    GLint numFormats = 0;
+    if (loadEntryPoints())
+        glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    _supported = numFormats > 0;
+    if (!_supported)
+        return;
+
+    uint32_t hash = hashString(reinterpret_cast<const char*>(glGetString(GL_VENDOR)), 0);
+    hash = hashString(reinterpret_cast<const char*>(glGetString(GL_RENDERER)), hash);
+    _driverHash = hashString(reinterpret_cast<const char*>(glGetString(GL_VERSION)), hash);
+
+    _cacheDirectory = FileUtils::getInstance()->getWritablePath() + "program_cache/";
+    if (!FileUtils::getInstance()->isDirectoryExist(_cacheDirectory) && !FileUtils::getInstance()->createDirectory(_cacheDirectory))
+    {
+        CCLOG("cocos2d: ProgramBinaryCacheGL: can not create %s, cache disabled", _cacheDirectory.c_str());
+        _supported = false;
+    }
+}
+
+std::string ProgramBinaryCacheGL::getBinaryPath(const std::string& vertexShader, const std::string& fragmentShader) const
+{
+    uint32_t vertexHash = XXH32(vertexShader.data(), (int)vertexShader.size(), _driverHash);
+    uint32_t fragmentHash = XXH32(fragmentShader.data(), (int)fragmentShader.size(), vertexHash);
+
+    char name[32];
+    snprintf(name, sizeof(name), "%08x%08x.bin", vertexHash, fragmentHash);
+    return _cacheDirectory + name;
+}
+
+GLuint ProgramBinaryCacheGL::loadProgram(const std::string& vertexShader, const std::string& fragmentShader)
+{
+    if (!isEnabled())
+        return 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto path = getBinaryPath(vertexShader, fragmentShader);
+    if (!FileUtils::getInstance()->isFileExist(path))
+        return 0;
+
+    Data data = FileUtils::getInstance()->getDataFromFile(path);
+    BinaryHeader header;
+    if (data.getSize() < 0 || static_cast<size_t>(data.getSize()) < sizeof(header))
+        return 0;
+    size_t binaryLength = static_cast<size_t>(data.getSize()) - sizeof(header);
+
+    memcpy(&header, data.getBytes(), sizeof(header));
+    uint32_t sourceHash = XXH32(fragmentShader.data(), (int)fragmentShader.size(), XXH32(vertexShader.data(), (int)vertexShader.size(), 0));
+    if (header.magic != BINARY_MAGIC || header.version != BINARY_VERSION ||
+        header.driverHash != _driverHash || header.sourceHash != sourceHash ||
+        header.length != binaryLength)
+    {
+        ++_statistics.rejected;
+        FileUtils::getInstance()->removeFile(path);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    programBinary(program, header.format, data.getBytes() + sizeof(header), header.length);
+
+    GLint status = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (GL_FALSE == status)
+    {
+        // The driver may refuse binaries it produced itself, e.g. after an update with the same version string.
+        ++_statistics.rejected;
+        glDeleteProgram(program);
+        FileUtils::getInstance()->removeFile(path);
+        return 0;
+    }
+
+    ++_statistics.hits;
+    _statistics.loadMilliseconds += millisecondsSince(start);
+    return program;
+}
+
+void ProgramBinaryCacheGL::prepareProgram(GLuint program) const
+{
+#if CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
+    if (isEnabled() && glProgramParameteri)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+}
+
+void ProgramBinaryCacheGL::saveProgram(GLuint program, const std::string& vertexShader, const std::string& fragmentShader)
+{
+    ++_statistics.misses;
+    if (!isEnabled() || !program)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    BinaryHeader header;
+    header.driverHash = _driverHash;
+    header.sourceHash = XXH32(fragmentShader.data(), (int)fragmentShader.size(), XXH32(vertexShader.data(), (int)vertexShader.size(), 0));
+
+    Data data;
+    auto bytes = (unsigned char*)malloc(sizeof(header) + length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    getProgramBinary(program, length, &written, &format, bytes + sizeof(header));
+    if (written <= 0)
+    {
+        free(bytes);
+        return;
+    }
+
+    header.format = format;
+    header.length = written;
+    memcpy(bytes, &header, sizeof(header));
+    data.fastSet(bytes, sizeof(header) + written);
+
+    ++_statistics.stored;
+    FileUtils::getInstance()->writeDataToFile(std::move(data), getBinaryPath(vertexShader, fragmentShader), [](bool success) {
+        if (!success)
+            CCLOG("cocos2d: ProgramBinaryCacheGL: failed to write program binary");
+    });
+}
+
+void ProgramBinaryCacheGL::addCompileTime(double milliseconds)
+{
+    _statistics.compileMilliseconds += milliseconds;
+}
+
+void ProgramBinaryCacheGL::removeAllBinaries()
+{
+    if (_cacheDirectory.empty())
+        return;
+
+    FileUtils::getInstance()->removeDirectory(_cacheDirectory);
+    FileUtils::getInstance()->createDirectory(_cacheDirectory);
+}
+
+std::string ProgramBinaryCacheGL::getStatisticsInfo() const
+{
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "programs: %u (cached %u, compiled %u, rejected %u), load %.1f ms, compile %.1f ms%s",
+             _statistics.hits + _statistics.misses,
+             _statistics.hits,
+             _statistics.misses,
+             _statistics.rejected,
+             _statistics.loadMilliseconds,
+             _statistics.compileMilliseconds,
+             isEnabled() ? "" : " (binary cache unsupported)");
+    return buffer;
+}
+
+CC_BACKEND_END
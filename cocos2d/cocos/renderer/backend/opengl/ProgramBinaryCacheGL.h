@@ -0,0 +1,124 @@
+/****************************************************************************
+ Copyright (c) 2018-2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+ 
+#pragma once
+
+#include "../Macros.h"
+#include "platform/CCGL.h"
+
+#include <string>
+
+CC_BACKEND_BEGIN
+/**
+ * @addtogroup _opengl
+ * @{
+ */
+
+/**
+ * Persistent cache of linked program binaries, stored under FileUtils::getWritablePath().
+ * Entries are keyed by the shader sources and the driver vendor, renderer and version strings,
+ * so a driver update invalidates them. Uses glGetProgramBinary/glProgramBinary where supported.
+ */
+class ProgramBinaryCacheGL
+{
+public:
+    /// Counters of program creation, including time spent in the driver.
+    struct Statistics
+    {
+        unsigned int hits = 0;           ///< Programs created from a cached binary.
+        unsigned int misses = 0;         ///< Programs compiled from source.
+        unsigned int rejected = 0;       ///< Cached binaries the driver refused to load.
+        unsigned int stored = 0;         ///< Binaries written to disk.
+        double loadMilliseconds = 0;     ///< Time spent loading cached binaries.
+        double compileMilliseconds = 0;  ///< Time spent compiling and linking from source.
+    };
+
+    static ProgramBinaryCacheGL* getInstance();
+
+    static void destroyInstance();
+
+    /**
+     * Whether the driver supports retrieving and loading program binaries and the cache is enabled.
+     */
+    bool isEnabled() const { return _supported && _enabled; }
+
+    /**
+     * Enable or disable the cache, enabled by default where supported.
+     */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+
+    /**
+     * Create a linked program from a cached binary.
+     * @param vertexShader The final vertex shader source.
+     * @param fragmentShader The final fragment shader source.
+     * @return The program object, or 0 if there is no valid cached binary.
+     */
+    GLuint loadProgram(const std::string& vertexShader, const std::string& fragmentShader);
+
+    /**
+     * Set the hints required to retrieve the binary, must be called before glLinkProgram().
+     */
+    void prepareProgram(GLuint program) const;
+
+    /**
+     * Store the binary of a linked program.
+     * @param program A program which was linked successfully.
+     * @param vertexShader The final vertex shader source.
+     * @param fragmentShader The final fragment shader source.
+     */
+    void saveProgram(GLuint program, const std::string& vertexShader, const std::string& fragmentShader);
+
+    /**
+     * Add time spent compiling a program from source, reported in the statistics.
+     */
+    void addCompileTime(double milliseconds);
+
+    /**
+     * Remove all cached binaries from disk.
+     */
+    void removeAllBinaries();
+
+    const Statistics& getStatistics() const { return _statistics; }
+
+    /**
+     * Output program creation statistics, e.g. "programs: 30 (cached 28, compiled 2, rejected 0), load 12.5 ms, compile 48.1 ms".
+     */
+    std::string getStatisticsInfo() const;
+
+private:
+    ProgramBinaryCacheGL();
+
+    std::string getBinaryPath(const std::string& vertexShader, const std::string& fragmentShader) const;
+
+    static ProgramBinaryCacheGL* _sharedCache;
+
+    std::string _cacheDirectory;
+    unsigned int _driverHash = 0;
+    bool _supported = false;
+    bool _enabled = true;
+    Statistics _statistics;
+};
+//end of _opengl group
+/// @}
+CC_BACKEND_END
@@ -30,6 +30,9 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
 #include "renderer/backend/opengl/UtilsGL.h"
+#include "renderer/backend/opengl/ProgramBinaryCacheGL.h"
+
+#include <chrono>
 
 CC_BACKEND_BEGIN
 namespace {
@@ -40,18 +43,20 @@ namespace {
 ProgramGL::ProgramGL(const std::string& vertexShader, const std::string& fragmentShader)
 : Program(vertexShader, fragmentShader)
 {
-#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
-    //some device required manually specify the precision qualifiers for vertex shader.
-    _vertexShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newVertexShaderModule(std::move(vsPreDefine + _vertexShader)));
-    _fragmentShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newFragmentShaderModule(std::move(fsPreDefine +  _fragmentShader)));
-#else
-    _vertexShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newVertexShaderModule(_vertexShader));
-    _fragmentShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newFragmentShaderModule(_fragmentShader));
-#endif
-
-    CC_SAFE_RETAIN(_vertexShaderModule);
-    CC_SAFE_RETAIN(_fragmentShaderModule);
-    compileProgram();
+    auto binaryCache = ProgramBinaryCacheGL::getInstance();
+    _program = binaryCache->loadProgram(getVertexSource(), getFragmentSource());
+    if (!_program)
+    {
+        auto start = std::chrono::steady_clock::now();
+        _vertexShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newVertexShaderModule(getVertexSource()));
+        _fragmentShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newFragmentShaderModule(getFragmentSource()));
+
+        CC_SAFE_RETAIN(_vertexShaderModule);
+        CC_SAFE_RETAIN(_fragmentShaderModule);
+        compileProgram();
+        binaryCache->addCompileTime(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        binaryCache->saveProgram(_program, getVertexSource(), getFragmentSource());
+    }
     computeUniformInfos();
     computeLocations();
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -88,9 +93,26 @@ void ProgramGL::reloadProgram()
     _activeUniformInfos.clear();
     _mapToCurrentActiveLocation.clear();
     _mapToOriginalLocation.clear();
-    static_cast<ShaderModuleGL*>(_vertexShaderModule)->compileShader(backend::ShaderStage::VERTEX, std::move(vsPreDefine + _vertexShader));
-    static_cast<ShaderModuleGL*>(_fragmentShaderModule)->compileShader(backend::ShaderStage::FRAGMENT, std::move(fsPreDefine + _fragmentShader));
-    compileProgram();
+    auto binaryCache = ProgramBinaryCacheGL::getInstance();
+    _program = binaryCache->loadProgram(getVertexSource(), getFragmentSource());
+    if (!_program)
+    {
+        if (_vertexShaderModule && _fragmentShaderModule)
+        {
+            _vertexShaderModule->compileShader(backend::ShaderStage::VERTEX, getVertexSource());
+            _fragmentShaderModule->compileShader(backend::ShaderStage::FRAGMENT, getFragmentSource());
+        }
+        else
+        {
+            // The program was loaded from a binary, the shaders have never been compiled.
+            _vertexShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newVertexShaderModule(getVertexSource()));
+            _fragmentShaderModule = static_cast<ShaderModuleGL*>(ShaderCache::newFragmentShaderModule(getFragmentSource()));
+            CC_SAFE_RETAIN(_vertexShaderModule);
+            CC_SAFE_RETAIN(_fragmentShaderModule);
+        }
+        compileProgram();
+        binaryCache->saveProgram(_program, getVertexSource(), getFragmentSource());
+    }
     computeUniformInfos();
 
     for(const auto& uniform : _activeUniformInfos)
@@ -102,6 +124,25 @@ void ProgramGL::reloadProgram()
 }
 #endif
 
+std::string ProgramGL::getVertexSource() const
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    //some device required manually specify the precision qualifiers for vertex shader.
+    return vsPreDefine + _vertexShader;
+#else
+    return _vertexShader;
+#endif
+}
+
+std::string ProgramGL::getFragmentSource() const
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    return fsPreDefine + _fragmentShader;
+#else
+    return _fragmentShader;
+#endif
+}
+
 void ProgramGL::compileProgram()
 {
     if (_vertexShaderModule == nullptr || _fragmentShaderModule == nullptr)
@@ -120,7 +161,8 @@ void ProgramGL::compileProgram()
     
     glAttachShader(_program, vertShader);
     glAttachShader(_program, fragShader);
-    
+
+    ProgramBinaryCacheGL::getInstance()->prepareProgram(_program);
     glLinkProgram(_program);
     
     GLint status = 0;
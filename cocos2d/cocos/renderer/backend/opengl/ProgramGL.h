@@ -158,6 +158,8 @@ public:
     virtual const std::unordered_map<std::string, UniformInfo>& getAllActiveUniformInfo(ShaderStage stage) const override ;
 
 private:
+    std::string getVertexSource() const;
+    std::string getFragmentSource() const;
     void compileProgram();
     bool getAttributeLocation(const std::string& attributeName, unsigned int& location) const;
     void computeUniformInfos();
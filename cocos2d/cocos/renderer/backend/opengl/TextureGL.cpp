@@ -50,6 +50,27 @@ namespace {
         }
         return false;
     }
+
+    // uses the largest alignment the tightly packed rows allow
+    void setUnpackAlignment(std::size_t bytesPerRow)
+    {
+        if(bytesPerRow % 8 == 0)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+        }
+        else if(bytesPerRow % 4 == 0)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        else if(bytesPerRow % 2 == 0)
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+        }
+        else
+        {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        }
+    }
 }
 
 void TextureInfoGL::applySamplerDescriptor(const SamplerDescriptor& descriptor, bool isPow2, bool hasMipmaps)
@@ -116,7 +137,12 @@ void Texture2DGL::updateTextureDescriptor(const cocos2d::backend::TextureDescrip
 
     // Update data here because `updateData()` may not be invoked later.
     // For example, a texture used as depth buffer will not invoke updateData().
-    initWithZeros();
+    // Sampled textures are always filled by updateData() or updateSubData(), so only their storage is allocated,
+    // uploading zeros first would double the upload of every image.
+    if (_textureUsage == TextureUsage::READ && !_isCompressed)
+        updateData(nullptr, _width, _height, 0);
+    else
+        initWithZeros();
 }
 
 Texture2DGL::~Texture2DGL()
@@ -163,24 +189,7 @@ void Texture2DGL::updateData(uint8_t* data, std::size_t width , std::size_t heig
     auto mipmapEnalbed = isMipmapEnabled(_textureInfo.minFilterGL) || isMipmapEnabled(_textureInfo.magFilterGL);
     if(!mipmapEnalbed)
     {
-        unsigned int bytesPerRow = width * _bitsPerElement / 8;
-
-        if(bytesPerRow % 8 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
-        }
-        else if(bytesPerRow % 4 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-        }
-        else if(bytesPerRow % 2 == 0)
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-        }
-        else
-        {
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        }
+        setUnpackAlignment(width * _bitsPerElement / 8);
     }
     else
     {
@@ -239,6 +248,9 @@ void Texture2DGL::updateCompressedData(uint8_t *data, std::size_t width, std::si
 
 void Texture2DGL::updateSubData(std::size_t xoffset, std::size_t yoffset, std::size_t width, std::size_t height, std::size_t level, uint8_t* data)
 {
+    // the rows of data are tightly packed, the alignment left by a previous upload may not match them
+    setUnpackAlignment(width * _bitsPerElement / 8);
+
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, _textureInfo.texture);
 
@@ -303,6 +303,8 @@ public:
     void setTouchAreaEnabled(bool enable);
     
     virtual bool hitTest(const Vec2 &pt, const Camera* camera, Vec3 *p) const override;
+    //touches outside the text field detach it from the IME
+    virtual bool isHitAreaInsideContentSize() const override { return false; }
     
     
     /**
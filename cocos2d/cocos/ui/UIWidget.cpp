@@ -578,6 +578,8 @@ void Widget::setTouchEnabled(bool enable)
         _touchListener->onTouchMoved = CC_CALLBACK_2(Widget::onTouchMoved, this);
         _touchListener->onTouchEnded = CC_CALLBACK_2(Widget::onTouchEnded, this);
         _touchListener->onTouchCancelled = CC_CALLBACK_2(Widget::onTouchCancelled, this);
+        // onTouchBegan rejects the touches missing hitTest anyway
+        _touchListener->setHitAreaCulling(isHitAreaInsideContentSize());
         _eventDispatcher->addEventListenerWithSceneGraphPriority(_touchListener, this);
     }
     else
@@ -448,6 +448,15 @@ public:
      */
     virtual bool hitTest(const Vec2 &pt, const Camera* camera, Vec3 *p) const;
 
+    /**
+     * Checks whether hitTest only accepts points inside the content rect of the widget.
+     * The event dispatcher then skips the widget for touches outside its bounds, see `EventListenerTouchOneByOne::setHitAreaCulling`.
+     * Widgets overriding hitTest with a larger touch area, or handling touches that miss it, must return false.
+     *
+     * @return True by default.
+     */
+    virtual bool isHitAreaInsideContentSize() const { return true; }
+
     /**
      * A callback which will be called when touch began event is issued.
      *@param touch The touch info.
@@ -0,0 +1,188 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Pack a resource directory into an archive for FileUtils::mountArchive.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Pack a resource directory into an archive for FileUtils::mountArchive.
+
+The format is described in cocos/platform/CCFileArchive.h.
+'''
+
+import os
+import struct
+import zlib
+
+from argparse import ArgumentParser
+
+MAGIC = b'CCPK'
+VERSION = 1
+
+HEADER_FORMAT = '<4sIIIQQQ'
+ENTRY_FORMAT = '<QQQQIHBB'
+
+COMPRESSION_STORE = 0
+COMPRESSION_DEFLATE = 1
+
+# already compressed, deflating them again only costs load time
+STORED_EXTENSIONS = ['.png', '.jpg', '.jpeg', '.webp', '.ccz', '.gz', '.zip']
+
+# left out: the AudioEngine decoders open the full path themselves, they can't read from an archive
+AUDIO_EXTENSIONS = ['.ogg', '.mp3', '.m4a', '.wav', '.caf', '.aac']
+
+# uploaded as is, aligned so they can be read in place from the mapped archive
+GPU_EXTENSIONS = ['.pvr', '.ktx', '.pkm', '.astc', '.dds']
+
+GPU_ALIGNMENT_LOG2 = 6
+DEFAULT_ALIGNMENT_LOG2 = 4
+
+MAX_BUCKET_BITS = 24
+
+class KnownException(Exception):
+    pass
+
+def hash_name(name):
+    # 64 bit FNV-1a, see FileArchive::hashName
+    h = 14695981039346656037
+    for c in bytearray(name):
+        h ^= c
+        h = (h * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+def align(value, alignment_log2):
+    mask = (1 << alignment_log2) - 1
+    return (value + mask) & ~mask
+
+def bucket_bits_for(count):
+    # about two entries per bucket
+    bits = 0
+    while (1 << bits) * 2 < count and bits < MAX_BUCKET_BITS:
+        bits += 1
+    return bits
+
+class AssetPacker(object):
+
+    def __init__(self, src_dir, dst_file, min_ratio, verbose):
+        self.src_dir = os.path.abspath(src_dir)
+        self.dst_file = os.path.abspath(dst_file)
+        self.min_ratio = min_ratio
+        self.verbose = verbose
+
+        if not os.path.isdir(self.src_dir):
+            raise KnownException('%s is not a directory' % src_dir)
+
+    def collect_files(self):
+        files = []
+        skipped = 0
+        for root, dirs, names in os.walk(self.src_dir):
+            dirs.sort()
+            for name in sorted(names):
+                path = os.path.join(root, name)
+                if os.path.abspath(path) == self.dst_file:
+                    continue
+                rel = os.path.relpath(path, self.src_dir).replace(os.sep, '/')
+                if os.path.splitext(rel)[1].lower() in AUDIO_EXTENSIONS:
+                    skipped += 1
+                    if self.verbose:
+                        print('%s: skipped, audio files must stay on disk' % rel)
+                    continue
+                files.append((rel, path))
+        if skipped > 0:
+            print('Skipped %d audio files, ship them as loose files' % skipped)
+        return files
+
+    def encode(self, rel, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+
+        ext = os.path.splitext(rel)[1].lower()
+        alignment_log2 = GPU_ALIGNMENT_LOG2 if ext in GPU_EXTENSIONS else DEFAULT_ALIGNMENT_LOG2
+        if ext in STORED_EXTENSIONS or ext in GPU_EXTENSIONS or len(data) == 0:
+            return data, data, COMPRESSION_STORE, alignment_log2
+
+        compressed = zlib.compress(data, 9)
+        if len(compressed) <= len(data) * (1.0 - self.min_ratio):
+            return data, compressed, COMPRESSION_DEFLATE, alignment_log2
+        return data, data, COMPRESSION_STORE, alignment_log2
+
+    def run(self):
+        files = self.collect_files()
+        bucket_bits = bucket_bits_for(len(files))
+
+        entries = []
+        names = b''
+        for rel, path in files:
+            name = rel.encode('utf-8')
+            if len(name) > 0xFFFF:
+                raise KnownException('%s: name too long' % rel)
+            data, stored, compression, alignment_log2 = self.encode(rel, path)
+            entries.append({
+                'hash': hash_name(name),
+                'name': name,
+                'name_offset': len(names),
+                'size': len(data),
+                'stored': stored,
+                'compression': compression,
+                'alignment_log2': alignment_log2
+            })
+            names += name
+
+        entries.sort(key=lambda e: (e['hash'], e['name']))
+        for i in range(1, len(entries)):
+            if entries[i]['hash'] == entries[i - 1]['hash'] and entries[i]['name'] == entries[i - 1]['name']:
+                raise KnownException('duplicated entry %s' % entries[i]['name'])
+
+        bucket_count = 1 << bucket_bits
+        buckets = [0] * (bucket_count + 1)
+        for e in entries:
+            buckets[(e['hash'] >> (64 - bucket_bits)) + 1 if bucket_bits > 0 else 1] += 1
+        for b in range(bucket_count):
+            buckets[b + 1] += buckets[b]
+
+        header_size = struct.calcsize(HEADER_FORMAT)
+        buckets_offset = header_size
+        entries_offset = align(buckets_offset + len(buckets) * 4, 3)
+        names_offset = entries_offset + len(entries) * struct.calcsize(ENTRY_FORMAT)
+
+        offset = names_offset + len(names)
+        for e in entries:
+            offset = align(offset, e['alignment_log2'])
+            e['offset'] = offset
+            offset += len(e['stored'])
+
+        with open(self.dst_file, 'wb') as f:
+            f.write(struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(entries), bucket_bits,
+                                buckets_offset, entries_offset, names_offset))
+            f.write(struct.pack('<%dI' % len(buckets), *buckets))
+            f.write(b'\0' * (entries_offset - f.tell()))
+            for e in entries:
+                f.write(struct.pack(ENTRY_FORMAT, e['hash'], e['offset'], len(e['stored']), e['size'],
+                                    e['name_offset'], len(e['name']), e['compression'], e['alignment_log2']))
+            f.write(names)
+            for e in entries:
+                f.write(b'\0' * (e['offset'] - f.tell()))
+                f.write(e['stored'])
+                if self.verbose:
+                    print('%s: %d -> %d bytes%s' % (e['name'].decode('utf-8'), e['size'], len(e['stored']),
+                          ' (deflate)' if e['compression'] == COMPRESSION_DEFLATE else ''))
+
+        print('Packed %d files into %s (%d bytes)' % (len(entries), self.dst_file, offset))
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Pack a resource directory into an archive for FileUtils::mountArchive.")
+    parser.add_argument('-s', '--src', dest='src_dir', required=True, help='The resource directory to pack.')
+    parser.add_argument('-o', '--output', dest='dst_file', required=True, help='The archive to write.')
+    parser.add_argument('-r', '--min-ratio', dest='min_ratio', type=float, default=0.1,
+                        help='Deflate a file only if it saves at least this ratio of its size. Default is 0.1.')
+    parser.add_argument('-v', '--verbose', dest='verbose', action='store_true', help='Print every packed file.')
+
+    (args, unknown) = parser.parse_known_args()
+
+    try:
+        packer = AssetPacker(args.src_dir, args.dst_file, args.min_ratio, args.verbose)
+        packer.run()
+    except KnownException as e:
+        print(e)
+        exit(1)
@@ -0,0 +1,188 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Convert sprite sheet .plist files to the binary .ccss format of SpriteFrameCache.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Convert sprite sheet .plist files to the binary .ccss format of SpriteFrameCache.
+
+The frames are normalized the way SpriteFrameCache reads the plist formats 0 to 3,
+written as JSON and compiled with flatc against cocos/2d/fbs-files/SpriteSheetBinary.fbs.
+'''
+
+import os
+import re
+import json
+import shutil
+import plistlib
+import subprocess
+import tempfile
+
+from argparse import ArgumentParser
+
+SCHEMA_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           '..', '..', 'cocos', '2d', 'fbs-files', 'SpriteSheetBinary.fbs')
+
+NUMBER_RE = re.compile(r'[-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?')
+
+class KnownException(Exception):
+    pass
+
+def parse_numbers(text, count):
+    # "{{x,y},{w,h}}", "{x,y}" or "{w,h}" like RectFromString / PointFromString / SizeFromString
+    numbers = [float(n) for n in NUMBER_RE.findall(text or '')]
+    if len(numbers) != count:
+        return [0.0] * count
+    return numbers
+
+def parse_integers(text):
+    # like utils::parseIntegerList
+    return [int(float(n)) for n in NUMBER_RE.findall(text or '')]
+
+def vec2(values):
+    return { 'x': values[0], 'y': values[1] }
+
+def size(values):
+    return { 'width': values[0], 'height': values[1] }
+
+def rect(values):
+    return { 'x': values[0], 'y': values[1], 'width': values[2], 'height': values[3] }
+
+def load_plist(path):
+    with open(path, 'rb') as f:
+        if hasattr(plistlib, 'load'):
+            return plistlib.load(f)
+        return plistlib.readPlist(f)
+
+class SpriteSheetConverter(object):
+
+    def __init__(self, flatc, schema, verbose):
+        self.flatc = flatc
+        self.schema = os.path.abspath(schema)
+        self.verbose = verbose
+
+        if not os.path.isfile(self.schema):
+            raise KnownException('schema %s not found' % schema)
+
+    def convert_frame(self, name, frame, fmt):
+        data = { 'name': name }
+
+        if fmt == 0:
+            data['rect'] = rect([float(frame.get('x', 0)), float(frame.get('y', 0)),
+                                 float(frame.get('width', 0)), float(frame.get('height', 0))])
+            data['offset'] = vec2([float(frame.get('offsetX', 0)), float(frame.get('offsetY', 0))])
+            data['sourceSize'] = size([abs(int(frame.get('originalWidth', 0))), abs(int(frame.get('originalHeight', 0)))])
+        elif fmt == 1 or fmt == 2:
+            data['rect'] = rect(parse_numbers(frame.get('frame'), 4))
+            data['rotated'] = fmt == 2 and bool(frame.get('rotated', False))
+            data['offset'] = vec2(parse_numbers(frame.get('offset'), 2))
+            data['sourceSize'] = size(parse_numbers(frame.get('sourceSize'), 2))
+        else:
+            sprite_size = parse_numbers(frame.get('spriteSize'), 2)
+            texture_rect = parse_numbers(frame.get('textureRect'), 4)
+            data['rect'] = rect([texture_rect[0], texture_rect[1], sprite_size[0], sprite_size[1]])
+            data['rotated'] = bool(frame.get('textureRotated', False))
+            data['offset'] = vec2(parse_numbers(frame.get('spriteOffset'), 2))
+            data['sourceSize'] = size(parse_numbers(frame.get('spriteSourceSize'), 2))
+
+            aliases = frame.get('aliases', [])
+            if aliases:
+                data['aliases'] = [str(alias) for alias in aliases]
+            if 'vertices' in frame:
+                data['vertices'] = parse_integers(frame.get('vertices'))
+                data['verticesUV'] = parse_integers(frame.get('verticesUV'))
+                data['triangles'] = parse_integers(frame.get('triangles'))
+            if 'anchor' in frame:
+                data['anchor'] = vec2(parse_numbers(frame.get('anchor'), 2))
+
+        return data
+
+    def convert_dict(self, plist):
+        frames = plist.get('frames')
+        if not isinstance(frames, dict):
+            raise KnownException('no frames dictionary')
+
+        metadata = plist.get('metadata', {})
+        fmt = int(metadata.get('format', 0))
+        if fmt < 0 or fmt > 3:
+            raise KnownException('format %d is not supported' % fmt)
+
+        sheet = { 'version': 1 }
+        if metadata.get('textureFileName'):
+            sheet['textureFileName'] = metadata['textureFileName']
+        if metadata.get('size'):
+            sheet['textureSize'] = size(parse_numbers(metadata['size'], 2))
+        if metadata.get('pixelFormat'):
+            sheet['pixelFormat'] = metadata['pixelFormat']
+
+        sheet['frames'] = [self.convert_frame(name, frames[name], fmt) for name in sorted(frames.keys())]
+        return sheet
+
+    def convert(self, src, dst):
+        sheet = self.convert_dict(load_plist(src))
+
+        tmp_dir = tempfile.mkdtemp()
+        try:
+            base_name = os.path.splitext(os.path.basename(dst))[0]
+            json_path = os.path.join(tmp_dir, base_name + '.json')
+            with open(json_path, 'w') as f:
+                json.dump(sheet, f)
+
+            subprocess.check_call([self.flatc, '-b', '-o', tmp_dir, self.schema, json_path])
+
+            dst_dir = os.path.dirname(os.path.abspath(dst))
+            if not os.path.isdir(dst_dir):
+                os.makedirs(dst_dir)
+            shutil.copyfile(os.path.join(tmp_dir, base_name + '.ccss'), dst)
+        except (OSError, subprocess.CalledProcessError) as e:
+            raise KnownException('%s: flatc failed: %s' % (src, e))
+        finally:
+            shutil.rmtree(tmp_dir)
+
+        if self.verbose:
+            print('%s -> %s (%d frames)' % (src, dst, len(sheet['frames'])))
+
+    def run(self, sources, output_dir):
+        converted = 0
+        for src in sources:
+            if os.path.isdir(src):
+                for root, dirs, names in os.walk(src):
+                    for name in sorted(names):
+                        if name.endswith('.plist'):
+                            path = os.path.join(root, name)
+                            rel = os.path.relpath(path, src)
+                            dst_root = os.path.join(output_dir, rel) if output_dir else path
+                            converted += self.convert_file(path, os.path.splitext(dst_root)[0] + '.ccss')
+            else:
+                dst = os.path.join(output_dir, os.path.basename(src)) if output_dir else src
+                converted += self.convert_file(src, os.path.splitext(dst)[0] + '.ccss')
+        print('Converted %d sprite sheets' % converted)
+
+    def convert_file(self, src, dst):
+        plist = load_plist(src)
+        if not isinstance(plist, dict) or 'frames' not in plist:
+            # not a sprite sheet, e.g. a particle or animation plist
+            if self.verbose:
+                print('skip %s' % src)
+            return 0
+        self.convert(src, dst)
+        return 1
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Convert sprite sheet .plist files to the binary .ccss format of SpriteFrameCache.")
+    parser.add_argument('sources', nargs='+', help='.plist files, or directories searched for .plist files.')
+    parser.add_argument('-o', '--output', dest='output_dir', help='Directory of the .ccss files. Default is next to the .plist files.')
+    parser.add_argument('--flatc', dest='flatc', default='flatc', help='The flatc executable, built from external/flatbuffers. Default is flatc in PATH.')
+    parser.add_argument('--schema', dest='schema', default=SCHEMA_PATH, help='The SpriteSheetBinary.fbs schema.')
+    parser.add_argument('-v', '--verbose', dest='verbose', action='store_true', help='Print every converted file.')
+
+    (args, unknown) = parser.parse_known_args()
+
+    try:
+        converter = SpriteSheetConverter(args.flatc, args.schema, args.verbose)
+        converter.run(args.sources, args.output_dir)
+    except KnownException as e:
+        print(e)
+        exit(1)
@@ -137,6 +137,7 @@ static AppDelegate s_sharedApplication;
     /*
      Free up as much memory as possible by purging cached data objects that can be recreated (or reloaded from disk) later.
      */
+    cocos2d::Director::getInstance()->purgeCachedData();
 }
 
 